@@ -0,0 +1,84 @@
+/**
+ * @file boot_profile.h
+ * @brief Boot stage timestamps for /api/boot-profile
+ *
+ * setup() and the LVGL task mark each boot stage with esp_timer_get_time()
+ * (microseconds since the timer started, shortly after reset). The two
+ * numbers that matter are time-to-first-frame and time-to-ready.
+ *
+ * Usage:
+ *   bootMark("display");           // Stage finished now
+ *   bootProfileAddJson(doc.to<JsonObject>());
+ */
+
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <esp_timer.h>
+
+// ============================================================
+// Configuration
+// ============================================================
+#define BOOT_PROFILE_MAX_STAGES   16
+
+// Well-known stages reported as top-level fields
+#define BOOT_STAGE_FIRST_FRAME    "first_frame"
+#define BOOT_STAGE_READY          "ready"
+
+// ============================================================
+// Profile State
+// ============================================================
+struct BootStage {
+  const char* name;   // String literal
+  int64_t us;         // esp_timer_get_time() at the end of the stage
+};
+
+static BootStage bootStages[BOOT_PROFILE_MAX_STAGES];
+static uint8_t bootStageCount = 0;
+static portMUX_TYPE bootProfileMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Record the end of a boot stage - safe from any task, name must be a literal
+void bootMark(const char* name) {
+  int64_t now = esp_timer_get_time();
+
+  portENTER_CRITICAL(&bootProfileMux);
+  if (bootStageCount < BOOT_PROFILE_MAX_STAGES) {
+    bootStages[bootStageCount].name = name;
+    bootStages[bootStageCount].us = now;
+    bootStageCount++;
+  }
+  portEXIT_CRITICAL(&bootProfileMux);
+
+  Serial.printf("[BOOT] %-16s %7lu ms\n", name, (unsigned long)(now / 1000));
+}
+
+// ============================================================
+// Profile JSON
+// ============================================================
+void bootProfileAddJson(JsonObject obj) {
+  BootStage stages[BOOT_PROFILE_MAX_STAGES];
+  portENTER_CRITICAL(&bootProfileMux);
+  uint8_t count = bootStageCount;
+  memcpy(stages, bootStages, sizeof(BootStage) * count);
+  portEXIT_CRITICAL(&bootProfileMux);
+
+  JsonArray arr = obj["stages"].to<JsonArray>();
+  int64_t previous = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    JsonObject s = arr.add<JsonObject>();
+    s["name"] = stages[i].name;
+    s["us"] = stages[i].us;
+    s["delta_us"] = stages[i].us - previous;
+    previous = stages[i].us;
+
+    if (strcmp(stages[i].name, BOOT_STAGE_FIRST_FRAME) == 0) {
+      obj["first_frame_ms"] = (uint32_t)(stages[i].us / 1000);
+    } else if (strcmp(stages[i].name, BOOT_STAGE_READY) == 0) {
+      obj["ready_ms"] = (uint32_t)(stages[i].us / 1000);
+    }
+  }
+}
+
+#endif // BOOT_PROFILE_H
@@ -0,0 +1,195 @@
+/**
+ * @file button_task.h
+ * @brief Interrupt-driven BOOT and factory-reset buttons
+ *
+ * Each configured button pin has a GPIO interrupt on both edges. The ISR
+ * only re-arms a one-shot esp_timer; once the level has been stable for
+ * the debounce time the timer callback reads it and queues a press or
+ * release event. A debounced press also arms a long-press timer that
+ * queues HOLD events after 5 s and 10 s. The button task blocks on the
+ * event queue and calls onButtonEvent() (main.cpp), so nothing runs
+ * while the buttons are idle and latency does not depend on loop().
+ */
+
+#ifndef BUTTON_TASK_H
+#define BUTTON_TASK_H
+
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "config.h"
+#include "board_config.h"
+
+// ============================================================
+// Configuration
+// ============================================================
+#define BUTTON_HOLD_WARN_MS     5000   // Factory reset: start warning
+#define BUTTON_HOLD_LONG_MS     10000  // Factory reset: execute
+#define BUTTON_QUEUE_LENGTH     8
+#define BUTTON_TASK_STACK       4096
+#define BUTTON_TASK_PRIORITY    3      // Above LVGL - handlers only enqueue work
+#define BUTTON_TASK_CORE        1
+
+// ============================================================
+// Events
+// ============================================================
+enum ButtonId : uint8_t {
+  BUTTON_BOOT,            // BUTTON_PIN - toggles feeding mode
+  BUTTON_FACTORY_RESET,   // FACTORY_RESET_PIN - long press resets
+  BUTTON_COUNT
+};
+
+enum ButtonEventType : uint8_t {
+  BUTTON_EVT_PRESS,
+  BUTTON_EVT_RELEASE,     // heldMs = debounced press duration
+  BUTTON_EVT_HOLD_WARN,   // Still held after BUTTON_HOLD_WARN_MS
+  BUTTON_EVT_HOLD_LONG    // Still held after BUTTON_HOLD_LONG_MS
+};
+
+struct ButtonEvent {
+  ButtonId button;
+  ButtonEventType type;
+  uint32_t heldMs;
+};
+
+// Defined in main.cpp - runs on the button task
+void onButtonEvent(const ButtonEvent& evt);
+
+// ============================================================
+// Button State
+// ============================================================
+struct ButtonState {
+  ButtonId id;
+  int8_t pin;
+  bool pressed;                     // Debounced level (active LOW)
+  uint8_t holdStage;                // HOLD events sent for this press
+  int64_t pressedAt;                // esp_timer_get_time() of the press
+  esp_timer_handle_t debounceTimer;
+  esp_timer_handle_t holdTimer;
+};
+
+static DRAM_ATTR ButtonState buttons[BUTTON_COUNT];
+static QueueHandle_t buttonQueue = NULL;
+static TaskHandle_t buttonTaskHandle = NULL;
+
+// ============================================================
+// ISR and Timer Callbacks
+// ============================================================
+// Every edge restarts the debounce window - bounces never reach the queue
+static void IRAM_ATTR buttonIsr(void* arg) {
+  ButtonState* b = (ButtonState*)arg;
+  esp_timer_stop(b->debounceTimer);
+  esp_timer_start_once(b->debounceTimer, debounceDelay * 1000ULL);
+}
+
+static void buttonPost(ButtonState* b, ButtonEventType type, uint32_t heldMs) {
+  ButtonEvent evt = { b->id, type, heldMs };
+  if (xQueueSend(buttonQueue, &evt, 0) != pdTRUE) {
+    Serial.println("⚠ Button event queue full - event dropped");
+  }
+}
+
+// esp_timer task: level has been stable for debounceDelay
+static void buttonDebounceCb(void* arg) {
+  ButtonState* b = (ButtonState*)arg;
+  bool pressed = digitalRead(b->pin) == LOW;
+  if (pressed == b->pressed) return;  // Bounced back to the previous level
+  b->pressed = pressed;
+
+  int64_t now = esp_timer_get_time();
+  if (pressed) {
+    b->pressedAt = now;
+    b->holdStage = 0;
+    esp_timer_start_once(b->holdTimer, BUTTON_HOLD_WARN_MS * 1000ULL);
+    buttonPost(b, BUTTON_EVT_PRESS, 0);
+  } else {
+    esp_timer_stop(b->holdTimer);
+    buttonPost(b, BUTTON_EVT_RELEASE, (uint32_t)((now - b->pressedAt) / 1000));
+  }
+}
+
+// esp_timer task: long-press thresholds
+static void buttonHoldCb(void* arg) {
+  ButtonState* b = (ButtonState*)arg;
+  if (!b->pressed) return;
+
+  uint32_t heldMs = (uint32_t)((esp_timer_get_time() - b->pressedAt) / 1000);
+  if (b->holdStage == 0) {
+    b->holdStage = 1;
+    esp_timer_start_once(b->holdTimer, (BUTTON_HOLD_LONG_MS - BUTTON_HOLD_WARN_MS) * 1000ULL);
+    buttonPost(b, BUTTON_EVT_HOLD_WARN, heldMs);
+  } else if (b->holdStage == 1) {
+    b->holdStage = 2;
+    buttonPost(b, BUTTON_EVT_HOLD_LONG, heldMs);
+  }
+}
+
+// ============================================================
+// Button Task
+// ============================================================
+static void buttonTask(void* param) {
+  ButtonEvent evt;
+  while (true) {
+    if (xQueueReceive(buttonQueue, &evt, portMAX_DELAY) == pdTRUE) {
+      onButtonEvent(evt);
+    }
+  }
+}
+
+static bool buttonInit(ButtonState& b, ButtonId id, int8_t pin) {
+  b.id = id;
+  b.pin = pin;
+  b.pressed = false;
+  b.holdStage = 0;
+  b.pressedAt = 0;
+  b.debounceTimer = NULL;
+  b.holdTimer = NULL;
+  if (pin < 0) return false;
+
+  esp_timer_create_args_t args = {};
+  args.arg = &b;
+  args.callback = buttonDebounceCb;
+  args.name = "button_debounce";
+  if (esp_timer_create(&args, &b.debounceTimer) != ESP_OK) return false;
+  args.callback = buttonHoldCb;
+  args.name = "button_hold";
+  if (esp_timer_create(&args, &b.holdTimer) != ESP_OK) return false;
+
+  pinMode(pin, INPUT_PULLUP);
+  attachInterruptArg(pin, buttonIsr, &b, CHANGE);
+
+  // Already held at boot - let the debounce pass report it
+  if (digitalRead(pin) == LOW) {
+    esp_timer_start_once(b.debounceTimer, debounceDelay * 1000ULL);
+  }
+  return true;
+}
+
+// Configure button interrupts and start the button task (call once in setup)
+void buttonTaskBegin() {
+  if (BUTTON_PIN < 0 && FACTORY_RESET_PIN < 0) return;  // Touch UI only
+  if (buttonQueue) return;
+
+  buttonQueue = xQueueCreate(BUTTON_QUEUE_LENGTH, sizeof(ButtonEvent));
+
+  xTaskCreatePinnedToCore(
+    buttonTask,             // Task function
+    "buttons",              // Name
+    BUTTON_TASK_STACK,      // Stack size
+    NULL,                   // Parameters
+    BUTTON_TASK_PRIORITY,   // Priority
+    &buttonTaskHandle,      // Task handle
+    BUTTON_TASK_CORE        // Core
+  );
+
+  // Task first - a button held at boot queues an event right away
+  bool boot = buttonInit(buttons[BUTTON_BOOT], BUTTON_BOOT, BUTTON_PIN);
+  bool reset = buttonInit(buttons[BUTTON_FACTORY_RESET], BUTTON_FACTORY_RESET, FACTORY_RESET_PIN);
+  Serial.printf("✓ Button interrupts armed (boot: %s, factory reset: %s)\n",
+                boot ? "yes" : "no", reset ? "yes" : "no");
+}
+
+#endif // BUTTON_TASK_H
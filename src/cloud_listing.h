@@ -0,0 +1,48 @@
+/**
+ * @file cloud_listing.h
+ * @brief ArduinoJson filters for the Red Sea and Tunze device listings
+ *
+ * The cloud listings are parsed straight from the TLS stream and only the
+ * fields shown in the settings UI are kept. The filters live here, apart
+ * from the HTTP code, so the host benchmark (test/test_listing_bench)
+ * measures exactly what the firmware parses.
+ */
+
+#ifndef CLOUD_LISTING_H
+#define CLOUD_LISTING_H
+
+#include <ArduinoJson.h>
+
+// GET /aquarium - fields emitted by redseaGetAquariums()
+void redseaAquariumFilter(JsonDocument& filter) {
+  JsonObject f = filter[0].to<JsonObject>();
+  f["uid"] = true;
+  f["id"] = true;
+  f["name"] = true;
+  f["measuring_unit"] = true;
+  f["water_volume"] = true;
+  f["net_water_volume"] = true;
+  f["online"] = true;
+  f["timezone_offset"] = true;
+  f["system_series"] = true;
+  f["serial_number"] = true;
+  f["system_model"] = true;
+  f["system_type"] = true;
+}
+
+// POST /action/getDevices - fields emitted by tunzeGetDevices()
+void tunzeDeviceFilter(JsonDocument& filter) {
+  JsonObject gw = filter["gateways"][0].to<JsonObject>();
+  gw["imei"] = true;
+  gw["name"] = true;
+  gw["type"] = true;
+  gw["firmware"]["version"] = true;
+  gw["sn"] = true;
+  JsonObject ep = filter["endpoints"][0].to<JsonObject>();
+  ep["imei"] = true;
+  ep["name"] = true;
+  ep["type"] = true;
+  ep["slot"] = true;
+}
+
+#endif // CLOUD_LISTING_H
@@ -24,6 +24,7 @@
 
 // Red Sea Cloud API Configuration
 const char* redsea_API_BASE = "https://cloud.reef-beat.com";
+const char* redsea_API_HOST = "cloud.reef-beat.com";
 const char* redsea_CLIENT_AUTH = "Basic Z0ZqSHRKcGE6Qzlmb2d3cmpEV09SVDJHWQ==";
 
 // Tunze Hub Configuration
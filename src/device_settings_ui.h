@@ -34,8 +34,8 @@ extern bool ENABLE_TUNZE;
 extern void saveCredentials();
 
 // API functions from redsea_api.h and tunze_api.h
-extern String redseaGetAquariums();
-extern String tunzeGetDevices();
+extern bool redseaGetAquariums(JsonDocument& result);
+extern bool tunzeGetDevices(JsonDocument& result);
 
 // Tasmota functions
 bool tasmotaIsEnabled();
@@ -106,7 +106,8 @@ static bool ds_loading = false;
 lv_obj_t* getMainScreen();
 void ds_show_service_settings(int service);  // Public function
 static void ds_save_current_settings();
-static void ds_load_devices_task(lv_timer_t *timer);
+void ds_on_devices_loaded();
+void ds_on_tasmota_scan();
 
 // ============================================================
 // Keyboard Event Handler
@@ -321,78 +322,96 @@ static void ds_dropdown_cb(lv_event_t *e) {
 }
 
 // ============================================================
-// Load Devices (Async Task)
+// Load Devices (Worker Task)
 // ============================================================
-static void ds_load_devices_task(lv_timer_t *timer) {
-  int service = (int)(intptr_t)timer->user_data;
-  
-  Serial.printf("Loading devices for service %d...\n", service);
-  
-  String result;
-  if (service == 0) {
-    // Update username, only update password if user entered a new one
-    if (ds_username_ta) redsea_USERNAME = String(lv_textarea_get_text(ds_username_ta));
-    if (ds_password_ta) {
-      String newPass = String(lv_textarea_get_text(ds_password_ta));
-      if (newPass.length() > 0) redsea_PASSWORD = newPass;
-    }
-    result = redseaGetAquariums();
-  } else {
-    if (ds_username_ta) TUNZE_USERNAME = String(lv_textarea_get_text(ds_username_ta));
-    if (ds_password_ta) {
-      String newPass = String(lv_textarea_get_text(ds_password_ta));
-      if (newPass.length() > 0) TUNZE_PASSWORD = newPass;
-    }
-    result = tunzeGetDevices();
+// The cloud login and listing take seconds, so they run on a worker on
+// the network core. The result is handed over to the LVGL task, which
+// picks it up on UI_MSG_DEVICES_LOADED.
+#define DS_WORKER_STACK     8192
+#define DS_WORKER_PRIORITY  1
+#define DS_WORKER_CORE      0       // Network core - LVGL runs on core 1
+#define DS_POST_RETRIES     50      // uiPost() attempts (20 ms apart) for a final result
+
+struct DsDeviceList {
+  int service;
+  bool ok;
+  int count;
+  String ids[DS_MAX_DEVICES];
+  String names[DS_MAX_DEVICES];
+};
+
+static DsDeviceList *ds_loaded = NULL;  // Worker -> LVGL task
+static portMUX_TYPE ds_handover_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Post a message the UI must not miss (queue full = retry)
+static void ds_post_final(UiMessage msg) {
+  for (int i = 0; i < DS_POST_RETRIES && !uiPost(msg); i++) {
+    vTaskDelay(pdMS_TO_TICKS(20));
   }
+}
+
+static void ds_load_devices_worker(void *param) {
+  DsDeviceList *list = new DsDeviceList();
+  list->service = (int)(intptr_t)param;
+  list->count = 0;
   
-  Serial.println("API Result: " + result.substring(0, 200));
+  Serial.printf("Loading devices for service %d...\n", list->service);
   
-  // Parse result
   JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, result);
+  list->ok = list->service == 0 ? redseaGetAquariums(doc) : tunzeGetDevices(doc);
   
-  ds_device_count = 0;
-  String dropdown_options = "-- Auswaehlen --\n";
-  
-  if (!error && doc["success"].as<bool>()) {
-    JsonArray items;
-    if (service == 0) {
-      items = doc["aquariums"].as<JsonArray>();
-    } else {
-      items = doc["devices"].as<JsonArray>();
-    }
-    
+  if (list->ok) {
+    JsonArray items = doc[list->service == 0 ? "aquariums" : "devices"].as<JsonArray>();
     for (JsonObject item : items) {
-      if (ds_device_count >= DS_MAX_DEVICES) break;
-      
-      if (service == 0) {
-        ds_device_ids[ds_device_count] = item["id"].as<String>();
-        ds_device_names[ds_device_count] = item["name"].as<String>();
-      } else {
-        ds_device_ids[ds_device_count] = item["imei"].as<String>();
-        ds_device_names[ds_device_count] = item["name"].as<String>();
-      }
-      
-      dropdown_options += ds_device_names[ds_device_count];
-      ds_device_count++;
-      
-      if (ds_device_count < DS_MAX_DEVICES) {
-        dropdown_options += "\n";
-      }
+      if (list->count >= DS_MAX_DEVICES) break;
+      list->ids[list->count] = item[list->service == 0 ? "id" : "imei"].as<String>();
+      list->names[list->count] = item["name"].as<String>();
+      list->count++;
     }
-    
-    Serial.printf("Found %d devices\n", ds_device_count);
+    Serial.printf("Found %d devices\n", list->count);
   } else {
     Serial.println("Failed to parse API result or login failed");
   }
   
+  portENTER_CRITICAL(&ds_handover_mux);
+  DsDeviceList *stale = ds_loaded;
+  ds_loaded = list;
+  portEXIT_CRITICAL(&ds_handover_mux);
+  delete stale;
+  
+  ds_post_final(UI_MSG_DEVICES_LOADED);
+  vTaskDelete(NULL);
+}
+
+// UI_MSG_DEVICES_LOADED - LVGL task only
+void ds_on_devices_loaded() {
+  portENTER_CRITICAL(&ds_handover_mux);
+  DsDeviceList *list = ds_loaded;
+  ds_loaded = NULL;
+  portEXIT_CRITICAL(&ds_handover_mux);
+  if (!list) return;
+  
+  ds_loading = false;
+  if (list->service != ds_current_service) {
+    delete list;  // Tab changed while loading
+    return;
+  }
+  
+  ds_device_count = list->count;
+  String dropdown_options = "-- Auswaehlen --\n";
+  for (int i = 0; i < list->count; i++) {
+    ds_device_ids[i] = list->ids[i];
+    ds_device_names[i] = list->names[i];
+    dropdown_options += ds_device_names[i];
+    if (i < DS_MAX_DEVICES - 1 && i < list->count - 1) dropdown_options += "\n";
+  }
+  
   // Update UI (must be done carefully - widgets might be deleted)
   if (ds_device_dropdown != NULL && lv_obj_is_valid(ds_device_dropdown)) {
     lv_dropdown_set_options(ds_device_dropdown, dropdown_options.c_str());
     
     // Select current device if exists
-    String currentId = (service == 0) ? redsea_AQUARIUM_ID : TUNZE_DEVICE_ID;
+    String currentId = (list->service == 0) ? redsea_AQUARIUM_ID : TUNZE_DEVICE_ID;
     for (int i = 0; i < ds_device_count; i++) {
       if (ds_device_ids[i] == currentId) {
         lv_dropdown_set_selected(ds_device_dropdown, i + 1);
@@ -408,23 +427,19 @@ static void ds_load_devices_task(lv_timer_t *timer) {
   if (ds_load_btn != NULL && lv_obj_is_valid(ds_load_btn)) {
     lv_obj_clear_flag(ds_load_btn, LV_OBJ_FLAG_HIDDEN);
     
-    if (ds_device_count > 0) {
-      lv_obj_t *btn_lbl = lv_obj_get_child(ds_load_btn, 0);
-      if (btn_lbl) {
+    lv_obj_t *btn_lbl = lv_obj_get_child(ds_load_btn, 0);
+    if (btn_lbl) {
+      if (ds_device_count > 0) {
         char txt[32];
         snprintf(txt, sizeof(txt), LV_SYMBOL_OK " %d gefunden", ds_device_count);
         lv_label_set_text(btn_lbl, txt);
-      }
-    } else {
-      lv_obj_t *btn_lbl = lv_obj_get_child(ds_load_btn, 0);
-      if (btn_lbl) {
+      } else {
         lv_label_set_text(btn_lbl, LV_SYMBOL_CLOSE " Fehler");
       }
     }
   }
   
-  ds_loading = false;
-  lv_timer_del(timer);
+  delete list;
 }
 
 // ============================================================
@@ -432,6 +447,30 @@ static void ds_load_devices_task(lv_timer_t *timer) {
 // ============================================================
 static void ds_load_btn_cb(lv_event_t *e) {
   if (ds_loading) return;
+  
+  // Credentials from the text fields - read here, LVGL is not thread-safe
+  if (ds_current_service == 0) {
+    // Update username, only update password if user entered a new one
+    if (ds_username_ta) redsea_USERNAME = String(lv_textarea_get_text(ds_username_ta));
+    if (ds_password_ta) {
+      String newPass = String(lv_textarea_get_text(ds_password_ta));
+      if (newPass.length() > 0) redsea_PASSWORD = newPass;
+    }
+  } else {
+    if (ds_username_ta) TUNZE_USERNAME = String(lv_textarea_get_text(ds_username_ta));
+    if (ds_password_ta) {
+      String newPass = String(lv_textarea_get_text(ds_password_ta));
+      if (newPass.length() > 0) TUNZE_PASSWORD = newPass;
+    }
+  }
+  
+  BaseType_t created = xTaskCreatePinnedToCore(ds_load_devices_worker, "ds_load", DS_WORKER_STACK,
+                                               (void*)(intptr_t)ds_current_service,
+                                               DS_WORKER_PRIORITY, NULL, DS_WORKER_CORE);
+  if (created != pdPASS) {
+    Serial.println("✗ Failed to start device loading task");
+    return;
+  }
   ds_loading = true;
   
   // Show spinner, hide button text
@@ -441,9 +480,184 @@ static void ds_load_btn_cb(lv_event_t *e) {
       lv_label_set_text(btn_lbl, "Laden...");
     }
   }
+}
+
+// ============================================================
+// Tasmota Scan (Worker Task)
+// ============================================================
+// The scan itself runs in tasmota_api.h; this worker starts it, polls
+// the results and hands snapshots to the LVGL task (UI_MSG_TASMOTA_SCAN)
+// so the JSON work stays off the UI.
+#define DS_SCAN_POLL_MS     500
+#define DS_SCAN_MAX_SHOWN   32
+
+struct DsScanState {
+  bool scanning;
+  int progress;
+  int found;
+  int count;
+  String ips[DS_SCAN_MAX_SHOWN];
+  String names[DS_SCAN_MAX_SHOWN];
+};
+
+static DsScanState *ds_scan_state = NULL;  // Worker -> LVGL task
+
+static void ds_tasmota_scan_worker(void *param) {
+  tasmotaStartScan();
   
-  // Start async task (small delay to let UI update)
-  lv_timer_create(ds_load_devices_task, 100, (void*)(intptr_t)ds_current_service);
+  bool scanning = true;
+  while (scanning) {
+    vTaskDelay(pdMS_TO_TICKS(DS_SCAN_POLL_MS));
+    
+    JsonDocument doc;
+    deserializeJson(doc, tasmotaGetScanResults());
+    
+    DsScanState *state = new DsScanState();
+    scanning = doc["scanning"].as<bool>();
+    state->scanning = scanning;
+    state->progress = doc["progress"].as<int>();
+    state->found = scanning ? doc["found"].as<int>() : doc["count"].as<int>();
+    state->count = 0;
+    if (!scanning) {
+      for (JsonObject dev : doc["devices"].as<JsonArray>()) {
+        if (state->count >= DS_SCAN_MAX_SHOWN) break;
+        state->ips[state->count] = dev["ip"].as<String>();
+        state->names[state->count] = dev["name"].as<String>();
+        state->count++;
+      }
+    }
+    
+    portENTER_CRITICAL(&ds_handover_mux);
+    DsScanState *stale = ds_scan_state;
+    ds_scan_state = state;
+    portEXIT_CRITICAL(&ds_handover_mux);
+    delete stale;  // Progress nobody displayed yet
+    
+    if (scanning) {
+      uiPost(UI_MSG_TASMOTA_SCAN);  // Progress may be dropped
+    } else {
+      ds_post_final(UI_MSG_TASMOTA_SCAN);
+    }
+  }
+  vTaskDelete(NULL);
+}
+
+static void ds_tasmota_add_btn_cb(lv_event_t *e) {
+  lv_obj_t *btn = lv_event_get_target(e);
+  String *ip = (String*)lv_obj_get_user_data(btn);
+  if (ip) {
+    tasmotaAddDevice(*ip, *ip, true, true);
+    tasmotaSaveConfig();
+    Serial.printf("Added Tasmota device: %s\n", ip->c_str());
+    
+    // Show feedback
+    lv_obj_t *lbl = lv_obj_get_child(btn, 0);
+    if (lbl) lv_label_set_text(lbl, LV_SYMBOL_OK);
+    lv_obj_set_style_bg_color(btn, DS_TEXT_DIM, 0);
+  }
+}
+
+// UI_MSG_TASMOTA_SCAN - LVGL task only
+void ds_on_tasmota_scan() {
+  portENTER_CRITICAL(&ds_handover_mux);
+  DsScanState *state = ds_scan_state;
+  ds_scan_state = NULL;
+  portEXIT_CRITICAL(&ds_handover_mux);
+  if (!state) return;
+  
+  // Update button text with progress
+  if (ds_tasmota_scan_btn && lv_obj_is_valid(ds_tasmota_scan_btn)) {
+    lv_obj_t *btn_lbl = lv_obj_get_child(ds_tasmota_scan_btn, 0);
+    if (btn_lbl) {
+      char txt[40];
+      if (state->scanning) {
+        snprintf(txt, sizeof(txt), "Scanne %d/254... (%d)", state->progress, state->found);
+      } else {
+        snprintf(txt, sizeof(txt), LV_SYMBOL_OK " %d Geraete gefunden", state->found);
+      }
+      lv_label_set_text(btn_lbl, txt);
+    }
+  }
+  
+  // If scan complete, update device list
+  if (!state->scanning) {
+    ds_tasmota_scanning = false;
+    
+    // Clear and rebuild device list
+    if (ds_tasmota_device_list && lv_obj_is_valid(ds_tasmota_device_list)) {
+      lv_obj_clean(ds_tasmota_device_list);
+      
+      for (int i = 0; i < state->count; i++) {
+        const String &ip = state->ips[i];
+        const String &name = state->names[i];
+        
+        // Create device item
+        lv_obj_t *item = lv_obj_create(ds_tasmota_device_list);
+        lv_obj_set_size(item, LV_PCT(100), 50);
+        lv_obj_set_style_bg_color(item, DS_CARD, 0);
+        lv_obj_set_style_radius(item, 8, 0);
+        lv_obj_set_style_border_width(item, 0, 0);
+        lv_obj_clear_flag(item, LV_OBJ_FLAG_SCROLLABLE);
+        
+        lv_obj_t *name_lbl = lv_label_create(item);
+        lv_label_set_text(name_lbl, name.c_str());
+        lv_obj_set_style_text_font(name_lbl, &lv_font_montserrat_14, 0);
+        lv_obj_set_style_text_color(name_lbl, DS_TEXT, 0);
+        lv_obj_align(name_lbl, LV_ALIGN_LEFT_MID, 10, -8);
+        
+        lv_obj_t *ip_lbl = lv_label_create(item);
+        lv_label_set_text(ip_lbl, ip.c_str());
+        lv_obj_set_style_text_font(ip_lbl, &lv_font_montserrat_12, 0);
+        lv_obj_set_style_text_color(ip_lbl, DS_TEXT_DIM, 0);
+        lv_obj_align(ip_lbl, LV_ALIGN_LEFT_MID, 10, 10);
+        
+        // Add button
+        lv_obj_t *add_btn = lv_btn_create(item);
+        lv_obj_set_size(add_btn, 70, 35);
+        lv_obj_align(add_btn, LV_ALIGN_RIGHT_MID, -5, 0);
+        lv_obj_set_style_bg_color(add_btn, DS_SUCCESS, 0);
+        lv_obj_set_style_radius(add_btn, 6, 0);
+        
+        // Store IP in button user data
+        String *ipPtr = new String(ip);
+        lv_obj_set_user_data(add_btn, ipPtr);
+        
+        lv_obj_t *add_lbl = lv_label_create(add_btn);
+        lv_label_set_text(add_lbl, LV_SYMBOL_PLUS);
+        lv_obj_set_style_text_color(add_lbl, lv_color_hex(0x1a1a2e), 0);
+        lv_obj_center(add_lbl);
+        
+        lv_obj_add_event_cb(add_btn, ds_tasmota_add_btn_cb, LV_EVENT_CLICKED, NULL);
+      }
+    }
+    
+    // Reset button text after delay
+    lv_timer_t *timer = lv_timer_create([](lv_timer_t *t) {
+      if (ds_tasmota_scan_btn && lv_obj_is_valid(ds_tasmota_scan_btn)) {
+        lv_obj_t *btn_lbl = lv_obj_get_child(ds_tasmota_scan_btn, 0);
+        if (btn_lbl) lv_label_set_text(btn_lbl, LV_SYMBOL_REFRESH " Netzwerk scannen");
+      }
+    }, 3000, NULL);
+    lv_timer_set_repeat_count(timer, 1);
+  }
+  
+  delete state;
+}
+
+static void ds_tasmota_scan_btn_cb(lv_event_t *e) {
+  if (ds_tasmota_scanning) return;
+  
+  BaseType_t created = xTaskCreatePinnedToCore(ds_tasmota_scan_worker, "ds_scan", DS_WORKER_STACK, NULL,
+                                               DS_WORKER_PRIORITY, NULL, DS_WORKER_CORE);
+  if (created != pdPASS) {
+    Serial.println("✗ Failed to start Tasmota scan task");
+    return;
+  }
+  ds_tasmota_scanning = true;
+  
+  // Update button text
+  lv_obj_t *btn_lbl = lv_obj_get_child(ds_tasmota_scan_btn, 0);
+  if (btn_lbl) lv_label_set_text(btn_lbl, "Scanne...");
 }
 
 // ============================================================
@@ -770,121 +984,7 @@ void ds_show_service_settings(int service) {
     lv_obj_set_size(ds_tasmota_scan_btn, LV_PCT(100), 45);
     lv_obj_set_style_bg_color(ds_tasmota_scan_btn, DS_TASMOTA, 0);
     lv_obj_set_style_radius(ds_tasmota_scan_btn, 8, 0);
-    lv_obj_add_event_cb(ds_tasmota_scan_btn, [](lv_event_t *e) {
-      if (ds_tasmota_scanning) return;
-      ds_tasmota_scanning = true;
-      
-      // Update button text
-      lv_obj_t *btn_lbl = lv_obj_get_child(ds_tasmota_scan_btn, 0);
-      if (btn_lbl) lv_label_set_text(btn_lbl, "Scanne...");
-      
-      // Start scan
-      tasmotaStartScan();
-      
-      // Create timer to poll results
-      lv_timer_create([](lv_timer_t *timer) {
-        String result = tasmotaGetScanResults();
-        JsonDocument doc;
-        deserializeJson(doc, result);
-        
-        bool scanning = doc["scanning"].as<bool>();
-        int progress = doc["progress"].as<int>();
-        int found = doc["found"].as<int>();
-        
-        // Update button text with progress
-        if (ds_tasmota_scan_btn && lv_obj_is_valid(ds_tasmota_scan_btn)) {
-          lv_obj_t *btn_lbl = lv_obj_get_child(ds_tasmota_scan_btn, 0);
-          if (btn_lbl) {
-            char txt[40];
-            if (scanning) {
-              snprintf(txt, sizeof(txt), "Scanne %d/254... (%d)", progress, found);
-            } else {
-              snprintf(txt, sizeof(txt), LV_SYMBOL_OK " %d Geraete gefunden", found);
-            }
-            lv_label_set_text(btn_lbl, txt);
-          }
-        }
-        
-        // If scan complete, update device list
-        if (!scanning) {
-          ds_tasmota_scanning = false;
-          
-          // Clear and rebuild device list
-          if (ds_tasmota_device_list && lv_obj_is_valid(ds_tasmota_device_list)) {
-            lv_obj_clean(ds_tasmota_device_list);
-            
-            JsonArray devices = doc["devices"].as<JsonArray>();
-            for (JsonObject dev : devices) {
-              String ip = dev["ip"].as<String>();
-              String name = dev["name"].as<String>();
-              
-              // Create device item
-              lv_obj_t *item = lv_obj_create(ds_tasmota_device_list);
-              lv_obj_set_size(item, LV_PCT(100), 50);
-              lv_obj_set_style_bg_color(item, DS_CARD, 0);
-              lv_obj_set_style_radius(item, 8, 0);
-              lv_obj_set_style_border_width(item, 0, 0);
-              lv_obj_clear_flag(item, LV_OBJ_FLAG_SCROLLABLE);
-              
-              lv_obj_t *name_lbl = lv_label_create(item);
-              lv_label_set_text(name_lbl, name.c_str());
-              lv_obj_set_style_text_font(name_lbl, &lv_font_montserrat_14, 0);
-              lv_obj_set_style_text_color(name_lbl, DS_TEXT, 0);
-              lv_obj_align(name_lbl, LV_ALIGN_LEFT_MID, 10, -8);
-              
-              lv_obj_t *ip_lbl = lv_label_create(item);
-              lv_label_set_text(ip_lbl, ip.c_str());
-              lv_obj_set_style_text_font(ip_lbl, &lv_font_montserrat_12, 0);
-              lv_obj_set_style_text_color(ip_lbl, DS_TEXT_DIM, 0);
-              lv_obj_align(ip_lbl, LV_ALIGN_LEFT_MID, 10, 10);
-              
-              // Add button
-              lv_obj_t *add_btn = lv_btn_create(item);
-              lv_obj_set_size(add_btn, 70, 35);
-              lv_obj_align(add_btn, LV_ALIGN_RIGHT_MID, -5, 0);
-              lv_obj_set_style_bg_color(add_btn, DS_SUCCESS, 0);
-              lv_obj_set_style_radius(add_btn, 6, 0);
-              
-              // Store IP in button user data
-              String *ipPtr = new String(ip);
-              String *namePtr = new String(name);
-              lv_obj_set_user_data(add_btn, ipPtr);
-              
-              lv_obj_t *add_lbl = lv_label_create(add_btn);
-              lv_label_set_text(add_lbl, LV_SYMBOL_PLUS);
-              lv_obj_set_style_text_color(add_lbl, lv_color_hex(0x1a1a2e), 0);
-              lv_obj_center(add_lbl);
-              
-              lv_obj_add_event_cb(add_btn, [](lv_event_t *e) {
-                lv_obj_t *btn = lv_event_get_target(e);
-                String *ip = (String*)lv_obj_get_user_data(btn);
-                if (ip) {
-                  tasmotaAddDevice(*ip, *ip, true, true);
-                  tasmotaSaveConfig();
-                  Serial.printf("Added Tasmota device: %s\n", ip->c_str());
-                  
-                  // Show feedback
-                  lv_obj_t *lbl = lv_obj_get_child(btn, 0);
-                  if (lbl) lv_label_set_text(lbl, LV_SYMBOL_OK);
-                  lv_obj_set_style_bg_color(btn, DS_TEXT_DIM, 0);
-                }
-              }, LV_EVENT_CLICKED, NULL);
-            }
-          }
-          
-          // Reset button text after delay
-          lv_timer_create([](lv_timer_t *t) {
-            if (ds_tasmota_scan_btn && lv_obj_is_valid(ds_tasmota_scan_btn)) {
-              lv_obj_t *btn_lbl = lv_obj_get_child(ds_tasmota_scan_btn, 0);
-              if (btn_lbl) lv_label_set_text(btn_lbl, LV_SYMBOL_REFRESH " Netzwerk scannen");
-            }
-            lv_timer_del(t);
-          }, 3000, NULL);
-          
-          lv_timer_del(timer);
-        }
-      }, 500, NULL);
-    }, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_event_cb(ds_tasmota_scan_btn, ds_tasmota_scan_btn_cb, LV_EVENT_CLICKED, NULL);
     
     lv_obj_t *scan_btn_lbl = lv_label_create(ds_tasmota_scan_btn);
     lv_label_set_text(scan_btn_lbl, LV_SYMBOL_REFRESH " Netzwerk scannen");
@@ -20,6 +20,23 @@
 #include "board_config.h"
 #include "settings_ui.h"
 #include "wifi_ui.h"
+#include "feeding_task.h"
+#include "boot_profile.h"
+#include "version.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+// UI messages - the screens below post their worker results with uiPost()
+enum UiMessage : uint8_t {
+  UI_MSG_BOOT_DONE,          // Boot finished - replace the splash with the main UI
+  UI_MSG_REFRESH,            // Shared state changed - refresh status widgets now
+  UI_MSG_SHOW_WIFI_SETUP,    // Show the WiFi setup screen (config mode)
+  UI_MSG_TIME_SYNCED,        // First SNTP sync - start the screensaver clock
+  UI_MSG_DEVICES_LOADED,     // Cloud device list fetched (device_settings_ui.h)
+  UI_MSG_TASMOTA_SCAN        // Tasmota scan progress or result (device_settings_ui.h)
+};
+bool uiPost(UiMessage msg);
 
 // Forward declarations for screensaver
 int getScreensaverTimeout();
@@ -36,8 +53,6 @@ extern String redsea_AQUARIUM_NAME;
 extern String TUNZE_DEVICE_NAME;
 extern bool ENABLE_redsea;
 extern bool ENABLE_TUNZE;
-extern void startFeedingMode();
-extern void stopFeedingMode();
 
 // ============================================================
 // Display Configuration (Board-specific)
@@ -470,6 +485,8 @@ void loadScreensaverSettings() {
 #define UI_COLOR_TUNZE       lv_color_hex(0x00d9ff)  // Tunze cyan
 #define UI_COLOR_BUTTON      lv_color_hex(0x533483)  // Button purple
 
+static bool display_first_frame_done = false;  // Set by the first complete flush
+
 // ============================================================
 // LVGL Display Flush Callback (from official demo)
 // ============================================================
@@ -484,6 +501,12 @@ static void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t
 #endif
 
   lv_disp_flush_ready(disp);
+  
+  // Boot profile: first complete frame on the panel
+  if (!display_first_frame_done && lv_disp_flush_is_last(disp)) {
+    display_first_frame_done = true;
+    bootMark(BOOT_STAGE_FIRST_FRAME);
+  }
 }
 
 // ============================================================
@@ -536,11 +559,7 @@ static void main_btn_event_cb(lv_event_t *e) {
   
   if (code == LV_EVENT_CLICKED) {
     Serial.println("Main button clicked!");
-    if (feedingModeActive) {
-      stopFeedingMode();
-    } else {
-      startFeedingMode();
-    }
+    feedingEnqueue(feedingModeActive ? FEED_CMD_STOP : FEED_CMD_START);
   }
 }
 
@@ -628,6 +647,47 @@ void updateLvglUI() {
   updateMenuUI();
 }
 
+// ============================================================
+// Splash Screen (shown while WiFi and services start)
+// ============================================================
+static lv_obj_t *splash_screen = NULL;
+static lv_obj_t *splash_status = NULL;
+static const char *volatile splash_status_text = "Starte...";
+
+static void createSplash() {
+  splash_screen = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(splash_screen, MENU_BG, 0);
+  lv_obj_clear_flag(splash_screen, LV_OBJ_FLAG_SCROLLABLE);
+  
+  lv_obj_t *title = lv_label_create(splash_screen);
+  lv_label_set_text(title, APP_NAME);
+  lv_obj_set_style_text_font(title, &lv_font_montserrat_28, 0);
+  lv_obj_set_style_text_color(title, MENU_TEXT, 0);
+  lv_obj_align(title, LV_ALIGN_CENTER, 0, -70);
+  
+  lv_obj_t *spinner = lv_spinner_create(splash_screen, 1000, 60);
+  lv_obj_set_size(spinner, 60, 60);
+  lv_obj_set_style_arc_color(spinner, MENU_ACCENT, LV_PART_INDICATOR);
+  lv_obj_align(spinner, LV_ALIGN_CENTER, 0, 10);
+  
+  splash_status = lv_label_create(splash_screen);
+  lv_label_set_text(splash_status, splash_status_text);
+  lv_obj_set_style_text_font(splash_status, &lv_font_montserrat_16, 0);
+  lv_obj_set_style_text_color(splash_status, MENU_TEXT_DIM, 0);
+  lv_obj_align(splash_status, LV_ALIGN_CENTER, 0, 70);
+  
+  lv_obj_t *version = lv_label_create(splash_screen);
+  lv_label_set_text(version, BUILD_VERSION);
+  lv_obj_set_style_text_font(version, &lv_font_montserrat_14, 0);
+  lv_obj_set_style_text_color(version, MENU_TEXT_DIM, 0);
+  lv_obj_align(version, LV_ALIGN_BOTTOM_MID, 0, -20);
+}
+
+// Boot progress text on the splash - any task, text must be a string literal
+void bootSetStatus(const char *text) {
+  splash_status_text = text;
+}
+
 // ============================================================
 // Setup Display with LVGL
 // ============================================================
@@ -655,14 +715,6 @@ void setupDisplay() {
   delay(50);
   #endif
   
-  // Test display with white screen first, then black
-  Serial.println("Display Test: Weiss...");
-  gfx->fillScreen(0xFFFF); // WHITE
-  delay(200);
-  Serial.println("Display Test: Schwarz...");
-  gfx->fillScreen(0x0000); // BLACK
-  delay(100);
-  
   // Init Touch
   touch_init();
   Serial.println("Touch initialisiert");
@@ -706,6 +758,16 @@ void setupDisplay() {
   lv_indev_drv_register(&indev_drv);
   Serial.println("Touch-Treiber registriert");
   
+  // Splash first - the full UI is built by the LVGL task after the first frame
+  createSplash();
+  lv_scr_load(splash_screen);
+  Serial.println("Splash Screen bereit");
+}
+
+// ============================================================
+// Build Main UI (LVGL task, right after the splash is on screen)
+// ============================================================
+static void buildMainUI() {
   // Load screensaver settings
   loadScreensaverSettings();
   
@@ -716,25 +778,100 @@ void setupDisplay() {
   // Initialize screensaver
   createScreensaver();
   
+  // createMenuScreen() loads the menu - keep the splash until boot is done
+  if (splash_screen) lv_scr_load(splash_screen);
+  
   Serial.println("LVGL UI erstellt - Display bereit!");
 }
 
 // ============================================================
-// Show WiFi Setup if in config mode (call after WiFi setup)
+// LVGL Task
+// LVGL is not thread-safe. All lv_* calls run on this task, which is
+// the only caller of lv_timer_handler(). Network tasks stay on core 0
+// and never touch LVGL; other tasks talk to the UI through uiPost().
 // ============================================================
-void showWiFiSetupIfNeeded() {
-  extern bool wifiConfigMode;
-  if (wifiConfigMode) {
-    Serial.println("WiFi nicht konfiguriert - zeige Setup Screen");
-    showWiFiScreen();
+#define LVGL_TASK_STACK      8192
+#define LVGL_TASK_PRIORITY   2      // Above the Arduino loop task (1)
+#define LVGL_TASK_CORE       1      // WiFi/lwIP and all network workers run on core 0
+#define LVGL_FRAME_MS        5      // Fixed timer handler cadence
+#define UI_QUEUE_LENGTH      8      // Pending UI messages before uiPost() drops
+#define LVGL_SLOW_FRAME_MS   50     // Worst frame above this is logged (UI stall)
+#define LVGL_FRAME_REPORT_MS 10000  // Window for the worst frame time
+
+static QueueHandle_t uiQueue = NULL;
+static TaskHandle_t lvglTaskHandle = NULL;
+static bool lvgl_ui_built = false;
+
+// Post a message to the LVGL task - never blocks, safe from any task
+bool uiPost(UiMessage msg) {
+  if (!uiQueue) return false;
+  return xQueueSend(uiQueue, &msg, 0) == pdTRUE;
+}
+
+static void uiHandleMessage(UiMessage msg) {
+  switch (msg) {
+    case UI_MSG_BOOT_DONE:
+      if (splash_screen) {
+        lv_scr_load(screen_main);
+        lv_obj_del(splash_screen);
+        splash_screen = NULL;
+        splash_status = NULL;
+        last_touch_time = millis();  // Screensaver timeout starts now
+      }
+      break;
+    case UI_MSG_REFRESH:
+      updateLvglUI();
+      break;
+    case UI_MSG_SHOW_WIFI_SETUP:
+      Serial.println("WiFi nicht konfiguriert - zeige Setup Screen");
+      showWiFiScreen();
+      break;
+    case UI_MSG_TIME_SYNCED:
+      refreshScreensaverClock();
+      break;
+#ifdef BOARD_ESP32_4848S040
+    case UI_MSG_DEVICES_LOADED:
+      ds_on_devices_loaded();
+      break;
+    case UI_MSG_TASMOTA_SCAN:
+      ds_on_tasmota_scan();
+      break;
+#else
+    default:
+      break;
+#endif
   }
 }
 
 // ============================================================
-// Update Display (call in loop)
+// Update Display (one frame, LVGL task only)
 // ============================================================
-void updateDisplay() {
+static void updateDisplay() {
+  // Messages wait in the queue until the main UI exists
+  UiMessage msg;
+  while (lvgl_ui_built && xQueueReceive(uiQueue, &msg, 0) == pdTRUE) {
+    uiHandleMessage(msg);
+  }
+  
+  if (splash_screen) {
+    const char *text = splash_status_text;
+    if (splash_status && strcmp(lv_label_get_text(splash_status), text) != 0) {
+      lv_label_set_text(splash_status, text);
+    }
+  }
+  
   lv_timer_handler();
+  
+  if (!lvgl_ui_built) {
+    // Build the main UI once the splash has reached the panel
+    if (display_first_frame_done) {
+      buildMainUI();
+      lvgl_ui_built = true;
+    }
+    return;
+  }
+  if (splash_screen) return;  // Still booting
+  
   updateLvglUI();
   updateWiFiUI();  // Update WiFi screen if active
   
@@ -747,6 +884,72 @@ void updateDisplay() {
   }
 }
 
+static void lvglTask(void* param) {
+  TickType_t lastWake = xTaskGetTickCount();
+  const TickType_t period = pdMS_TO_TICKS(LVGL_FRAME_MS);
+  
+  unsigned long worstFrameUs = 0;
+  unsigned long reportAt = millis() + LVGL_FRAME_REPORT_MS;
+  
+  while (true) {
+    unsigned long frameStart = micros();
+    updateDisplay();
+    
+    // Frame timing: a blocking call on this task shows up here
+    unsigned long frameUs = micros() - frameStart;
+    if (frameUs > worstFrameUs) worstFrameUs = frameUs;
+    if ((long)(millis() - reportAt) >= 0) {
+      if (worstFrameUs > LVGL_SLOW_FRAME_MS * 1000UL) {
+        Serial.printf("⚠ LVGL: slowest frame %lu ms in the last %d s\n", worstFrameUs / 1000,
+                      LVGL_FRAME_REPORT_MS / 1000);
+      }
+      worstFrameUs = 0;
+      reportAt = millis() + LVGL_FRAME_REPORT_MS;
+    }
+    
+    // Fixed cadence; resync instead of bursting after a long frame
+    if (xTaskGetTickCount() - lastWake >= period) {
+      lastWake = xTaskGetTickCount();
+      vTaskDelay(1);
+    } else {
+      vTaskDelayUntil(&lastWake, period);
+    }
+  }
+}
+
+// Start the LVGL task (call once after setupDisplay)
+void lvglTaskBegin() {
+  if (lvglTaskHandle) return;
+  
+  uiQueue = xQueueCreate(UI_QUEUE_LENGTH, sizeof(UiMessage));
+  
+  BaseType_t created = xTaskCreatePinnedToCore(
+    lvglTask,               // Task function
+    "lvgl",                 // Name
+    LVGL_TASK_STACK,        // Stack size
+    NULL,                   // Parameters
+    LVGL_TASK_PRIORITY,     // Priority
+    &lvglTaskHandle,        // Task handle
+    LVGL_TASK_CORE          // Core
+  );
+  
+  if (created == pdPASS) {
+    Serial.printf("✓ LVGL task started (core %d, %d ms frames)\n", LVGL_TASK_CORE, LVGL_FRAME_MS);
+  } else {
+    Serial.println("✗ Failed to start LVGL task");
+  }
+}
+
+// ============================================================
+// Show WiFi Setup if in config mode (call after WiFi setup)
+// ============================================================
+void showWiFiSetupIfNeeded() {
+  extern bool wifiConfigMode;
+  if (wifiConfigMode) {
+    uiPost(UI_MSG_SHOW_WIFI_SETUP);
+  }
+}
+
 // ============================================================
 // Getter for main screen (used by wifi_ui.h)
 // ============================================================
@@ -0,0 +1,273 @@
+/**
+ * @file feeding_fanout.h
+ * @brief Concurrent dispatch of one feeding command to all backends
+ *
+ * Red Sea, Tunze and Tasmota are started as separate FreeRTOS tasks and
+ * joined with one deadline per backend, so the total latency of a
+ * command is that of the slowest backend rather than the sum of all
+ * three. Kept apart from the job bookkeeping in feeding_task.h so the
+ * join logic also builds on the host (test/test_feeding_fanout).
+ */
+
+#ifndef FEEDING_FANOUT_H
+#define FEEDING_FANOUT_H
+
+#include <Arduino.h>
+#include <limits.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+
+// ============================================================
+// Configuration
+// ============================================================
+#define FEEDING_BACKEND_STACK     10240  // Per-backend fan-out task
+#define FEEDING_BACKEND_PRIORITY  2
+#define FEEDING_BACKEND_CORE      0      // Same core as the WiFi stack
+
+// Per-backend deadlines for one start/stop command (ms)
+#define FEEDING_DEADLINE_REDSEA   16000  // Login + command over HTTPS
+#define FEEDING_DEADLINE_TUNZE    8000   // WebSocket connect wait + send
+#define FEEDING_DEADLINE_TASMOTA  20000  // All enabled plugs incl. retries
+
+// ============================================================
+// Backends
+// ============================================================
+enum FeedingBackend : uint8_t {
+  FEED_BACKEND_REDSEA,
+  FEED_BACKEND_TUNZE,
+  FEED_BACKEND_TASMOTA,
+  FEED_BACKEND_COUNT
+};
+
+enum FeedingStepState : uint8_t {
+  FEED_STEP_PENDING,
+  FEED_STEP_RUNNING,
+  FEED_STEP_OK,
+  FEED_STEP_FAILED,
+  FEED_STEP_SKIPPED,
+  FEED_STEP_TIMEOUT    // Deadline passed - result no longer awaited
+};
+
+static const char* feedingStepName(FeedingStepState state) {
+  switch (state) {
+    case FEED_STEP_RUNNING: return "running";
+    case FEED_STEP_OK:      return "ok";
+    case FEED_STEP_FAILED:  return "failed";
+    case FEED_STEP_SKIPPED: return "skipped";
+    case FEED_STEP_TIMEOUT: return "timeout";
+    default:                return "pending";
+  }
+}
+
+// Defined in feeding_task.h - progress is recorded on the running job
+uint32_t feedingActiveJobId();
+void feedingJobReportFor(uint32_t jobId, FeedingBackend backend, FeedingStepState state,
+                         unsigned long elapsedMs = 0);
+
+// ============================================================
+// Concurrent Backend Fan-Out
+// ============================================================
+typedef bool (*FeedingBackendFn)();
+
+struct FeedingBackendResult {
+  FeedingStepState state;
+  unsigned long elapsedMs;
+};
+
+struct FeedingFanOut;
+
+struct FeedingBackendSlot {
+  FeedingFanOut* owner;
+  FeedingBackend backend;
+  FeedingBackendFn fn;
+};
+
+// Shared by the dispatcher and the backend tasks. Reference counted,
+// because a backend that misses its deadline keeps running after the
+// dispatcher has moved on.
+struct FeedingFanOut {
+  int refs;
+  uint32_t jobId;
+  unsigned long startedAt;
+  EventGroupHandle_t doneBits;
+  FeedingBackendSlot slot[FEED_BACKEND_COUNT];
+  FeedingBackendResult result[FEED_BACKEND_COUNT];
+};
+
+static portMUX_TYPE feedingFanOutMux = portMUX_INITIALIZER_UNLOCKED;
+
+// One mutex per backend: a command that overran its deadline must finish
+// before the next command for the same backend starts (a late "start"
+// must never land after a "stop").
+static SemaphoreHandle_t feedingBackendLock[FEED_BACKEND_COUNT] = {NULL, NULL, NULL};
+
+static const char* feedingBackendName(FeedingBackend backend) {
+  switch (backend) {
+    case FEED_BACKEND_REDSEA: return "Red Sea";
+    case FEED_BACKEND_TUNZE:  return "Tunze";
+    default:                  return "Tasmota";
+  }
+}
+
+static void feedingFanOutRelease(FeedingFanOut* fan) {
+  portENTER_CRITICAL(&feedingFanOutMux);
+  int refs = --fan->refs;
+  portEXIT_CRITICAL(&feedingFanOutMux);
+
+  if (refs == 0) {
+    vEventGroupDelete(fan->doneBits);
+    delete fan;
+  }
+}
+
+static void feedingBackendTask(void* parameter) {
+  FeedingBackendSlot* slot = (FeedingBackendSlot*)parameter;
+  FeedingFanOut* fan = slot->owner;
+
+  xSemaphoreTake(feedingBackendLock[slot->backend], portMAX_DELAY);
+  bool success = slot->fn();
+  xSemaphoreGive(feedingBackendLock[slot->backend]);
+
+  unsigned long elapsed = millis() - fan->startedAt;
+  FeedingStepState state = success ? FEED_STEP_OK : FEED_STEP_FAILED;
+
+  // The dispatcher may already have given up on us - the recorded
+  // timeout stands, the late result is only logged
+  portENTER_CRITICAL(&feedingFanOutMux);
+  bool late = (fan->result[slot->backend].state == FEED_STEP_TIMEOUT);
+  if (!late) {
+    fan->result[slot->backend].state = state;
+    fan->result[slot->backend].elapsedMs = elapsed;
+  }
+  portEXIT_CRITICAL(&feedingFanOutMux);
+
+  if (late) {
+    Serial.printf("⚠ %s: late result after deadline: %s (%lu ms)\n",
+                  feedingBackendName(slot->backend), feedingStepName(state), elapsed);
+  } else {
+    feedingJobReportFor(fan->jobId, slot->backend, state, elapsed);
+  }
+  xEventGroupSetBits(fan->doneBits, BIT(slot->backend));
+
+  feedingFanOutRelease(fan);
+  vTaskDelete(NULL);
+}
+
+// ============================================================
+// Run enabled backends concurrently and join the results
+// fns[i] == NULL means the backend is disabled (reported as skipped).
+// Returns when every backend has finished or passed its deadline.
+// ============================================================
+void feedingFanOut(const FeedingBackendFn fns[FEED_BACKEND_COUNT],
+                   const unsigned long deadlineMs[FEED_BACKEND_COUNT],
+                   FeedingBackendResult results[FEED_BACKEND_COUNT]) {
+  for (int i = 0; i < FEED_BACKEND_COUNT; i++) {
+    if (!feedingBackendLock[i]) feedingBackendLock[i] = xSemaphoreCreateMutex();
+  }
+
+  FeedingFanOut* fan = new FeedingFanOut();
+  fan->refs = 1;  // Dispatcher reference
+  fan->jobId = feedingActiveJobId();
+  fan->startedAt = millis();
+  fan->doneBits = xEventGroupCreate();
+
+  EventBits_t pending = 0;
+
+  for (int i = 0; i < FEED_BACKEND_COUNT; i++) {
+    FeedingBackend backend = (FeedingBackend)i;
+    fan->result[i].state = fns[i] ? FEED_STEP_RUNNING : FEED_STEP_SKIPPED;
+    fan->result[i].elapsedMs = 0;
+    if (!fns[i]) {
+      feedingJobReportFor(fan->jobId, backend, FEED_STEP_SKIPPED);
+      continue;
+    }
+
+    fan->slot[i].owner = fan;
+    fan->slot[i].backend = backend;
+    fan->slot[i].fn = fns[i];
+
+    portENTER_CRITICAL(&feedingFanOutMux);
+    fan->refs++;
+    portEXIT_CRITICAL(&feedingFanOutMux);
+
+    feedingJobReportFor(fan->jobId, backend, FEED_STEP_RUNNING);
+
+    BaseType_t created = xTaskCreatePinnedToCore(
+      feedingBackendTask,     // Task function
+      "feeding_backend",      // Name
+      FEEDING_BACKEND_STACK,  // Stack size
+      &fan->slot[i],          // Parameters
+      FEEDING_BACKEND_PRIORITY, // Priority
+      NULL,                   // Task handle
+      FEEDING_BACKEND_CORE    // Core
+    );
+
+    if (created != pdPASS) {
+      // Out of memory for another task - run this backend inline instead
+      Serial.printf("⚠ %s: no task available, running inline\n", feedingBackendName(backend));
+      portENTER_CRITICAL(&feedingFanOutMux);
+      fan->refs--;
+      portEXIT_CRITICAL(&feedingFanOutMux);
+      xSemaphoreTake(feedingBackendLock[i], portMAX_DELAY);
+      bool success = fns[i]();
+      xSemaphoreGive(feedingBackendLock[i]);
+      fan->result[i].state = success ? FEED_STEP_OK : FEED_STEP_FAILED;
+      fan->result[i].elapsedMs = millis() - fan->startedAt;
+      feedingJobReportFor(fan->jobId, backend, fan->result[i].state, fan->result[i].elapsedMs);
+      continue;
+    }
+
+    pending |= BIT(i);
+  }
+
+  // Join: wait for all pending backends, giving up on each one at its own deadline
+  while (pending) {
+    unsigned long elapsed = millis() - fan->startedAt;
+    unsigned long nextDeadline = ULONG_MAX;
+    for (int i = 0; i < FEED_BACKEND_COUNT; i++) {
+      if ((pending & BIT(i)) && deadlineMs[i] < nextDeadline) nextDeadline = deadlineMs[i];
+    }
+
+    TickType_t wait = (nextDeadline > elapsed) ? pdMS_TO_TICKS(nextDeadline - elapsed) : 0;
+    EventBits_t done = xEventGroupWaitBits(fan->doneBits, pending, pdFALSE, pdTRUE, wait);
+    pending &= ~done;
+
+    elapsed = millis() - fan->startedAt;
+    for (int i = 0; i < FEED_BACKEND_COUNT; i++) {
+      if ((pending & BIT(i)) && elapsed >= deadlineMs[i]) {
+        pending &= ~BIT(i);
+
+        // The result may have landed between the wait and this check
+        portENTER_CRITICAL(&feedingFanOutMux);
+        bool timedOut = (fan->result[i].state == FEED_STEP_RUNNING);
+        if (timedOut) {
+          fan->result[i].state = FEED_STEP_TIMEOUT;
+          fan->result[i].elapsedMs = elapsed;
+        }
+        portEXIT_CRITICAL(&feedingFanOutMux);
+
+        if (timedOut) {
+          Serial.printf("✗ %s: no result after %lu ms - giving up\n",
+                        feedingBackendName((FeedingBackend)i), deadlineMs[i]);
+          feedingJobReportFor(fan->jobId, (FeedingBackend)i, FEED_STEP_TIMEOUT, elapsed);
+        }
+      }
+    }
+  }
+
+  portENTER_CRITICAL(&feedingFanOutMux);
+  for (int i = 0; i < FEED_BACKEND_COUNT; i++) results[i] = fan->result[i];
+  portEXIT_CRITICAL(&feedingFanOutMux);
+
+  for (int i = 0; i < FEED_BACKEND_COUNT; i++) {
+    if (results[i].state == FEED_STEP_SKIPPED) continue;
+    Serial.printf("  %-8s %-8s %5lu ms\n", feedingBackendName((FeedingBackend)i),
+                  feedingStepName(results[i].state), results[i].elapsedMs);
+  }
+
+  feedingFanOutRelease(fan);
+}
+
+#endif // FEEDING_FANOUT_H
@@ -0,0 +1,300 @@
+/**
+ * @file feeding_task.h
+ * @brief Feeding command worker task
+ *
+ * Web handlers, the touch UI and the BOOT button only enqueue feeding
+ * commands. A dedicated FreeRTOS task executes them one after another,
+ * so the slow cloud and Tasmota calls never block the AsyncTCP task or
+ * the UI loop. Every command gets a job id whose per-backend progress
+ * can be queried via /api/feeding/job/<id>.
+ *
+ * Within a job the Red Sea, Tunze and Tasmota backends are dispatched
+ * concurrently by feedingFanOut() (feeding_fanout.h).
+ */
+
+#ifndef FEEDING_TASK_H
+#define FEEDING_TASK_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "feeding_fanout.h"
+
+// Forward declarations from main
+extern bool feedingModeActive;
+extern bool ENABLE_redsea;
+void startFeedingMode();
+void stopFeedingMode();
+int redseaCachedFeedingStatus(unsigned long maxAgeMs);
+
+// ============================================================
+// Configuration
+// ============================================================
+#define FEEDING_QUEUE_LENGTH    4      // Pending commands before we reject
+#define FEEDING_JOB_HISTORY     8      // Finished jobs kept for status queries
+#define FEEDING_TASK_STACK      12288  // TLS handshakes need a large stack
+#define FEEDING_TASK_PRIORITY   2
+#define FEEDING_TASK_CORE       0      // Same core as the WiFi stack
+
+// ============================================================
+// Job Types
+// ============================================================
+enum FeedingCommand : uint8_t {
+  FEED_CMD_START,
+  FEED_CMD_STOP,
+  FEED_CMD_TOGGLE      // Sync with cloud status first, then start or stop
+};
+
+enum FeedingJobState : uint8_t {
+  FEED_JOB_QUEUED,
+  FEED_JOB_RUNNING,
+  FEED_JOB_DONE
+};
+
+struct FeedingJob {
+  uint32_t id;                                  // 0 = slot unused
+  FeedingCommand command;                       // Resolved command (TOGGLE becomes START/STOP)
+  FeedingJobState state;
+  FeedingStepState backend[FEED_BACKEND_COUNT];
+  unsigned long backendMs[FEED_BACKEND_COUNT];  // Elapsed time per backend
+  unsigned long queuedAt;
+  unsigned long startedAt;
+  unsigned long finishedAt;
+};
+
+// ============================================================
+// Worker State
+// ============================================================
+static QueueHandle_t feedingQueue = NULL;
+static TaskHandle_t feedingTaskHandle = NULL;
+static FeedingJob feedingJobs[FEEDING_JOB_HISTORY];
+static uint32_t feedingNextJobId = 1;
+static volatile uint32_t feedingCurrentJobId = 0;
+static portMUX_TYPE feedingJobMux = portMUX_INITIALIZER_UNLOCKED;
+
+static const char* feedingCommandName(FeedingCommand cmd) {
+  switch (cmd) {
+    case FEED_CMD_START:  return "start";
+    case FEED_CMD_STOP:   return "stop";
+    default:              return "toggle";
+  }
+}
+
+static const char* feedingJobStateName(FeedingJobState state) {
+  switch (state) {
+    case FEED_JOB_RUNNING: return "running";
+    case FEED_JOB_DONE:    return "done";
+    default:               return "queued";
+  }
+}
+
+// Slot lookup - caller must hold feedingJobMux
+static FeedingJob* feedingFindJob(uint32_t id) {
+  if (id == 0) return NULL;
+  FeedingJob* job = &feedingJobs[id % FEEDING_JOB_HISTORY];
+  return (job->id == id) ? job : NULL;
+}
+
+// ============================================================
+// Progress Reporting
+// ============================================================
+uint32_t feedingActiveJobId() {
+  return feedingCurrentJobId;
+}
+
+void feedingJobReportFor(uint32_t jobId, FeedingBackend backend, FeedingStepState state,
+                         unsigned long elapsedMs) {
+  portENTER_CRITICAL(&feedingJobMux);
+  FeedingJob* job = feedingFindJob(jobId);
+  if (job) {
+    job->backend[backend] = state;
+    job->backendMs[backend] = elapsedMs;
+  }
+  portEXIT_CRITICAL(&feedingJobMux);
+}
+
+// ============================================================
+// Worker Task
+// ============================================================
+static void feedingTask(void* parameter) {
+  uint32_t jobId;
+
+  for (;;) {
+    if (xQueueReceive(feedingQueue, &jobId, portMAX_DELAY) != pdTRUE) continue;
+
+    FeedingCommand command;
+    portENTER_CRITICAL(&feedingJobMux);
+    FeedingJob* job = feedingFindJob(jobId);
+    if (job) {
+      job->state = FEED_JOB_RUNNING;
+      job->startedAt = millis();
+      command = job->command;
+    }
+    portEXIT_CRITICAL(&feedingJobMux);
+    if (!job) continue;  // Overwritten while queued (should not happen)
+
+    feedingCurrentJobId = jobId;
+    Serial.printf("[FEEDING] Job %u: %s\n", jobId, feedingCommandName(command));
+
+    if (command == FEED_CMD_TOGGLE) {
+      // Sync with the cached cloud status (only if redsea enabled). The
+      // cache is refreshed in the background - no HTTPS round trip here,
+      // and a stale cache leaves the local state untouched.
+      if (ENABLE_redsea) {
+        int cloudStatus = redseaCachedFeedingStatus(REDSEA_STATUS_TTL);
+        if (cloudStatus >= 0 && (cloudStatus == 1) != feedingModeActive) {
+          Serial.println("⚠ Syncing with cloud status...");
+          feedingModeActive = (cloudStatus == 1);
+        }
+      }
+      command = feedingModeActive ? FEED_CMD_STOP : FEED_CMD_START;
+
+      portENTER_CRITICAL(&feedingJobMux);
+      job = feedingFindJob(jobId);
+      if (job) job->command = command;
+      portEXIT_CRITICAL(&feedingJobMux);
+    }
+
+    if (command == FEED_CMD_START) {
+      startFeedingMode();
+    } else {
+      stopFeedingMode();
+    }
+
+    portENTER_CRITICAL(&feedingJobMux);
+    job = feedingFindJob(jobId);
+    if (job) {
+      job->state = FEED_JOB_DONE;
+      job->finishedAt = millis();
+    }
+    portEXIT_CRITICAL(&feedingJobMux);
+    feedingCurrentJobId = 0;
+
+    Serial.printf("[FEEDING] Job %u done\n", jobId);
+  }
+}
+
+// ============================================================
+// Start Worker (call once in setup)
+// ============================================================
+void feedingTaskBegin() {
+  if (feedingTaskHandle) return;
+
+  feedingQueue = xQueueCreate(FEEDING_QUEUE_LENGTH, sizeof(uint32_t));
+
+  xTaskCreatePinnedToCore(
+    feedingTask,            // Task function
+    "feeding_cmd",          // Name
+    FEEDING_TASK_STACK,     // Stack size
+    NULL,                   // Parameters
+    FEEDING_TASK_PRIORITY,  // Priority
+    &feedingTaskHandle,     // Task handle
+    FEEDING_TASK_CORE       // Core
+  );
+
+  Serial.println("✓ Feeding command task started");
+}
+
+// ============================================================
+// Enqueue Command (non-blocking)
+// Returns the job id, or 0 if the queue is full
+// ============================================================
+uint32_t feedingEnqueue(FeedingCommand command) {
+  if (!feedingQueue) return 0;
+
+  // Reject before claiming a history slot - a full queue must not
+  // evict the record of an older job
+  if (uxQueueSpacesAvailable(feedingQueue) == 0) {
+    Serial.println("✗ Feeding command queue full - request rejected");
+    return 0;
+  }
+
+  portENTER_CRITICAL(&feedingJobMux);
+  uint32_t jobId = feedingNextJobId++;
+  if (feedingNextJobId == 0) feedingNextJobId = 1;
+  FeedingJob* job = &feedingJobs[jobId % FEEDING_JOB_HISTORY];
+  FeedingJob evicted = *job;
+  job->id = jobId;
+  job->command = command;
+  job->state = FEED_JOB_QUEUED;
+  for (int i = 0; i < FEED_BACKEND_COUNT; i++) {
+    job->backend[i] = FEED_STEP_PENDING;
+    job->backendMs[i] = 0;
+  }
+  job->queuedAt = millis();
+  job->startedAt = 0;
+  job->finishedAt = 0;
+  portEXIT_CRITICAL(&feedingJobMux);
+
+  if (xQueueSend(feedingQueue, &jobId, 0) != pdTRUE) {
+    // Lost the last free entry to a concurrent caller - put the old record back
+    Serial.println("✗ Feeding command queue full - request rejected");
+    portENTER_CRITICAL(&feedingJobMux);
+    if (job->id == jobId) *job = evicted;
+    portEXIT_CRITICAL(&feedingJobMux);
+    return 0;
+  }
+
+  return jobId;
+}
+
+// Id of the job currently queued or running (0 = idle)
+uint32_t feedingPendingJobId() {
+  uint32_t pending = 0;
+  portENTER_CRITICAL(&feedingJobMux);
+  for (int i = 0; i < FEEDING_JOB_HISTORY; i++) {
+    if (feedingJobs[i].id != 0 && feedingJobs[i].state != FEED_JOB_DONE &&
+        feedingJobs[i].id > pending) {
+      pending = feedingJobs[i].id;
+    }
+  }
+  portEXIT_CRITICAL(&feedingJobMux);
+  return pending;
+}
+
+// ============================================================
+// Get Job Status as JSON (empty string if unknown)
+// ============================================================
+String feedingGetJobJson(uint32_t id) {
+  FeedingJob snapshot;
+  bool found = false;
+
+  portENTER_CRITICAL(&feedingJobMux);
+  FeedingJob* job = feedingFindJob(id);
+  if (job) {
+    snapshot = *job;
+    found = true;
+  }
+  portEXIT_CRITICAL(&feedingJobMux);
+
+  if (!found) return "";
+
+  JsonDocument doc;
+  doc["success"] = true;
+  doc["id"] = snapshot.id;
+  doc["command"] = feedingCommandName(snapshot.command);
+  doc["state"] = feedingJobStateName(snapshot.state);
+  doc["feeding_active"] = feedingModeActive;
+
+  static const char* backendKeys[FEED_BACKEND_COUNT] = {"redsea", "tunze", "tasmota"};
+  JsonObject backends = doc["backends"].to<JsonObject>();
+  for (int i = 0; i < FEED_BACKEND_COUNT; i++) {
+    JsonObject b = backends[backendKeys[i]].to<JsonObject>();
+    b["state"] = feedingStepName(snapshot.backend[i]);
+    b["elapsed_ms"] = snapshot.backendMs[i];
+  }
+
+  if (snapshot.state == FEED_JOB_DONE) {
+    doc["elapsed_ms"] = snapshot.finishedAt - snapshot.startedAt;
+  } else if (snapshot.state == FEED_JOB_RUNNING) {
+    doc["elapsed_ms"] = millis() - snapshot.startedAt;
+  }
+
+  String result;
+  serializeJson(doc, result);
+  return result;
+}
+
+#endif // FEEDING_TASK_H
@@ -0,0 +1,246 @@
+/**
+ * @file https_pool.h
+ * @brief Keep-alive HTTPS connection pool for the cloud APIs
+ *
+ * Red Sea and Tunze requests used to build a fresh WiFiClientSecure for
+ * every call and paid a full TLS handshake each time. The pool keeps a
+ * small number of warm keep-alive connections per host. Each entry owns
+ * its HTTPClient as well: HTTPClient closes the socket in its destructor,
+ * so only reusing the same HTTPClient object keeps the connection open.
+ * When a connection has to be re-established, TlsResumeClient
+ * (tls_session.h) resumes the previous TLS session of the host.
+ *
+ * Usage:
+ *   HttpsLease lease(redsea_API_HOST);
+ *   HTTPClient& http = lease.http();
+ *   http.begin(lease.client(), url);
+ *   ...
+ *   http.end();   // connection stays open if the server allows keep-alive
+ */
+
+#ifndef HTTPS_POOL_H
+#define HTTPS_POOL_H
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "tls_session.h"
+
+// ============================================================
+// Configuration
+// ============================================================
+#define HTTPS_POOL_MAX_SOCKETS    2       // Each TLS session holds ~40 KB of heap
+#define HTTPS_POOL_IDLE_TIMEOUT   30000   // Close warm connections after 30 s idle
+#define HTTPS_POOL_MAINTAIN_MS    5000    // Idle check interval
+
+// ============================================================
+// Pool State
+// ============================================================
+struct HttpsPoolEntry {
+  String host;
+  WiFiClientSecure* client;
+  HTTPClient* http;
+  unsigned long lastUsed;
+  bool inUse;
+};
+
+struct HttpsPoolStats {
+  uint32_t reuses;      // Request served on a warm connection
+  uint32_t misses;      // Request needed a new TLS connection
+  uint32_t overflows;   // Pool exhausted - temporary connection used
+  uint32_t evictions;   // Idle connections closed
+};
+
+static HttpsPoolEntry httpsPool[HTTPS_POOL_MAX_SOCKETS];
+static HttpsPoolStats httpsPoolStats = {0, 0, 0, 0};
+static SemaphoreHandle_t httpsPoolMutex = NULL;
+static portMUX_TYPE httpsPoolInitMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void httpsPoolLock() {
+  if (!httpsPoolMutex) {
+    SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+    portENTER_CRITICAL(&httpsPoolInitMux);
+    if (!httpsPoolMutex) {
+      httpsPoolMutex = mutex;
+      mutex = NULL;
+    }
+    portEXIT_CRITICAL(&httpsPoolInitMux);
+    if (mutex) vSemaphoreDelete(mutex);
+  }
+  xSemaphoreTake(httpsPoolMutex, portMAX_DELAY);
+}
+
+static void httpsPoolUnlock() {
+  xSemaphoreGive(httpsPoolMutex);
+}
+
+// Close the connection of an entry - caller must hold the pool lock
+static void httpsPoolCloseEntry(HttpsPoolEntry& entry) {
+  if (entry.http) {
+    delete entry.http;  // Stops the socket
+    entry.http = NULL;
+  }
+  if (entry.client) {
+    entry.client->stop();
+    delete entry.client;
+    entry.client = NULL;
+  }
+  entry.host = "";
+}
+
+static void httpsPoolOpenEntry(HttpsPoolEntry& entry, const char* host) {
+  entry.host = host;
+  entry.client = new TlsResumeClient();
+  entry.client->setInsecure();
+  entry.http = new HTTPClient();
+  entry.http->setReuse(true);
+}
+
+// ============================================================
+// Lease: borrow a connection for one request
+// ============================================================
+class HttpsLease {
+public:
+  explicit HttpsLease(const char* host) : _slot(-1), _reused(false), _client(NULL), _http(NULL) {
+    httpsPoolLock();
+
+    // 1. Warm, idle connection to the same host
+    for (int i = 0; i < HTTPS_POOL_MAX_SOCKETS; i++) {
+      HttpsPoolEntry& e = httpsPool[i];
+      if (!e.inUse && e.client && e.host == host) {
+        _slot = i;
+        _reused = e.client->connected();
+        break;
+      }
+    }
+
+    // 2. Empty slot, or else the least recently used idle slot of another host
+    if (_slot < 0) {
+      int lru = -1;
+      for (int i = 0; i < HTTPS_POOL_MAX_SOCKETS; i++) {
+        HttpsPoolEntry& e = httpsPool[i];
+        if (e.inUse) continue;
+        if (!e.client) {
+          lru = i;
+          break;
+        }
+        if (lru < 0 || e.lastUsed < httpsPool[lru].lastUsed) lru = i;
+      }
+      if (lru >= 0) {
+        if (httpsPool[lru].client) {
+          httpsPoolCloseEntry(httpsPool[lru]);
+          httpsPoolStats.evictions++;
+        }
+        httpsPoolOpenEntry(httpsPool[lru], host);
+        _slot = lru;
+      }
+    }
+
+    if (_slot >= 0) {
+      httpsPool[_slot].inUse = true;
+      _client = httpsPool[_slot].client;
+      _http = httpsPool[_slot].http;
+      if (_reused) httpsPoolStats.reuses++;
+      else httpsPoolStats.misses++;
+    } else {
+      httpsPoolStats.overflows++;
+      httpsPoolStats.misses++;
+    }
+
+    httpsPoolUnlock();
+
+    if (_slot < 0) {
+      // All pooled sockets busy - one-off connection, closed on release
+      _client = new TlsResumeClient();
+      _client->setInsecure();
+      _http = new HTTPClient();
+    }
+  }
+
+  ~HttpsLease() {
+    if (_slot < 0) {
+      delete _http;
+      _client->stop();
+      delete _client;
+      return;
+    }
+
+    httpsPoolLock();
+    httpsPool[_slot].inUse = false;
+    httpsPool[_slot].lastUsed = millis();
+    httpsPoolUnlock();
+  }
+
+  WiFiClientSecure& client() { return *_client; }
+  HTTPClient& http() { return *_http; }
+  bool reused() const { return _reused; }
+
+private:
+  HttpsLease(const HttpsLease&);
+  HttpsLease& operator=(const HttpsLease&);
+
+  int _slot;
+  bool _reused;
+  WiFiClientSecure* _client;
+  HTTPClient* _http;
+};
+
+// ============================================================
+// Idle Eviction (call regularly from loop)
+// ============================================================
+void httpsPoolMaintain() {
+  static unsigned long lastCheck = 0;
+  if (millis() - lastCheck < HTTPS_POOL_MAINTAIN_MS) return;
+  lastCheck = millis();
+
+  httpsPoolLock();
+  for (int i = 0; i < HTTPS_POOL_MAX_SOCKETS; i++) {
+    HttpsPoolEntry& e = httpsPool[i];
+    if (e.inUse || !e.client) continue;
+
+    bool idle = (millis() - e.lastUsed) > HTTPS_POOL_IDLE_TIMEOUT;
+    if (idle || !e.client->connected()) {
+      httpsPoolCloseEntry(e);
+      httpsPoolStats.evictions++;
+    }
+  }
+  httpsPoolUnlock();
+}
+
+// Close all pooled connections (e.g. after WiFi loss)
+void httpsPoolFlush() {
+  httpsPoolLock();
+  for (int i = 0; i < HTTPS_POOL_MAX_SOCKETS; i++) {
+    if (!httpsPool[i].inUse && httpsPool[i].client) {
+      httpsPoolCloseEntry(httpsPool[i]);
+    }
+  }
+  httpsPoolUnlock();
+}
+
+// ============================================================
+// Pool Statistics
+// ============================================================
+void httpsPoolAddStatsJson(JsonObject obj) {
+  httpsPoolLock();
+  HttpsPoolStats stats = httpsPoolStats;
+  int open = 0;
+  for (int i = 0; i < HTTPS_POOL_MAX_SOCKETS; i++) {
+    if (httpsPool[i].client) open++;
+  }
+  httpsPoolUnlock();
+
+  uint32_t total = stats.reuses + stats.misses;
+  obj["reuses"] = stats.reuses;
+  obj["misses"] = stats.misses;
+  obj["overflows"] = stats.overflows;
+  obj["evictions"] = stats.evictions;
+  obj["open_sockets"] = open;
+  obj["max_sockets"] = HTTPS_POOL_MAX_SOCKETS;
+  obj["reuse_ratio"] = total > 0 ? (float)stats.reuses / total : 0.0f;
+}
+
+#endif // HTTPS_POOL_H
@@ -0,0 +1,224 @@
+/**
+ * @file led_pattern.h
+ * @brief Non-blocking status LED patterns on the LEDC peripheral
+ *
+ * The LED is driven by an LEDC PWM channel and stepped by a one-shot
+ * esp_timer, so callers never wait for a blink to finish. There is always
+ * a base pattern (idle, active, config mode, reset armed) and optionally
+ * one finite overlay (ack, error) that returns to the base when done.
+ *
+ * Usage:
+ *   ledPatternBegin();                 // once in setup
+ *   ledFlash(LED_PATTERN_ACK);         // returns immediately
+ *   ledSetBase(LED_PATTERN_ACTIVE);
+ */
+
+#ifndef LED_PATTERN_H
+#define LED_PATTERN_H
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "board_config.h"
+
+// ============================================================
+// Configuration
+// ============================================================
+#define LED_LEDC_MODE       LEDC_LOW_SPEED_MODE  // Available on every ESP32 variant
+#define LED_LEDC_TIMER      LEDC_TIMER_3         // Arduino ledcSetup() allocates from timer 0
+#define LED_LEDC_CHANNEL    LEDC_CHANNEL_7       // ... and from channel 0
+#define LED_LEDC_FREQ_HZ    5000
+#define LED_RAMP_TICK_MS    20                   // Update period while fading
+
+// ============================================================
+// Patterns
+// ============================================================
+enum LedPattern : uint8_t {
+  LED_PATTERN_OFF,
+  LED_PATTERN_IDLE,          // Solid on - system ready
+  LED_PATTERN_ACTIVE,        // Slow breathing - feeding mode active
+  LED_PATTERN_ACK,           // 3 short blinks - command accepted
+  LED_PATTERN_ERROR,         // 3 double blinks - command failed
+  LED_PATTERN_RESET_ARMED,   // Fast blink - factory reset armed / running
+  LED_PATTERN_CONFIG,        // Slow blink - WiFi config portal
+  LED_PATTERN_COUNT
+};
+
+struct LedStep {
+  uint8_t duty;     // Target brightness 0-255
+  uint16_t ms;      // Step length (0 = hold forever)
+  bool ramp;        // Fade linearly to duty instead of jumping
+};
+
+struct LedPatternDef {
+  const LedStep* steps;
+  uint8_t count;
+  uint8_t repeats;  // 0 = loop forever (base patterns)
+};
+
+static const LedStep ledStepsOff[]    = { {0, 0, false} };
+static const LedStep ledStepsIdle[]   = { {255, 0, false} };
+static const LedStep ledStepsActive[] = { {255, 1200, true}, {20, 1200, true} };
+static const LedStep ledStepsAck[]    = { {0, 100, false}, {255, 100, false} };
+static const LedStep ledStepsError[]  = { {255, 80, false}, {0, 80, false}, {255, 80, false}, {0, 400, false} };
+static const LedStep ledStepsReset[]  = { {255, 100, false}, {0, 100, false} };
+static const LedStep ledStepsConfig[] = { {255, 500, false}, {0, 500, false} };
+
+static const LedPatternDef ledPatterns[LED_PATTERN_COUNT] = {
+  { ledStepsOff,    1, 0 },
+  { ledStepsIdle,   1, 0 },
+  { ledStepsActive, 2, 0 },
+  { ledStepsAck,    2, 3 },
+  { ledStepsError,  4, 3 },
+  { ledStepsReset,  2, 0 },
+  { ledStepsConfig, 2, 0 },
+};
+
+// ============================================================
+// Engine State
+// ============================================================
+static LedPattern ledBase = LED_PATTERN_OFF;
+static LedPattern ledCurrent = LED_PATTERN_OFF;
+static uint8_t ledStep = 0;
+static uint8_t ledRepeatsLeft = 0;
+static uint8_t ledDuty = 0;          // Duty currently on the pin
+static uint8_t ledStepFromDuty = 0;  // Duty at the start of a ramp step
+static int64_t ledStepStartUs = 0;
+static int64_t ledDueUs = 0;         // When the pending timer callback is due
+static esp_timer_handle_t ledTimer = NULL;
+static SemaphoreHandle_t ledMutex = NULL;
+
+static void ledWriteDuty(uint8_t duty) {
+  ledDuty = duty;
+  ledc_set_duty(LED_LEDC_MODE, LED_LEDC_CHANNEL, duty);
+  ledc_update_duty(LED_LEDC_MODE, LED_LEDC_CHANNEL);
+}
+
+static void ledSchedule(uint32_t ms) {
+  esp_timer_stop(ledTimer);
+  ledDueUs = esp_timer_get_time() + (int64_t)ms * 1000;
+  esp_timer_start_once(ledTimer, (uint64_t)ms * 1000ULL);
+}
+
+// Enter the current step - caller holds ledMutex
+static void ledEnterStep() {
+  const LedStep& step = ledPatterns[ledCurrent].steps[ledStep];
+  ledStepStartUs = esp_timer_get_time();
+  ledStepFromDuty = ledDuty;
+
+  if (step.ms == 0) {
+    esp_timer_stop(ledTimer);
+    ledDueUs = INT64_MAX;  // Holding - any callback still in flight is stale
+    ledWriteDuty(step.duty);
+  } else if (step.ramp) {
+    ledSchedule(LED_RAMP_TICK_MS);
+  } else {
+    ledWriteDuty(step.duty);
+    ledSchedule(step.ms);
+  }
+}
+
+// Start a pattern from its first step - caller holds ledMutex
+static void ledStart(LedPattern pattern) {
+  ledCurrent = pattern;
+  ledStep = 0;
+  ledRepeatsLeft = ledPatterns[pattern].repeats;
+  ledEnterStep();
+}
+
+// esp_timer task: next ramp tick or next step
+static void ledTimerCb(void* arg) {
+  xSemaphoreTake(ledMutex, portMAX_DELAY);
+
+  // Pattern changed while this callback was waiting for the mutex
+  if (esp_timer_get_time() + 1000 < ledDueUs) {
+    xSemaphoreGive(ledMutex);
+    return;
+  }
+
+  const LedPatternDef& def = ledPatterns[ledCurrent];
+  const LedStep& step = def.steps[ledStep];
+
+  if (step.ramp) {
+    int64_t elapsedMs = (esp_timer_get_time() - ledStepStartUs) / 1000;
+    if (elapsedMs < step.ms) {
+      int32_t delta = (int32_t)step.duty - ledStepFromDuty;
+      ledWriteDuty(ledStepFromDuty + delta * elapsedMs / step.ms);
+      ledSchedule(LED_RAMP_TICK_MS);
+      xSemaphoreGive(ledMutex);
+      return;
+    }
+    ledWriteDuty(step.duty);
+  }
+
+  ledStep++;
+  if (ledStep >= def.count) {
+    ledStep = 0;
+    if (def.repeats > 0 && --ledRepeatsLeft == 0) {
+      ledStart(ledBase);  // Overlay finished
+      xSemaphoreGive(ledMutex);
+      return;
+    }
+  }
+  ledEnterStep();
+
+  xSemaphoreGive(ledMutex);
+}
+
+// ============================================================
+// Public API (any task)
+// ============================================================
+void ledPatternBegin() {
+  if (LED_PIN < 0 || ledTimer) return;
+
+  ledc_timer_config_t timer = {};
+  timer.speed_mode = LED_LEDC_MODE;
+  timer.duty_resolution = LEDC_TIMER_8_BIT;
+  timer.timer_num = LED_LEDC_TIMER;
+  timer.freq_hz = LED_LEDC_FREQ_HZ;
+  timer.clk_cfg = LEDC_AUTO_CLK;
+
+  ledc_channel_config_t channel = {};
+  channel.gpio_num = LED_PIN;
+  channel.speed_mode = LED_LEDC_MODE;
+  channel.channel = LED_LEDC_CHANNEL;
+  channel.timer_sel = LED_LEDC_TIMER;
+  channel.duty = 0;
+
+  if (ledc_timer_config(&timer) != ESP_OK || ledc_channel_config(&channel) != ESP_OK) {
+    Serial.println("✗ LED: LEDC setup failed");
+    return;
+  }
+
+  esp_timer_create_args_t args = {};
+  args.callback = ledTimerCb;
+  args.name = "led_pattern";
+  if (esp_timer_create(&args, &ledTimer) != ESP_OK) {
+    Serial.println("✗ LED: timer setup failed");
+    return;
+  }
+  ledMutex = xSemaphoreCreateMutex();
+}
+
+// Background pattern - shown now, or after the running overlay finishes
+void ledSetBase(LedPattern pattern) {
+  if (!ledMutex) return;
+  xSemaphoreTake(ledMutex, portMAX_DELAY);
+  ledBase = pattern;
+  if (ledPatterns[ledCurrent].repeats == 0 && ledCurrent != pattern) {
+    ledStart(pattern);
+  }
+  xSemaphoreGive(ledMutex);
+}
+
+// Finite overlay (ack, error) - returns to the base pattern when done
+void ledFlash(LedPattern pattern) {
+  if (!ledMutex) return;
+  xSemaphoreTake(ledMutex, portMAX_DELAY);
+  ledStart(pattern);
+  xSemaphoreGive(ledMutex);
+}
+
+#endif // LED_PATTERN_H
@@ -12,6 +12,7 @@
 #include <Preferences.h>
 #include "board_config.h"
 #include "version.h"
+#include "feeding_task.h"
 
 // Include device settings UI for large display
 #ifdef BOARD_ESP32_4848S040
@@ -22,8 +23,6 @@
 extern bool feedingModeActive;
 extern bool ENABLE_redsea;
 extern bool ENABLE_TUNZE;
-extern void startFeedingMode();
-extern void stopFeedingMode();
 lv_obj_t* getMainScreen();
 
 // Tasmota getters (defined in tasmota_api.h)
@@ -291,11 +290,8 @@ static void start_btn_cb(lv_event_t *e) {
     return;
   }
   
-  if (feedingModeActive) {
-    stopFeedingMode();
-  } else {
-    startFeedingMode();
-  }
+  // Runs on the feeding worker task - UI refreshes when the state changes
+  feedingEnqueue(feedingModeActive ? FEED_CMD_STOP : FEED_CMD_START);
 }
 
 static void show_control_section() {
@@ -650,10 +646,15 @@ static void show_device_section() {
   lv_obj_set_style_text_color(heap_lbl, MENU_TEXT_DIM, 0);
   
   // Current Time
-  struct tm timeinfo;
-  getLocalTime(&timeinfo);
+  extern volatile bool timeSynced;
   char time_text[32];
-  strftime(time_text, sizeof(time_text), "Zeit: %H:%M:%S", &timeinfo);
+  if (timeSynced) {
+    struct tm timeinfo;
+    getLocalTime(&timeinfo, 0);
+    strftime(time_text, sizeof(time_text), "Zeit: %H:%M:%S", &timeinfo);
+  } else {
+    snprintf(time_text, sizeof(time_text), "Zeit: wird synchronisiert...");
+  }
   lv_obj_t *time_lbl = lv_label_create(info_card);
   lv_label_set_text(time_lbl, time_text);
   lv_obj_set_style_text_font(time_lbl, detail_font, 0);
@@ -793,8 +794,7 @@ static void reset_msgbox_cb(lv_event_t *e) {
     prefs.clear();
     prefs.end();
     WiFi.disconnect(false);
-    delay(100);
-    ESP.restart();
+    scheduleRestart(100);  // From the main loop (settings_ui.h)
   }
   
   lv_msgbox_close(reset_msgbox);
@@ -0,0 +1,294 @@
+/**
+ * @file net_bench.h
+ * @brief On-device latency benchmarks against a stand-in server on the LAN
+ *
+ * Compares a request on a fresh connection with one on a reused
+ * connection, talking to a local stand-in instead of the cloud so the
+ * numbers are repeatable. test/bench/bench.py starts the stand-in and
+ * drives the benchmark:
+ *
+ *   POST /api/bench?kind=<kind>&host=<ip>&port=<port>&n=<count>  -> 202
+ *   GET  /api/bench                                               -> last result
+ *
+ * kind=https runs three series against the same URL:
+ *   cold     new WiFiClientSecure per request (full TLS handshake)
+ *   resumed  new TlsResumeClient per request (abbreviated handshake)
+ *   pooled   HttpsLease per request (warm keep-alive connection)
+ *
+ * kind=tasmota sends "Power" to a fake Tasmota plug over plain HTTP:
+ *   cold     new WiFiClient per request (TCP handshake every time)
+ *   warm     TasmotaConnLease per request (cached keep-alive connection)
+ *
+ * The benchmark runs in its own task, never in the web handler.
+ *
+ * Only compiled with -D NET_BENCH (pio run -e esp32s3_bench): release
+ * builds have neither this code nor the unauthenticated /api/bench.
+ */
+
+#ifndef NET_BENCH_H
+#define NET_BENCH_H
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "https_pool.h"
+#include "tls_session.h"
+#include "tasmota_api.h"
+
+// ============================================================
+// Configuration
+// ============================================================
+#define NET_BENCH_MAX_REQUESTS    100     // Per series
+#define NET_BENCH_TIMEOUT         5000    // Connect / read timeout (ms)
+#define NET_BENCH_TASK_STACK      12288   // TLS handshakes need a large stack
+#define NET_BENCH_TASK_PRIORITY   1       // Below the feeding workers
+#define NET_BENCH_TASK_CORE       0       // Same core as the WiFi stack
+
+// ============================================================
+// Benchmark State
+// ============================================================
+enum NetBenchKind : uint8_t {
+  NET_BENCH_HTTPS,
+  NET_BENCH_TASMOTA,
+  NET_BENCH_UNKNOWN
+};
+
+struct NetBenchParams {
+  NetBenchKind kind;
+  String host;
+  uint16_t port;
+  uint16_t count;
+};
+
+struct NetBenchSeries {
+  uint16_t ok;
+  uint16_t failed;
+  uint32_t totalMs;   // Successful requests only
+  uint32_t minMs;
+  uint32_t maxMs;
+};
+
+static volatile bool netBenchRunning = false;
+static portMUX_TYPE netBenchMux = portMUX_INITIALIZER_UNLOCKED;
+static SemaphoreHandle_t netBenchMutex = NULL;  // Guards netBenchResult
+static String netBenchResult;
+
+static const char* netBenchKindName(NetBenchKind kind) {
+  switch (kind) {
+    case NET_BENCH_HTTPS: return "https";
+    case NET_BENCH_TASMOTA: return "tasmota";
+    default:              return "unknown";
+  }
+}
+
+NetBenchKind netBenchKindFromName(const String& name) {
+  if (name == "https") return NET_BENCH_HTTPS;
+  if (name == "tasmota") return NET_BENCH_TASMOTA;
+  return NET_BENCH_UNKNOWN;
+}
+
+static void netBenchRecord(NetBenchSeries& s, bool ok, uint32_t ms) {
+  if (!ok) {
+    s.failed++;
+    return;
+  }
+  if (s.ok == 0 || ms < s.minMs) s.minMs = ms;
+  if (ms > s.maxMs) s.maxMs = ms;
+  s.ok++;
+  s.totalMs += ms;
+}
+
+static void netBenchAddSeries(JsonObject obj, const NetBenchSeries& s) {
+  obj["ok"] = s.ok;
+  obj["failed"] = s.failed;
+  obj["avg_ms"] = s.ok > 0 ? (float)s.totalMs / s.ok : 0.0f;
+  obj["min_ms"] = s.minMs;
+  obj["max_ms"] = s.maxMs;
+}
+
+// One GET with the body read - true on HTTP 200
+static bool netBenchGet(HTTPClient& http, WiFiClient& client, const String& url) {
+  http.begin(client, url);
+  http.setTimeout(NET_BENCH_TIMEOUT);
+  http.setConnectTimeout(NET_BENCH_TIMEOUT);
+  int httpCode = http.GET();
+  if (httpCode == HTTP_CODE_OK) http.getString();
+  http.end();
+  return httpCode == HTTP_CODE_OK;
+}
+
+// ============================================================
+// HTTPS: cold vs. resumed vs. pooled
+// ============================================================
+static void netBenchHttps(const NetBenchParams& p, JsonDocument& doc) {
+  String url = "https://" + p.host + ":" + String(p.port) + "/bench";
+  NetBenchSeries cold = {}, resumed = {}, pooled = {};
+
+  for (uint16_t i = 0; i < p.count; i++) {
+    WiFiClientSecure client;
+    client.setInsecure();
+    HTTPClient http;
+    unsigned long start = millis();
+    netBenchRecord(cold, netBenchGet(http, client, url), millis() - start);
+  }
+
+  for (uint16_t i = 0; i < p.count; i++) {
+    TlsResumeClient client;
+    client.setInsecure();
+    HTTPClient http;
+    unsigned long start = millis();
+    netBenchRecord(resumed, netBenchGet(http, client, url), millis() - start);
+  }
+
+  httpsPoolLock();
+  HttpsPoolStats before = httpsPoolStats;
+  httpsPoolUnlock();
+
+  for (uint16_t i = 0; i < p.count; i++) {
+    unsigned long start = millis();
+    HttpsLease lease(p.host.c_str());
+    netBenchRecord(pooled, netBenchGet(lease.http(), lease.client(), url), millis() - start);
+  }
+
+  httpsPoolLock();
+  uint32_t reuses = httpsPoolStats.reuses - before.reuses;
+  uint32_t misses = httpsPoolStats.misses - before.misses;
+  httpsPoolUnlock();
+  httpsPoolFlush();  // Do not keep a pool slot for the stand-in
+
+  netBenchAddSeries(doc["cold"].to<JsonObject>(), cold);
+  netBenchAddSeries(doc["resumed"].to<JsonObject>(), resumed);
+  netBenchAddSeries(doc["pooled"].to<JsonObject>(), pooled);
+  doc["pool_reuse_ratio"] = (reuses + misses) > 0 ? (float)reuses / (reuses + misses) : 0.0f;
+  if (cold.ok > 0 && pooled.ok > 0 && pooled.totalMs > 0) {
+    doc["speedup"] = ((float)cold.totalMs / cold.ok) / ((float)pooled.totalMs / pooled.ok);
+  }
+}
+
+// ============================================================
+// Tasmota: cold vs. warm (TasmotaConnLease)
+// ============================================================
+static void netBenchTasmota(const NetBenchParams& p, JsonDocument& doc) {
+  String url = "http://" + p.host + ":" + String(p.port) + "/cm?cmnd=Power";
+  NetBenchSeries cold = {}, warm = {};
+
+  for (uint16_t i = 0; i < p.count; i++) {
+    WiFiClient client;
+    HTTPClient http;
+    http.setReuse(false);
+    unsigned long start = millis();
+    netBenchRecord(cold, netBenchGet(http, client, url), millis() - start);
+  }
+
+  TasmotaConnStats before = tasmotaConnGetStats();
+
+  for (uint16_t i = 0; i < p.count; i++) {
+    unsigned long start = millis();
+    TasmotaConnLease lease(p.host);
+    netBenchRecord(warm, netBenchGet(lease.http(), lease.client(), url), millis() - start);
+  }
+
+  TasmotaConnStats after = tasmotaConnGetStats();
+  tasmotaConnFlush();  // Do not keep a cache slot for the stand-in
+
+  uint32_t reuses = after.reuses - before.reuses;
+  uint32_t misses = after.misses - before.misses;
+  netBenchAddSeries(doc["cold"].to<JsonObject>(), cold);
+  netBenchAddSeries(doc["warm"].to<JsonObject>(), warm);
+  doc["reuses"] = reuses;
+  doc["misses"] = misses;
+  doc["reuse_ratio"] = (reuses + misses) > 0 ? (float)reuses / (reuses + misses) : 0.0f;
+  if (cold.ok > 0 && warm.ok > 0 && warm.totalMs > 0) {
+    doc["speedup"] = ((float)cold.totalMs / cold.ok) / ((float)warm.totalMs / warm.ok);
+  }
+}
+
+// ============================================================
+// Benchmark Task
+// ============================================================
+static void netBenchTask(void* parameter) {
+  NetBenchParams* p = (NetBenchParams*)parameter;
+
+  Serial.printf("[BENCH] %s against %s:%u, %u requests per series\n",
+                netBenchKindName(p->kind), p->host.c_str(), p->port, p->count);
+
+  JsonDocument doc;
+  doc["running"] = false;
+  doc["kind"] = netBenchKindName(p->kind);
+  doc["host"] = p->host;
+  doc["port"] = p->port;
+  doc["n"] = p->count;
+
+  unsigned long start = millis();
+  if (p->kind == NET_BENCH_TASMOTA) {
+    netBenchTasmota(*p, doc);
+  } else {
+    netBenchHttps(*p, doc);
+  }
+  doc["elapsed_ms"] = millis() - start;
+
+  String json;
+  serializeJson(doc, json);
+  Serial.printf("[BENCH] %s\n", json.c_str());
+
+  xSemaphoreTake(netBenchMutex, portMAX_DELAY);
+  netBenchResult = json;
+  xSemaphoreGive(netBenchMutex);
+
+  delete p;
+  netBenchRunning = false;
+  vTaskDelete(NULL);
+}
+
+// Start a benchmark in the background - false if one is already running
+bool netBenchStart(NetBenchKind kind, const String& host, uint16_t port, uint16_t count) {
+  if (kind == NET_BENCH_UNKNOWN || host.isEmpty() || port == 0) return false;
+
+  portENTER_CRITICAL(&netBenchMux);
+  bool busy = netBenchRunning;
+  netBenchRunning = true;
+  portEXIT_CRITICAL(&netBenchMux);
+  if (busy) return false;
+
+  if (!netBenchMutex) netBenchMutex = xSemaphoreCreateMutex();
+
+  NetBenchParams* p = new NetBenchParams();
+  p->kind = kind;
+  p->host = host;
+  p->port = port;
+  p->count = constrain(count, 1, NET_BENCH_MAX_REQUESTS);
+
+  BaseType_t created = xTaskCreatePinnedToCore(
+    netBenchTask,             // Task function
+    "net_bench",              // Name
+    NET_BENCH_TASK_STACK,     // Stack size
+    p,                        // Parameters
+    NET_BENCH_TASK_PRIORITY,  // Priority
+    NULL,                     // Task handle
+    NET_BENCH_TASK_CORE       // Core
+  );
+
+  if (created != pdPASS) {
+    delete p;
+    netBenchRunning = false;
+    return false;
+  }
+  return true;
+}
+
+// Last result as JSON, {"running":true} while a benchmark is in progress
+String netBenchGetJson() {
+  if (netBenchRunning) return "{\"running\":true}";
+  if (!netBenchMutex) return "{\"running\":false}";
+
+  xSemaphoreTake(netBenchMutex, portMAX_DELAY);
+  String json = netBenchResult.isEmpty() ? "{\"running\":false}" : netBenchResult;
+  xSemaphoreGive(netBenchMutex);
+  return json;
+}
+
+#endif // NET_BENCH_H
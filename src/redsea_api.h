@@ -5,41 +5,210 @@
 #include <HTTPClient.h>
 #include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
+#include <Preferences.h>
+#include <limits.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 #include "config.h"
+#include "crypto.h"
+#include "https_pool.h"
+#include "cloud_listing.h"
 
 // External references
 extern String redsea_USERNAME;
 extern String redsea_PASSWORD;
 extern String redsea_AQUARIUM_ID;
 extern String redseaToken;
+extern bool ENABLE_redsea;
+extern Preferences preferences;
 
-bool redseaLogin() {
+// ============================================================
+// OAuth Token Manager
+// ============================================================
+// The access token, its expiry and the refresh token (if the API sends
+// one) are kept in RAM and persisted encrypted in Preferences, so a
+// reboot does not force a login. A background task renews the token
+// before it expires - feeding commands normally find a valid token and
+// never wait for an OAuth round trip.
+//
+// The token lock only guards the fields, never a request: one login at a
+// time runs under redseaLoginMutex. After a failed login the background
+// task backs off exponentially; credentials the API rejected are not
+// retried in the background until they change.
+
+#define REDSEA_TOKEN_REFRESH_MARGIN  300    // Renew 5 min before expiry (s)
+#define REDSEA_TOKEN_DEFAULT_TTL     3600   // If the API omits expires_in (s)
+#define REDSEA_BG_INTERVAL           10000  // Background check interval (ms)
+#define REDSEA_BG_STACK              10240  // TLS handshake needs a large stack
+#define REDSEA_BG_PRIORITY           1
+#define REDSEA_BG_CORE               0
+#define REDSEA_AUTH_BACKOFF_BASE     30000    // First background retry after a failed login (ms)
+#define REDSEA_AUTH_BACKOFF_MAX      1800000  // Then at most every 30 min
+
+static String redseaRefreshToken = "";
+static time_t redseaTokenExpiresAt = 0;           // Epoch seconds, 0 = unknown
+static unsigned long redseaTokenObtainedMs = 0;   // millis() if received this boot
+static uint32_t redseaTokenTtl = 0;               // expires_in of that token
+static SemaphoreHandle_t redseaTokenMutex = NULL; // Token fields only - never held across I/O
+static SemaphoreHandle_t redseaLoginMutex = NULL; // One token request at a time
+static TaskHandle_t redseaBgTaskHandle = NULL;
+static uint32_t redseaCredentialsGen = 0;         // Bumped by redseaClearToken()
+
+// Login backoff (under the token lock)
+static uint8_t redseaAuthFailures = 0;
+static unsigned long redseaAuthRetryAt = 0;       // millis() of the next background attempt
+static uint32_t redseaRejectedCredentials = 0;    // Hash of credentials the API rejected, 0 = none
+
+enum RedseaTokenResult : uint8_t {
+  REDSEA_TOKEN_OK = 0,
+  REDSEA_TOKEN_FAILED,      // Network or server error - retry later
+  REDSEA_TOKEN_REJECTED     // Credentials or refresh token refused
+};
+
+static void redseaTokenLock() {
+  xSemaphoreTake(redseaTokenMutex, portMAX_DELAY);
+}
+
+static void redseaTokenUnlock() {
+  xSemaphoreGive(redseaTokenMutex);
+}
+
+static void redseaTokenInit() {
+  if (!redseaTokenMutex) redseaTokenMutex = xSemaphoreCreateMutex();
+  if (!redseaLoginMutex) redseaLoginMutex = xSemaphoreCreateMutex();
+}
+
+static bool redseaClockValid() {
+  return time(nullptr) > 1700000000;  // NTP synced
+}
+
+// Seconds until the access token expires. -1 without a token,
+// LONG_MAX if the expiry is unknown (trust the token until a 401).
+long redseaTokenSecondsLeft() {
+  if (redseaToken.isEmpty()) return -1;
+  if (redseaTokenObtainedMs != 0) {
+    return (long)redseaTokenTtl - (long)((millis() - redseaTokenObtainedMs) / 1000);
+  }
+  if (redseaTokenExpiresAt != 0 && redseaClockValid()) {
+    return (long)(redseaTokenExpiresAt - time(nullptr));
+  }
+  return LONG_MAX;
+}
+
+static void redseaSaveToken() {
+  preferences.putString("rs_token", encryptString(redseaToken));
+  preferences.putString("rs_refresh", encryptString(redseaRefreshToken));
+  preferences.putULong("rs_token_exp", (uint32_t)redseaTokenExpiresAt);
+}
+
+// Restore the persisted token - call from setup() after loadCredentials()
+void redseaLoadToken() {
+  redseaTokenInit();
+
+  redseaToken = decryptString(preferences.getString("rs_token", ""));
+  redseaRefreshToken = decryptString(preferences.getString("rs_refresh", ""));
+  redseaTokenExpiresAt = (time_t)preferences.getULong("rs_token_exp", 0);
+  redseaTokenObtainedMs = 0;
+
+  if (!redseaToken.isEmpty()) {
+    Serial.println("✓ Red Sea OAuth token restored from flash");
+  }
+}
+
+// Drop the access token but keep the refresh token (e.g. after HTTP 401)
+void redseaInvalidateAccessToken() {
+  redseaTokenLock();
+  redseaToken = "";
+  redseaTokenExpiresAt = 0;
+  redseaTokenObtainedMs = 0;
+  redseaTokenUnlock();
+}
+
+// Credentials changed or factory reset - forget all tokens, also in
+// flash. A login still in flight was made with the old credentials and
+// discards its token (redseaCredentialsGen).
+void redseaClearToken() {
+  redseaTokenLock();
+  redseaCredentialsGen++;
+  redseaToken = "";
+  redseaRefreshToken = "";
+  redseaTokenExpiresAt = 0;
+  redseaTokenObtainedMs = 0;
+  redseaAuthFailures = 0;
+  redseaRejectedCredentials = 0;
+  preferences.remove("rs_token");
+  preferences.remove("rs_refresh");
+  preferences.remove("rs_token_exp");
+  redseaTokenUnlock();
+}
+
+// FNV-1a of the credentials - remembers rejected ones without a copy
+static uint32_t redseaCredentialsHash() {
+  uint32_t hash = 2166136261u;
+  const String* parts[] = { &redsea_USERNAME, &redsea_PASSWORD };
+  for (int p = 0; p < 2; p++) {
+    const char* c = parts[p]->c_str();
+    while (*c) hash = (hash ^ (uint8_t)*c++) * 16777619u;
+    hash = (hash ^ 0xFF) * 16777619u;  // Separator
+  }
+  return hash | 1;  // Never 0
+}
+
+// Background login allowed? - caller must hold the token lock
+static bool redseaAuthAllowed(uint32_t credentials) {
+  if (redseaRejectedCredentials != 0) {
+    if (redseaRejectedCredentials == credentials) return false;  // Until they change
+    redseaRejectedCredentials = 0;
+    redseaAuthFailures = 0;
+  }
+  return redseaAuthFailures == 0 || (long)(millis() - redseaAuthRetryAt) >= 0;
+}
+
+// Outcome of a login - caller must hold the token lock
+static void redseaAuthRecord(RedseaTokenResult result, uint32_t credentials) {
+  if (result == REDSEA_TOKEN_OK) {
+    redseaAuthFailures = 0;
+    redseaRejectedCredentials = 0;
+  } else if (result == REDSEA_TOKEN_REJECTED) {
+    redseaRejectedCredentials = credentials;
+    Serial.println("✗ Red Sea login rejected - no background login until the credentials change");
+  } else {
+    if (redseaAuthFailures < 255) redseaAuthFailures++;
+    unsigned long backoff = (unsigned long)REDSEA_AUTH_BACKOFF_BASE << min((int)redseaAuthFailures - 1, 6);
+    if (backoff > REDSEA_AUTH_BACKOFF_MAX) backoff = REDSEA_AUTH_BACKOFF_MAX;
+    redseaAuthRetryAt = millis() + backoff;
+    Serial.printf("⚠ Red Sea login failed - next background attempt in %lu s\n", backoff / 1000);
+  }
+}
+
+// Copy of the current access token for an Authorization header
+static String redseaBearer() {
+  redseaTokenLock();
+  String bearer = "Bearer " + redseaToken;
+  redseaTokenUnlock();
+  return bearer;
+}
+
+// POST to /oauth/token and store the result unless the credentials
+// changed meanwhile (`gen`). Runs without the token lock.
+static RedseaTokenResult redseaTokenRequest(const String& postData, uint32_t gen) {
   if (WiFi.status() != WL_CONNECTED) {
     Serial.println("WiFi not connected!");
-    return false;
+    return REDSEA_TOKEN_FAILED;
   }
   
-  WiFiClientSecure client;
-  client.setInsecure();
-  
-  HTTPClient http;
+  HttpsLease lease(redsea_API_HOST);
+  HTTPClient& http = lease.http();
   String tokenUrl = String(redsea_API_BASE) + "/oauth/token";
   
-  http.begin(client, tokenUrl);
+  http.begin(lease.client(), tokenUrl);
   http.setTimeout(10000);  // 10s timeout
   http.setConnectTimeout(5000);  // 5s connect timeout
   http.addHeader("Content-Type", "application/x-www-form-urlencoded");
   http.addHeader("Authorization", redsea_CLIENT_AUTH);
   
-  String postData = "grant_type=password&username=";
-  postData += redsea_USERNAME;
-  postData += "&password=";
-  String encodedPassword = redsea_PASSWORD;
-  encodedPassword.replace("&", "%26");
-  encodedPassword.replace("#", "%23");
-  postData += encodedPassword;
-  
-  Serial.println("Requesting OAuth token...");
   int httpCode = http.POST(postData);
   
   if (httpCode == 200) {
@@ -47,14 +216,34 @@ bool redseaLogin() {
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, payload);
     
-    if (!error) {
-      redseaToken = doc["access_token"].as<String>();
-      Serial.println("✓ OAuth token received");
+    if (!error && doc["access_token"].is<const char*>()) {
+      uint32_t ttl = doc["expires_in"] | REDSEA_TOKEN_DEFAULT_TTL;
+      
       http.end();
-      return true;
+      
+      redseaTokenLock();
+      bool current = gen == redseaCredentialsGen;
+      if (current) {
+        redseaToken = doc["access_token"].as<String>();
+        if (doc["refresh_token"].is<const char*>()) {
+          redseaRefreshToken = doc["refresh_token"].as<String>();
+        }
+        redseaTokenTtl = ttl;
+        redseaTokenObtainedMs = millis();
+        redseaTokenExpiresAt = redseaClockValid() ? time(nullptr) + ttl : 0;
+        redseaSaveToken();
+      }
+      redseaTokenUnlock();
+      
+      if (!current) {
+        Serial.println("⊘ OAuth token discarded - credentials changed during login");
+        return REDSEA_TOKEN_FAILED;
+      }
+      Serial.printf("✓ OAuth token received (valid for %lu s)\n", (unsigned long)ttl);
+      return REDSEA_TOKEN_OK;
     } else {
       Serial.print("✗ JSON parsing failed: ");
-      Serial.println(error.c_str());
+      Serial.println(error ? error.c_str() : "no access_token");
     }
   } else {
     Serial.print("✗ HTTP request failed with code: ");
@@ -63,71 +252,262 @@ bool redseaLogin() {
   }
   
   http.end();
-  return false;
+  // 400 invalid_grant / 401: the credentials or the refresh token were refused
+  return httpCode == 400 || httpCode == 401 ? REDSEA_TOKEN_REJECTED : REDSEA_TOKEN_FAILED;
 }
 
-bool redseaCheckFeedingStatus() {
-  if (redseaToken.isEmpty()) {
-    Serial.println("No OAuth token - logging in first...");
-    if (!redseaLogin()) return false;
+static RedseaTokenResult redseaPasswordLogin(uint32_t gen) {
+  String postData = "grant_type=password&username=";
+  postData += redsea_USERNAME;
+  postData += "&password=";
+  String encodedPassword = redsea_PASSWORD;
+  encodedPassword.replace("&", "%26");
+  encodedPassword.replace("#", "%23");
+  postData += encodedPassword;
+  
+  Serial.println("Requesting OAuth token...");
+  return redseaTokenRequest(postData, gen);
+}
+
+static RedseaTokenResult redseaRefreshAccessToken(const String& refreshToken, uint32_t gen) {
+  Serial.println("Refreshing OAuth token...");
+  String postData = "grant_type=refresh_token&refresh_token=" + refreshToken;
+  RedseaTokenResult result = redseaTokenRequest(postData, gen);
+  
+  if (result == REDSEA_TOKEN_REJECTED) {
+    // Refresh token revoked or expired - next attempt uses the password
+    redseaTokenLock();
+    if (redseaRefreshToken == refreshToken) redseaRefreshToken = "";
+    redseaTokenUnlock();
   }
+  return result;
+}
+
+// Make sure a token valid for at least marginSec is available. Uses the
+// refresh token if possible and falls back to a password login. The
+// background task passes `background`: it honours the login backoff.
+static bool redseaEnsureTokenEx(long marginSec, bool background) {
+  redseaTokenLock();
+  bool ok = redseaTokenSecondsLeft() > marginSec;
+  redseaTokenUnlock();
+  if (ok) return true;
   
-  WiFiClientSecure client;
-  client.setInsecure();
+  // One login at a time - a waiting caller then finds the new token
+  xSemaphoreTake(redseaLoginMutex, portMAX_DELAY);
+  uint32_t credentials = redseaCredentialsHash();
+  redseaTokenLock();
+  ok = redseaTokenSecondsLeft() > marginSec;
+  bool allowed = !background || redseaAuthAllowed(credentials);
+  bool noToken = redseaToken.isEmpty();
+  String refreshToken = redseaRefreshToken;
+  uint32_t gen = redseaCredentialsGen;
+  redseaTokenUnlock();
   
-  HTTPClient http;
+  if (!ok && allowed) {
+    if (noToken) {
+      Serial.println("No OAuth token - logging in first...");
+    }
+    RedseaTokenResult result = REDSEA_TOKEN_FAILED;
+    if (!refreshToken.isEmpty()) result = redseaRefreshAccessToken(refreshToken, gen);
+    if (result != REDSEA_TOKEN_OK) result = redseaPasswordLogin(gen);
+    
+    redseaTokenLock();
+    if (gen == redseaCredentialsGen) redseaAuthRecord(result, credentials);
+    redseaTokenUnlock();
+    ok = result == REDSEA_TOKEN_OK;
+  }
+  xSemaphoreGive(redseaLoginMutex);
+  return ok;
+}
+
+bool redseaEnsureToken(long marginSec = 0) {
+  return redseaEnsureTokenEx(marginSec, false);
+}
+
+bool redseaLogin() {
+  xSemaphoreTake(redseaLoginMutex, portMAX_DELAY);
+  redseaTokenLock();
+  uint32_t gen = redseaCredentialsGen;
+  redseaTokenUnlock();
+  bool ok = redseaPasswordLogin(gen) == REDSEA_TOKEN_OK;
+  xSemaphoreGive(redseaLoginMutex);
+  return ok;
+}
+
+// Run one API request; on HTTP 401 invalidate the token and retry once
+template <typename T, typename Fn>
+static T redseaWithReauth(Fn once, T failure) {
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (!redseaEnsureToken()) return failure;
+    bool authRejected = false;
+    T result = once(authRejected);
+    if (!authRejected) return result;
+    Serial.println("✗ Token expired - re-authenticating...");
+    redseaInvalidateAccessToken();
+  }
+  return failure;
+}
+
+// ============================================================
+// Cached Cloud Feeding State
+// ============================================================
+// The background task keeps the feeding state of the aquarium fresh with
+// a conditional GET (If-None-Match / If-Modified-Since). Toggle decisions
+// and /api/status read this cache instead of doing an HTTPS round trip.
+// Start/stop commands bump redseaStatusGen; a refresh that started before
+// the last command is dropped, it may have read the state before it.
+
+#define REDSEA_STATUS_REFRESH  30000  // Refresh interval of the cached state (ms)
+#define REDSEA_STATUS_TTL      90000  // Older cached state is not trusted (ms)
+
+static bool redseaCloudFeeding = false;
+static unsigned long redseaCloudCheckedAt = 0;      // millis() of last confirmation, 0 = never
+static String redseaStatusETag = "";
+static String redseaStatusLastModified = "";
+static String redseaStatusAquarium = "";            // Aquarium the validators belong to
+static SemaphoreHandle_t redseaStatusMutex = NULL;  // Serialises refreshes
+static portMUX_TYPE redseaStatusMux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t redseaStatusGen = 0;                // Bumped by every start/stop command
+static uint32_t redseaRefreshGen = 0;               // redseaStatusGen when the refresh started
+
+static uint32_t redseaStatusGeneration() {
+  portENTER_CRITICAL(&redseaStatusMux);
+  uint32_t gen = redseaStatusGen;
+  portEXIT_CRITICAL(&redseaStatusMux);
+  return gen;
+}
+
+// Start/stop command sent or answered - refreshes in flight are stale
+static void redseaStatusBump() {
+  portENTER_CRITICAL(&redseaStatusMux);
+  redseaStatusGen++;
+  portEXIT_CRITICAL(&redseaStatusMux);
+}
+
+// Result of a refresh - dropped if a command ran since it started
+static bool redseaSetRefreshedFeeding(bool active) {
+  portENTER_CRITICAL(&redseaStatusMux);
+  bool current = redseaStatusGen == redseaRefreshGen;
+  if (current) {
+    redseaCloudFeeding = active;
+    redseaCloudCheckedAt = millis() | 1;  // Never 0
+  }
+  portEXIT_CRITICAL(&redseaStatusMux);
+  return current;
+}
+
+// Command result: the cache follows the command and refreshes that
+// started before it are dropped
+static void redseaCommandFeeding(bool active) {
+  portENTER_CRITICAL(&redseaStatusMux);
+  redseaStatusGen++;
+  redseaCloudFeeding = active;
+  redseaCloudCheckedAt = millis() | 1;
+  portEXIT_CRITICAL(&redseaStatusMux);
+}
+
+// 1 = feeding active, 0 = inactive, -1 = unknown or older than maxAgeMs
+int redseaCachedFeedingStatus(unsigned long maxAgeMs = REDSEA_STATUS_TTL) {
+  portENTER_CRITICAL(&redseaStatusMux);
+  unsigned long checkedAt = redseaCloudCheckedAt;
+  bool active = redseaCloudFeeding;
+  portEXIT_CRITICAL(&redseaStatusMux);
+  
+  if (checkedAt == 0 || millis() - checkedAt > maxAgeMs) return -1;
+  return active ? 1 : 0;
+}
+
+static bool redseaRefreshFeedingStatusOnce(bool& authRejected) {
+  HttpsLease lease(redsea_API_HOST);
+  HTTPClient& http = lease.http();
   String statusUrl = String(redsea_API_BASE) + "/aquarium/" + redsea_AQUARIUM_ID;
   
-  http.begin(client, statusUrl);
+  http.begin(lease.client(), statusUrl);
   http.setTimeout(8000);  // 8s timeout
   http.setConnectTimeout(4000);  // 4s connect timeout
-  http.addHeader("Authorization", "Bearer " + redseaToken);
+  http.addHeader("Authorization", redseaBearer());
+  if (!redseaStatusETag.isEmpty()) http.addHeader("If-None-Match", redseaStatusETag);
+  if (!redseaStatusLastModified.isEmpty()) http.addHeader("If-Modified-Since", redseaStatusLastModified);
+  
+  const char* headerKeys[] = {"ETag", "Last-Modified"};
+  http.collectHeaders(headerKeys, 2);
   
-  Serial.println("Checking current feeding status...");
   int httpCode = http.GET();
   
-  if (httpCode == 200) {
+  if (httpCode == 304) {
+    // Unchanged - just confirm the cached state
+    redseaSetRefreshedFeeding(redseaCachedFeedingStatus(ULONG_MAX) == 1);
+    http.end();
+    return true;
+  } else if (httpCode == 200) {
     String payload = http.getString();
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, payload);
     
     if (!error) {
       bool isActive = doc["properties"]["feeding"] | false;
-      Serial.print("✓ Cloud status: Feeding mode is ");
-      Serial.println(isActive ? "ACTIVE" : "INACTIVE");
+      bool changed = isActive != (redseaCachedFeedingStatus(ULONG_MAX) == 1);
+      if (redseaSetRefreshedFeeding(isActive)) {
+        if (changed) {
+          Serial.print("✓ Cloud status: Feeding mode is ");
+          Serial.println(isActive ? "ACTIVE" : "INACTIVE");
+        }
+        redseaStatusETag = http.header("ETag");
+        redseaStatusLastModified = http.header("Last-Modified");
+      } else {
+        // Read before the last start/stop - the next refresh fetches it again
+        Serial.println("⊘ Cloud status dropped - a feeding command ran meanwhile");
+        redseaStatusETag = "";
+        redseaStatusLastModified = "";
+      }
       http.end();
-      return isActive;
+      return true;
     } else {
       Serial.print("✗ JSON parse error: ");
       Serial.println(error.c_str());
     }
   } else if (httpCode == 401) {
-    http.end();
-    redseaToken = "";
-    return redseaCheckFeedingStatus();
+    authRejected = true;
+  } else {
+    Serial.print("✗ Feeding status request failed with code: ");
+    Serial.println(httpCode);
   }
   
   http.end();
   return false;
 }
 
-bool redseaStartFeeding() {
-  if (redseaToken.isEmpty()) {
-    Serial.println("No OAuth token - logging in first...");
-    if (!redseaLogin()) return false;
-  }
+// Refresh the cached cloud state now. Returns false if the request failed
+// (the cache then keeps its previous value and ages out).
+bool redseaRefreshFeedingStatus() {
+  xSemaphoreTake(redseaStatusMutex, portMAX_DELAY);
   
-  WiFiClientSecure client;
-  client.setInsecure();
+  // Validators and cached state belong to one aquarium
+  if (redseaStatusAquarium != redsea_AQUARIUM_ID) {
+    redseaStatusAquarium = redsea_AQUARIUM_ID;
+    redseaStatusETag = "";
+    redseaStatusLastModified = "";
+    portENTER_CRITICAL(&redseaStatusMux);
+    redseaCloudCheckedAt = 0;
+    portEXIT_CRITICAL(&redseaStatusMux);
+  }
   
-  HTTPClient http;
+  redseaRefreshGen = redseaStatusGeneration();
+  bool ok = redseaWithReauth<bool>(redseaRefreshFeedingStatusOnce, false);
+  xSemaphoreGive(redseaStatusMutex);
+  return ok;
+}
+
+static bool redseaStartFeedingOnce(bool& authRejected) {
+  HttpsLease lease(redsea_API_HOST);
+  HTTPClient& http = lease.http();
   String feedingUrl = String(redsea_API_BASE) + "/aquarium/" + redsea_AQUARIUM_ID + "/feeding/start";
   
-  http.begin(client, feedingUrl);
+  http.begin(lease.client(), feedingUrl);
   http.setTimeout(10000);  // 10s timeout
   http.setConnectTimeout(5000);  // 5s connect timeout
   http.addHeader("Content-Type", "application/json");
-  http.addHeader("Authorization", "Bearer " + redseaToken);
+  http.addHeader("Authorization", redseaBearer());
   
   String postData = "{}";
   
@@ -136,12 +516,14 @@ bool redseaStartFeeding() {
   
   if (httpCode == 200 || httpCode == 201 || httpCode == 204) {
     Serial.println("✓ Red Sea feeding mode activated");
+    redseaCommandFeeding(true);
     http.end();
     return true;
   } else if (httpCode == 400) {
     String response = http.getString();
     if (response.indexOf("already active") >= 0) {
       Serial.println("⚠ Feeding mode is already active in cloud");
+      redseaCommandFeeding(true);
       http.end();
       return true;
     }
@@ -150,10 +532,9 @@ bool redseaStartFeeding() {
     http.end();
     return false;
   } else if (httpCode == 401) {
-    Serial.println("✗ Token expired - re-authenticating...");
+    authRejected = true;
     http.end();
-    redseaToken = "";
-    return redseaStartFeeding();
+    return false;
   } else {
     Serial.print("✗ Feeding mode request failed with code: ");
     Serial.println(httpCode);
@@ -163,23 +544,21 @@ bool redseaStartFeeding() {
   }
 }
 
-bool redseaStopFeeding() {
-  if (redseaToken.isEmpty()) {
-    Serial.println("No OAuth token - logging in first...");
-    if (!redseaLogin()) return false;
-  }
-  
-  WiFiClientSecure client;
-  client.setInsecure();
-  
-  HTTPClient http;
+bool redseaStartFeeding() {
+  redseaStatusBump();  // A refresh running now may read the state before the command
+  return redseaWithReauth<bool>(redseaStartFeedingOnce, false);
+}
+
+static bool redseaStopFeedingOnce(bool& authRejected) {
+  HttpsLease lease(redsea_API_HOST);
+  HTTPClient& http = lease.http();
   String feedingUrl = String(redsea_API_BASE) + "/aquarium/" + redsea_AQUARIUM_ID + "/feeding/stop";
   
-  http.begin(client, feedingUrl);
+  http.begin(lease.client(), feedingUrl);
   http.setTimeout(10000);  // 10s timeout
   http.setConnectTimeout(5000);  // 5s connect timeout
   http.addHeader("Content-Type", "application/json");
-  http.addHeader("Authorization", "Bearer " + redseaToken);
+  http.addHeader("Authorization", redseaBearer());
   
   String postData = "{}";
   
@@ -188,13 +567,13 @@ bool redseaStopFeeding() {
   
   if (httpCode == 200 || httpCode == 201 || httpCode == 204) {
     Serial.println("✓ Red Sea feeding mode deactivated");
+    redseaCommandFeeding(false);
     http.end();
     return true;
   } else if (httpCode == 401) {
-    Serial.println("✗ Token expired - re-authenticating...");
+    authRejected = true;
     http.end();
-    redseaToken = "";
-    return redseaStopFeeding();
+    return false;
   } else {
     Serial.print("✗ Stop feeding request failed with code: ");
     Serial.println(httpCode);
@@ -204,63 +583,52 @@ bool redseaStopFeeding() {
   }
 }
 
-String redseaGetAquariums() {
-  if (redseaToken.isEmpty()) {
-    Serial.println("No OAuth token - logging in first...");
-    if (!redseaLogin()) {
-      return "{\"success\":false,\"message\":\"Login failed\"}";
-    }
-  }
-  
-  WiFiClientSecure client;
-  client.setInsecure();
-  
-  HTTPClient http;
+bool redseaStopFeeding() {
+  redseaStatusBump();
+  return redseaWithReauth<bool>(redseaStopFeedingOnce, false);
+}
+
+// Fill result with {"success":..,"aquariums":[..]} or {"success":false,"message":..}
+static bool redseaGetAquariumsOnce(JsonDocument& result, bool& authRejected) {
+  HttpsLease lease(redsea_API_HOST);
+  HTTPClient& http = lease.http();
   String aquariumUrl = String(redsea_API_BASE) + "/aquarium";
   
-  http.begin(client, aquariumUrl);
+  http.begin(lease.client(), aquariumUrl);
   http.setTimeout(8000);  // 8s timeout
   http.setConnectTimeout(4000);  // 4s connect timeout
-  http.addHeader("Authorization", "Bearer " + redseaToken);
+  http.addHeader("Authorization", redseaBearer());
+  http.useHTTP10(true);  // No chunked encoding - the body is parsed straight from the stream
   
   Serial.println("Fetching aquarium list...");
   int httpCode = http.GET();
+  http.useHTTP10(false);  // Pooled HTTPClient - back to keep-alive for the next request
   
   if (httpCode == 200) {
-    String payload = http.getString();
-    Serial.println("Raw API Response:");
-    Serial.println(payload);
-    Serial.println("---");
+    // Keep only the fields we emit - the full listing is much larger
+    JsonDocument filter;
+    redseaAquariumFilter(filter);
     
     JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, payload);
+    DeserializationError error = deserializeJson(doc, http.getStream(), DeserializationOption::Filter(filter));
+    http.end();
     
     if (!error) {
       if (!doc.is<JsonArray>()) {
         Serial.println("✗ Response is not an array");
-        http.end();
-        return "{\"success\":false,\"message\":\"Unexpected JSON structure\"}";
+        result["success"] = false;
+        result["message"] = "Unexpected JSON structure";
+        return false;
       }
       
-      JsonArray aquariums = doc.as<JsonArray>();
-      Serial.print("Number of aquariums found: ");
-      Serial.println(aquariums.size());
-      
-      String result = "{\"success\":true,\"aquariums\":[";
-      
-      bool first = true;
+      result["success"] = true;
+      JsonArray out = result["aquariums"].to<JsonArray>();
       int count = 0;
       
-      for (JsonObject aquarium : aquariums) {
-        if (!first) result += ",";
-        first = false;
-        
-        String aqua_id = aquarium["id"].as<String>();
-        String aqua_name = aquarium["name"].as<String>();
-        String aqua_uid = aquarium["uid"].as<String>();
-        
+      for (JsonObject aquarium : doc.as<JsonArray>()) {
+        String aqua_name = aquarium["name"] | "";
         if (aqua_name.length() == 0) {
-          aqua_name = "Aquarium " + aqua_id;
+          aqua_name = "Aquarium " + aquarium["id"].as<String>();
         }
         
         count++;
@@ -269,50 +637,101 @@ String redseaGetAquariums() {
         Serial.print(": ");
         Serial.println(aqua_name);
         
-        result += "{\"id\":\"" + aqua_uid + "\",\"name\":\"" + aqua_name + "\"";
+        JsonObject a = out.add<JsonObject>();
+        a["id"] = aquarium["uid"].as<String>();
+        a["name"] = aqua_name;
         
         // Add aquarium info
-        if (aquarium["measuring_unit"].is<const char*>()) result += ",\"measuring_unit\":\"" + aquarium["measuring_unit"].as<String>() + "\"";
-        if (aquarium["water_volume"].is<int>()) result += ",\"water_volume\":" + String(aquarium["water_volume"].as<int>());
-        if (aquarium["net_water_volume"].is<int>()) result += ",\"net_water_volume\":" + String(aquarium["net_water_volume"].as<int>());
-        if (aquarium["online"].is<bool>()) result += ",\"online\":" + String(aquarium["online"].as<bool>() ? "true" : "false");
-        if (aquarium["timezone_offset"].is<int>()) result += ",\"timezone_offset\":" + String(aquarium["timezone_offset"].as<int>());
+        if (aquarium["measuring_unit"].is<const char*>()) a["measuring_unit"] = aquarium["measuring_unit"];
+        if (aquarium["water_volume"].is<int>()) a["water_volume"] = aquarium["water_volume"];
+        if (aquarium["net_water_volume"].is<int>()) a["net_water_volume"] = aquarium["net_water_volume"];
+        if (aquarium["online"].is<bool>()) a["online"] = aquarium["online"];
+        if (aquarium["timezone_offset"].is<int>()) a["timezone_offset"] = aquarium["timezone_offset"];
         
         // Add system information as "device" info
         if (aquarium["system_series"].is<const char*>() || aquarium["serial_number"].is<const char*>()) {
-          result += ",\"devices\":[{";
-          result += "\"name\":\"" + aquarium["system_model"].as<String>() + "\"";
-          result += ",\"type\":\"" + aquarium["system_type"].as<String>() + "\"";
-          result += ",\"serial\":\"" + aquarium["serial_number"].as<String>() + "\"";
-          result += ",\"firmware\":\"System Series: " + aquarium["system_series"].as<String>() + "\"";
-          result += "}]";
+          JsonObject dev = a["devices"].to<JsonArray>().add<JsonObject>();
+          dev["name"] = aquarium["system_model"].as<String>();
+          dev["type"] = aquarium["system_type"].as<String>();
+          dev["serial"] = aquarium["serial_number"].as<String>();
+          dev["firmware"] = "System Series: " + aquarium["system_series"].as<String>();
           Serial.print("  System: ");
           Serial.println(aquarium["system_series"].as<String>());
         }
-        
-        result += "}";
       }
       
-      result += "]}";
       Serial.print("Total aquariums: ");
       Serial.println(count);
-      http.end();
-      return result;
+      return true;
     } else {
       Serial.print("✗ JSON parse error: ");
       Serial.println(error.c_str());
     }
   } else if (httpCode == 401) {
+    authRejected = true;
     http.end();
-    redseaToken = "";
-    return redseaGetAquariums();
   } else {
     Serial.print("✗ Failed to fetch aquariums with code: ");
     Serial.println(httpCode);
+    http.end();
   }
   
-  http.end();
-  return "{\"success\":false,\"message\":\"Failed to fetch aquariums\"}";
+  result["success"] = false;
+  result["message"] = "Failed to fetch aquariums";
+  return false;
+}
+
+bool redseaGetAquariums(JsonDocument& result) {
+  result.clear();
+  bool ok = redseaWithReauth<bool>([&result](bool& authRejected) {
+    result.clear();
+    return redseaGetAquariumsOnce(result, authRejected);
+  }, false);
+  
+  if (!ok && result.isNull()) {
+    result["success"] = false;
+    result["message"] = "Login failed";
+  }
+  return ok;
+}
+
+// ============================================================
+// Background Task (token renewal, cloud state refresh)
+// ============================================================
+static void redseaBackgroundTask(void* param) {
+  for (;;) {
+    if (ENABLE_redsea && WiFi.status() == WL_CONNECTED && !redsea_USERNAME.isEmpty()) {
+      // Without a token the refresh would log in again - skip it while
+      // the login backs off
+      bool token = redseaEnsureTokenEx(REDSEA_TOKEN_REFRESH_MARGIN, true);
+      if (!token) {
+        redseaTokenLock();
+        token = redseaTokenSecondsLeft() > 0;  // Still usable until it expires
+        redseaTokenUnlock();
+      }
+      
+      if (token && !redsea_AQUARIUM_ID.isEmpty() && redseaCachedFeedingStatus(REDSEA_STATUS_REFRESH) < 0) {
+        redseaRefreshFeedingStatus();
+      }
+    }
+    vTaskDelay(pdMS_TO_TICKS(REDSEA_BG_INTERVAL));
+  }
+}
+
+void redseaBackgroundBegin() {
+  if (redseaBgTaskHandle) return;
+  redseaTokenInit();
+  if (!redseaStatusMutex) redseaStatusMutex = xSemaphoreCreateMutex();
+  
+  xTaskCreatePinnedToCore(
+    redseaBackgroundTask,   // Task function
+    "redsea_bg",            // Name
+    REDSEA_BG_STACK,        // Stack size
+    NULL,                   // Parameters
+    REDSEA_BG_PRIORITY,     // Priority
+    &redseaBgTaskHandle,    // Task handle
+    REDSEA_BG_CORE          // Core
+  );
 }
 
 #endif // REDSEA_API_H
@@ -14,6 +14,7 @@
 
 // Forward declarations
 void hideScreensaver();
+extern volatile bool timeSynced;  // Set by the SNTP sync callback in main.cpp
 
 // Colors (Rolex Submariner style)
 #define CLOCK_BG        lv_color_hex(0x000000)  // Black
@@ -43,6 +44,12 @@ static unsigned long screensaver_exit_time = 0;  // Time when screensaver was ex
 static void update_clock() {
   if (!screensaver_active || !clock_meter || !indic_hour || !indic_min || !indic_sec) return;
   
+  // Hands stay at 12 until SNTP delivers the first time
+  if (!timeSynced) {
+    if (date_label) lv_label_set_text(date_label, "--.--.----");
+    return;
+  }
+  
   time_t now = time(NULL);
   struct tm *timeinfo = localtime(&now);
   if (!timeinfo) return;
@@ -195,6 +202,13 @@ void hideScreensaver() {
   }
 }
 
+// ============================================================
+// Refresh Clock (time just arrived via SNTP)
+// ============================================================
+void refreshScreensaverClock() {
+  update_clock();
+}
+
 // ============================================================
 // Check if touch should be ignored (just exited screensaver)
 // ============================================================
@@ -66,7 +66,15 @@ static void create_settings_styles() {
 // ============================================================
 // Factory Reset Handler
 // ============================================================
-static bool pending_restart = false;
+static volatile bool pending_restart = false;
+static unsigned long pending_restart_at = 0;
+
+// Restart from the main loop once `delayMs` have passed (lets the UI
+// show its last frame) - LVGL callbacks must not block or restart
+void scheduleRestart(unsigned long delayMs) {
+  pending_restart_at = millis() + delayMs;
+  pending_restart = true;
+}
 
 static void settings_reset_msgbox_cb(lv_event_t *e) {
   lv_obj_t *obj = lv_event_get_current_target(e);
@@ -93,8 +101,8 @@ static void settings_reset_msgbox_cb(lv_event_t *e) {
       lv_msgbox_close(reset_confirm_msgbox);
       reset_confirm_msgbox = NULL;
       
-      // Set flag for restart in main loop (safer than restarting in callback)
-      pending_restart = true;
+      // Restart in main loop (safer than restarting in callback)
+      scheduleRestart(100);
       
     } else {
       // Cancel - close msgbox
@@ -106,8 +114,7 @@ static void settings_reset_msgbox_cb(lv_event_t *e) {
 
 // Call this in main loop to check for pending restart
 void checkPendingRestart() {
-  if (pending_restart) {
-    delay(100);  // Small delay to let UI update
+  if (pending_restart && (long)(millis() - pending_restart_at) >= 0) {
     ESP.restart();
   }
 }
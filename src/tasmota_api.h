@@ -4,6 +4,10 @@
  * 
  * Discovers Tasmota devices on the local network and controls them
  * during feeding mode. Supports automatic turn-on via PulseTime.
+ * Devices with a known MQTT topic are controlled through the broker
+ * when one is configured (tasmota_mqtt.h), otherwise via HTTP. Members
+ * of a configured Tasmota device group are switched together with one
+ * multicast packet (tasmota_group.h).
  */
 
 #ifndef TASMOTA_API_H
@@ -15,8 +19,15 @@
 #include <ArduinoJson.h>
 #include <Preferences.h>
 #include <vector>
+#include <algorithm>
 #include <esp_attr.h>
-#include <lvgl.h>
+#include <lwip/sockets.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "tasmota_mqtt.h"
+#include "tasmota_group.h"
+#include "tasmota_breaker.h"
+#include "led_pattern.h"
 
 // Forward declarations from main
 extern bool feedingModeActive;
@@ -28,10 +39,15 @@ struct TasmotaDevice {
   String ip;
   String name;
   String hostname;
+  String topic;      // MQTT topic (empty = unknown, HTTP only)
   bool enabled;      // User selected for feeding break
   bool turnOn;       // true = turn ON during feeding, false = turn OFF (default)
   bool powerState;   // Current power state
   bool reachable;    // Device is reachable
+  unsigned long actionMs = 0;  // Duration of the last start/stop action
+  bool actionOk = true;        // Result of the last start/stop action
+  bool eventArmed = false;     // Completion rule installed on the plug
+  bool feedingSeen = false;    // Reported in its feeding state since the last start
 };
 
 // ============================================================
@@ -44,6 +60,42 @@ static DRAM_ATTR bool tasmotaFeedingActive = false;  // Feeding mode active for
 static DRAM_ATTR unsigned long tasmotaFeedingStartTime = 0;  // When feeding started
 static DRAM_ATTR bool tasmotaDebug = false;  // Debug output disabled
 
+void tasmotaStatusChanged();  // Background state poller (defined below)
+void tasmotaPollNow();
+
+// ============================================================
+// Device List Lock
+// ============================================================
+// tasmotaDevices is shared by the web handlers (AsyncTCP), the poller,
+// the feeding backend and the MQTT / device group tasks. The lock is
+// held only to copy entries out or write results back by IP, never
+// across network I/O. Recursive: helpers like tasmotaMqttTopicFor()
+// lock as well.
+static SemaphoreHandle_t tasmotaDevicesMutex = NULL;
+static uint32_t tasmotaDeviceGeneration = 0;  // Bumped around every start/stop dispatch
+
+static void tasmotaDevicesLock() {
+  xSemaphoreTakeRecursive(tasmotaDevicesMutex, portMAX_DELAY);
+}
+
+static void tasmotaDevicesUnlock() {
+  xSemaphoreGiveRecursive(tasmotaDevicesMutex);
+}
+
+static size_t tasmotaDeviceCount() {
+  tasmotaDevicesLock();
+  size_t count = tasmotaDevices.size();
+  tasmotaDevicesUnlock();
+  return count;
+}
+
+// Device state reported by the device itself (poll, event, MQTT, group)
+static void tasmotaDeviceReported(TasmotaDevice& device, bool powerState) {
+  device.powerState = powerState;
+  device.reachable = true;
+  if (powerState == device.turnOn) device.feedingSeen = true;
+}
+
 // ============================================================
 // Preferences Reference
 // ============================================================
@@ -79,76 +131,766 @@ static String urlEncode(const String& str) {
 }
 
 // ============================================================
-// Send Command to Tasmota Device (with optional retry)
+// Per-Device Link Statistics and Timeouts
 // ============================================================
-static String tasmotaSendCommand(const String& ip, const String& command, int retries = 3) {
-  String response = "";
+// Every HTTP request feeds the round trip time of its device into an
+// EWMA (srtt/rttvar as in TCP) and a window of recent samples for the
+// p95. Timeouts are derived from these instead of fixed values: healthy
+// plugs give up quickly on a lost request, slow plugs get more time.
+// Until enough samples exist the previous fixed timeouts are used.
+//
+// The same table holds the circuit breaker of each device
+// (tasmota_breaker.h).
+
+#define TASMOTA_LINK_MAX_DEVICES    16
+#define TASMOTA_LINK_WINDOW         32      // Samples kept for the p95
+#define TASMOTA_LINK_MIN_SAMPLES    4       // Below this the defaults apply
+#define TASMOTA_READ_TIMEOUT        800     // Default read timeout (ms)
+#define TASMOTA_CONNECT_TIMEOUT     500     // Default connect timeout (ms)
+#define TASMOTA_TIMEOUT_MIN         250
+#define TASMOTA_TIMEOUT_MAX         3000
+#define TASMOTA_BACKOFF_BASE        100     // First retry waits 50-200 ms
+#define TASMOTA_BACKOFF_MAX         1000
+#define TASMOTA_HEDGE_MIN_SAMPLES   8       // Hedge only with a reliable p95
+#define TASMOTA_HEDGE_STACK         5120
+#define TASMOTA_HEDGE_PRIORITY      2
+
+struct TasmotaLinkStats {
+  uint32_t addr;            // Device IP (0 = free slot)
+  float srtt;               // Smoothed round trip time (ms)
+  float rttvar;             // Smoothed deviation (ms)
+  uint16_t window[TASMOTA_LINK_WINDOW];
+  uint8_t windowPos;
+  uint32_t samples;
+  uint32_t failures;
+  uint32_t hedges;          // Hedged second requests sent
+  uint32_t hedgeWins;       // ... that answered first
+  uint32_t lastUsed;        // millis() of the last lookup (LRU eviction)
+  TasmotaBreaker breaker;   // On the millis() clock
+};
+
+static TasmotaLinkStats tasmotaLinks[TASMOTA_LINK_MAX_DEVICES];
+static portMUX_TYPE tasmotaLinkMux = portMUX_INITIALIZER_UNLOCKED;
+static DRAM_ATTR bool tasmotaHedging = false;  // Hedged retries (optional)
+
+bool tasmotaIsHedging() { return tasmotaHedging; }
+void tasmotaSetHedging(bool enabled) { tasmotaHedging = enabled; }
+
+static uint32_t tasmotaIpToU32(const String& ip) {
+  IPAddress addr;
+  if (!addr.fromString(ip)) return 0;
+  return (uint32_t)addr;
+}
+
+// Slot of a device, created on first use - caller must hold tasmotaLinkMux.
+// A free slot is taken first; with a full table the least recently used
+// slot is evicted, but never one whose circuit is open or half-open.
+// NULL if every slot holds a device with a non-closed circuit.
+static TasmotaLinkStats* tasmotaLinkFor(uint32_t addr) {
+  uint32_t now = millis();
+  TasmotaLinkStats* freeSlot = NULL;
+  TasmotaLinkStats* lru = NULL;
+  for (int i = 0; i < TASMOTA_LINK_MAX_DEVICES; i++) {
+    TasmotaLinkStats* link = &tasmotaLinks[i];
+    if (link->addr == addr) {
+      link->lastUsed = now;
+      return link;
+    }
+    if (link->addr == 0) {
+      if (!freeSlot) freeSlot = link;
+    } else if (link->breaker.state == TASMOTA_BREAKER_CLOSED &&
+               (!lru || now - link->lastUsed > now - lru->lastUsed)) {
+      lru = link;
+    }
+  }
   
-  for (int attempt = 0; attempt < retries; attempt++) {
-    // Check WiFi connection before trying
-    if (WiFi.status() != WL_CONNECTED) {
-      Serial.println("[TASMOTA] WiFi disconnected, waiting...");
-      delay(100);
-      yield();
-      lv_timer_handler();
-      continue;
+  TasmotaLinkStats* slot = freeSlot ? freeSlot : lru;
+  if (!slot) return NULL;
+  memset(slot, 0, sizeof(TasmotaLinkStats));
+  slot->addr = addr;
+  slot->lastUsed = now;
+  return slot;
+}
+
+static void tasmotaLinkRecord(const String& ip, bool ok, unsigned long rttMs) {
+  uint32_t addr = tasmotaIpToU32(ip);
+  if (addr == 0) return;
+  
+  // Round trip statistics only - the breaker counts whole commands
+  // (tasmotaSendCommand)
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  TasmotaLinkStats* link = tasmotaLinkFor(addr);
+  if (!link) {
+    // Table full of open circuits - no statistics for this device
+  } else if (!ok) {
+    link->failures++;
+  } else {
+    float rtt = rttMs;
+    if (link->samples == 0) {
+      link->srtt = rtt;
+      link->rttvar = rtt / 2;
+    } else {
+      link->rttvar += (fabsf(rtt - link->srtt) - link->rttvar) / 4;
+      link->srtt += (rtt - link->srtt) / 8;
     }
+    link->window[link->windowPos] = rttMs > 0xFFFF ? 0xFFFF : rttMs;
+    link->windowPos = (link->windowPos + 1) % TASMOTA_LINK_WINDOW;
+    link->samples++;
+  }
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+}
+
+static TasmotaBreakerState tasmotaBreakerState(const String& ip) {
+  uint32_t addr = tasmotaIpToU32(ip);
+  TasmotaBreakerState state = TASMOTA_BREAKER_CLOSED;
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  for (int i = 0; i < TASMOTA_LINK_MAX_DEVICES; i++) {
+    if (tasmotaLinks[i].addr == addr) state = tasmotaLinks[i].breaker.state;
+  }
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+  return state;
+}
+
+// Open circuit whose cooldown has passed (due for a background probe)
+static bool tasmotaBreakerProbeDue(const String& ip) {
+  uint32_t addr = tasmotaIpToU32(ip);
+  bool due = false;
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  for (int i = 0; i < TASMOTA_LINK_MAX_DEVICES; i++) {
+    if (tasmotaLinks[i].addr == addr) due = tasmotaBreakerDue(tasmotaLinks[i].breaker, millis());
+  }
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+  return due;
+}
+
+// p95 of the sample window - caller must hold tasmotaLinkMux
+static uint16_t tasmotaLinkP95(const TasmotaLinkStats* link) {
+  int count = link->samples < TASMOTA_LINK_WINDOW ? link->samples : TASMOTA_LINK_WINDOW;
+  if (count == 0) return 0;
+  
+  uint16_t sorted[TASMOTA_LINK_WINDOW];
+  memcpy(sorted, link->window, count * sizeof(uint16_t));
+  std::sort(sorted, sorted + count);
+  return sorted[(count * 95 - 1) / 100];
+}
+
+struct TasmotaTimeouts {
+  uint16_t connectMs;
+  uint16_t readMs;
+  uint16_t p95Ms;           // 0 = unknown (no hedging)
+};
+
+static TasmotaTimeouts tasmotaLinkTimeouts(const String& ip) {
+  TasmotaTimeouts t = { TASMOTA_CONNECT_TIMEOUT, TASMOTA_READ_TIMEOUT, 0 };
+  uint32_t addr = tasmotaIpToU32(ip);
+  
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  for (int i = 0; i < TASMOTA_LINK_MAX_DEVICES; i++) {
+    const TasmotaLinkStats* link = &tasmotaLinks[i];
+    if (link->addr != addr || link->samples < TASMOTA_LINK_MIN_SAMPLES) continue;
     
-    // Yield to other tasks
-    yield();
-    lv_timer_handler();
-    delay(10);
-    
-    HTTPClient http;
-    String url = "http://" + ip + "/cm?cmnd=" + urlEncode(command);
+    uint16_t p95 = tasmotaLinkP95(link);
+    float rto = link->srtt + 4 * link->rttvar;
+    t.readMs = constrain((int)max(rto, (float)p95 * 1.5f), TASMOTA_TIMEOUT_MIN, TASMOTA_TIMEOUT_MAX);
+    t.connectMs = constrain((int)(t.readMs * 2 / 3), TASMOTA_TIMEOUT_MIN, TASMOTA_TIMEOUT_MAX);
+    if (link->samples >= TASMOTA_HEDGE_MIN_SAMPLES) t.p95Ms = p95;
+  }
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+  return t;
+}
+
+// Full-jitter exponential backoff before retry `attempt` (1-based)
+static unsigned long tasmotaBackoffMs(int attempt) {
+  unsigned long cap = TASMOTA_BACKOFF_BASE << min(attempt - 1, 4);
+  if (cap > TASMOTA_BACKOFF_MAX) cap = TASMOTA_BACKOFF_MAX;
+  return cap / 2 + esp_random() % (cap + 1);
+}
+
+static void tasmotaLinkAddStatsJson(const String& ip, JsonObject obj) {
+  uint32_t addr = tasmotaIpToU32(ip);
+  TasmotaLinkStats link;
+  bool found = false;
+  uint16_t p95 = 0;
+  
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  for (int i = 0; i < TASMOTA_LINK_MAX_DEVICES; i++) {
+    if (tasmotaLinks[i].addr == addr) {
+      link = tasmotaLinks[i];
+      p95 = tasmotaLinkP95(&link);
+      found = true;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+  
+  TasmotaTimeouts t = tasmotaLinkTimeouts(ip);
+  obj["rtt_ewma_ms"] = found ? (int)link.srtt : 0;
+  obj["rtt_p95_ms"] = p95;
+  obj["samples"] = found ? link.samples : 0;
+  obj["failures"] = found ? link.failures : 0;
+  obj["hedges"] = found ? link.hedges : 0;
+  obj["hedge_wins"] = found ? link.hedgeWins : 0;
+  obj["connect_timeout_ms"] = t.connectMs;
+  obj["read_timeout_ms"] = t.readMs;
+  obj["circuit"] = tasmotaBreakerName(found ? link.breaker.state : TASMOTA_BREAKER_CLOSED);
+}
+
+// ============================================================
+// Keep-Alive Connection Cache
+// ============================================================
+// A stop sequence or a status poll contacts the same plug several times
+// in a row. Each cache entry keeps the WiFiClient and HTTPClient of one
+// device open between requests (HTTPClient closes the socket in its
+// destructor, so the object itself has to be kept). If the plug closed
+// the connection in the meantime, HTTPClient reconnects transparently.
+
+#define TASMOTA_CONN_MAX            4       // One per dispatch worker
+#define TASMOTA_CONN_IDLE_TIMEOUT   10000   // Close after 10 s idle
+#define TASMOTA_CONN_MAINTAIN_MS    2000    // Idle check interval
+
+struct TasmotaConnEntry {
+  String ip;
+  WiFiClient* client;
+  HTTPClient* http;
+  unsigned long lastUsed;
+  bool inUse;
+};
+
+struct TasmotaConnStats {
+  uint32_t reuses;      // Request sent on an open connection
+  uint32_t misses;      // Request needed a new TCP connection
+  uint32_t overflows;   // Cache exhausted - temporary connection used
+  uint32_t evictions;   // Idle connections closed
+};
+
+static TasmotaConnEntry tasmotaConns[TASMOTA_CONN_MAX];
+static TasmotaConnStats tasmotaConnStats = {0, 0, 0, 0};
+static portMUX_TYPE tasmotaConnMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Close the connection of an entry - entry must not be in use
+static void tasmotaConnCloseEntry(TasmotaConnEntry& entry) {
+  if (entry.http) {
+    delete entry.http;  // Stops the socket
+    entry.http = NULL;
+  }
+  if (entry.client) {
+    entry.client->stop();
+    delete entry.client;
+    entry.client = NULL;
+  }
+  entry.ip = "";
+}
+
+class TasmotaConnLease {
+public:
+  explicit TasmotaConnLease(const String& ip) : _slot(-1), _reused(false), _client(NULL), _http(NULL) {
+    int evict = -1;
     
-    if (tasmotaDebug) {
-      if (attempt > 0) {
-        Serial.printf("[TASMOTA DEBUG] >> %s CMD: %s (retry %d)\n", ip.c_str(), command.c_str(), attempt);
-      } else {
-        Serial.printf("[TASMOTA DEBUG] >> %s CMD: %s\n", ip.c_str(), command.c_str());
+    portENTER_CRITICAL(&tasmotaConnMux);
+    // 1. Idle connection to the same device
+    for (int i = 0; i < TASMOTA_CONN_MAX; i++) {
+      TasmotaConnEntry& e = tasmotaConns[i];
+      if (!e.inUse && e.client && e.ip == ip) {
+        _slot = i;
+        break;
       }
-      Serial.printf("[TASMOTA DEBUG]    URL: %s\n", url.c_str());
     }
+    // 2. Empty slot, or else the least recently used idle slot
+    if (_slot < 0) {
+      for (int i = 0; i < TASMOTA_CONN_MAX; i++) {
+        TasmotaConnEntry& e = tasmotaConns[i];
+        if (e.inUse) continue;
+        if (!e.client) {
+          _slot = i;
+          break;
+        }
+        if (_slot < 0 || e.lastUsed < tasmotaConns[_slot].lastUsed) _slot = i;
+      }
+      if (_slot >= 0 && tasmotaConns[_slot].client) evict = _slot;
+    }
+    if (_slot >= 0) tasmotaConns[_slot].inUse = true;
+    portEXIT_CRITICAL(&tasmotaConnMux);
     
-    http.begin(url);
-    http.setTimeout(800);  // 800ms timeout (reduced)
-    http.setConnectTimeout(500);  // 500ms connect timeout (reduced)
+    // Sockets are opened and closed outside the critical section
+    if (_slot < 0) {
+      // All cached connections busy - one-off connection, closed on release
+      _client = new WiFiClient();
+      _http = new HTTPClient();
+      _http->setReuse(false);
+      portENTER_CRITICAL(&tasmotaConnMux);
+      tasmotaConnStats.overflows++;
+      tasmotaConnStats.misses++;
+      portEXIT_CRITICAL(&tasmotaConnMux);
+      return;
+    }
     
-    int httpCode = http.GET();
+    TasmotaConnEntry& entry = tasmotaConns[_slot];
+    if (evict >= 0) tasmotaConnCloseEntry(entry);
+    if (!entry.client) {
+      entry.ip = ip;
+      entry.client = new WiFiClient();
+      entry.http = new HTTPClient();
+      entry.http->setReuse(true);
+    }
+    _client = entry.client;
+    _http = entry.http;
+    _reused = _client->connected();
     
-    // Yield to other tasks after HTTP call
-    yield();
-    lv_timer_handler();
-    delay(5);
+    portENTER_CRITICAL(&tasmotaConnMux);
+    if (evict >= 0) tasmotaConnStats.evictions++;
+    if (_reused) tasmotaConnStats.reuses++;
+    else tasmotaConnStats.misses++;
+    portEXIT_CRITICAL(&tasmotaConnMux);
+  }
+  
+  ~TasmotaConnLease() {
+    if (_slot < 0) {
+      delete _http;
+      _client->stop();
+      delete _client;
+      return;
+    }
     
-    if (httpCode == HTTP_CODE_OK) {
-      response = http.getString();
-      if (tasmotaDebug) {
-        Serial.printf("[TASMOTA DEBUG] << %s Response: %s\n", ip.c_str(), response.c_str());
+    portENTER_CRITICAL(&tasmotaConnMux);
+    tasmotaConns[_slot].inUse = false;
+    tasmotaConns[_slot].lastUsed = millis();
+    portEXIT_CRITICAL(&tasmotaConnMux);
+  }
+  
+  WiFiClient& client() { return *_client; }
+  HTTPClient& http() { return *_http; }
+  bool reused() const { return _reused; }
+  
+private:
+  TasmotaConnLease(const TasmotaConnLease&);
+  TasmotaConnLease& operator=(const TasmotaConnLease&);
+  
+  int _slot;
+  bool _reused;
+  WiFiClient* _client;
+  HTTPClient* _http;
+};
+
+// Idle eviction (call regularly from loop)
+void tasmotaConnMaintain() {
+  static unsigned long lastCheck = 0;
+  if (millis() - lastCheck < TASMOTA_CONN_MAINTAIN_MS) return;
+  lastCheck = millis();
+  
+  for (int i = 0; i < TASMOTA_CONN_MAX; i++) {
+    TasmotaConnEntry& e = tasmotaConns[i];
+    
+    // Claim the idle entry so no lease can take it while it is closed
+    portENTER_CRITICAL(&tasmotaConnMux);
+    bool idle = !e.inUse && e.client && (millis() - e.lastUsed) > TASMOTA_CONN_IDLE_TIMEOUT;
+    if (idle) e.inUse = true;
+    portEXIT_CRITICAL(&tasmotaConnMux);
+    if (!idle) continue;
+    
+    tasmotaConnCloseEntry(e);
+    portENTER_CRITICAL(&tasmotaConnMux);
+    e.inUse = false;
+    tasmotaConnStats.evictions++;
+    portEXIT_CRITICAL(&tasmotaConnMux);
+  }
+}
+
+// Close all cached connections (e.g. after WiFi loss)
+void tasmotaConnFlush() {
+  for (int i = 0; i < TASMOTA_CONN_MAX; i++) {
+    TasmotaConnEntry& e = tasmotaConns[i];
+    portENTER_CRITICAL(&tasmotaConnMux);
+    bool idle = !e.inUse && e.client;
+    if (idle) e.inUse = true;
+    portEXIT_CRITICAL(&tasmotaConnMux);
+    if (!idle) continue;
+    
+    tasmotaConnCloseEntry(e);
+    portENTER_CRITICAL(&tasmotaConnMux);
+    e.inUse = false;
+    portEXIT_CRITICAL(&tasmotaConnMux);
+  }
+}
+
+// Copy of the counters (for the benchmark in net_bench.h)
+TasmotaConnStats tasmotaConnGetStats() {
+  portENTER_CRITICAL(&tasmotaConnMux);
+  TasmotaConnStats stats = tasmotaConnStats;
+  portEXIT_CRITICAL(&tasmotaConnMux);
+  return stats;
+}
+
+void tasmotaConnAddStatsJson(JsonObject obj) {
+  portENTER_CRITICAL(&tasmotaConnMux);
+  TasmotaConnStats stats = tasmotaConnStats;
+  int open = 0;
+  for (int i = 0; i < TASMOTA_CONN_MAX; i++) {
+    if (tasmotaConns[i].client) open++;
+  }
+  portEXIT_CRITICAL(&tasmotaConnMux);
+  
+  uint32_t total = stats.reuses + stats.misses;
+  obj["reuses"] = stats.reuses;
+  obj["misses"] = stats.misses;
+  obj["overflows"] = stats.overflows;
+  obj["evictions"] = stats.evictions;
+  obj["open_sockets"] = open;
+  obj["max_sockets"] = TASMOTA_CONN_MAX;
+  obj["reuse_ratio"] = total > 0 ? (float)stats.reuses / total : 0.0f;
+}
+
+// ============================================================
+// Single HTTP Request (records the round trip)
+// ============================================================
+static int tasmotaHttpGet(const String& ip, const String& url, const TasmotaTimeouts& t, String& response) {
+  TasmotaConnLease lease(ip);
+  HTTPClient& http = lease.http();
+  http.begin(lease.client(), url);
+  http.setTimeout(t.readMs);
+  http.setConnectTimeout(t.connectMs);
+  
+  unsigned long start = millis();
+  int httpCode = http.GET();
+  if (httpCode == HTTP_CODE_OK) response = http.getString();
+  http.end();  // Connection stays open if the plug allows keep-alive
+  
+  // A failed request may leave a half-open socket behind
+  if (httpCode != HTTP_CODE_OK) lease.client().stop();
+  
+  tasmotaLinkRecord(ip, httpCode == HTTP_CODE_OK, millis() - start);
+  return httpCode;
+}
+
+// ============================================================
+// Hedged Request
+// ============================================================
+// The request runs in a helper task. If it has not answered within the
+// device's p95, a second identical request is sent and the first answer
+// wins. Tasmota commands set absolute states, so a duplicate is harmless.
+// The context is freed by whoever finishes last.
+
+struct TasmotaHedge;
+
+struct TasmotaHedgeRequest {
+  TasmotaHedge* hedge;
+  int slot;
+};
+
+struct TasmotaHedge {
+  String ip;
+  String url;
+  TasmotaTimeouts timeouts;
+  SemaphoreHandle_t done;   // Given by each finished request
+  int refs;                 // Guarded by tasmotaLinkMux
+  int code[2];
+  String response[2];
+  TasmotaHedgeRequest request[2];
+};
+
+static void tasmotaHedgeRelease(TasmotaHedge* hedge) {
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  bool last = --hedge->refs == 0;
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+  if (last) {
+    vSemaphoreDelete(hedge->done);
+    delete hedge;
+  }
+}
+
+static void tasmotaHedgeTask(void* param) {
+  TasmotaHedgeRequest* request = (TasmotaHedgeRequest*)param;
+  TasmotaHedge* hedge = request->hedge;
+  String response;
+  int code = tasmotaHttpGet(hedge->ip, hedge->url, hedge->timeouts, response);
+  
+  // The response is read only once the code shows success
+  hedge->response[request->slot] = response;
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  hedge->code[request->slot] = code;
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+  xSemaphoreGive(hedge->done);
+  
+  tasmotaHedgeRelease(hedge);
+  vTaskDelete(NULL);
+}
+
+static bool tasmotaHedgeStart(TasmotaHedge* hedge, int slot) {
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  hedge->refs++;
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+  
+  BaseType_t created = xTaskCreatePinnedToCore(
+    tasmotaHedgeTask,         // Task function
+    "tasmota_hedge",          // Name
+    TASMOTA_HEDGE_STACK,      // Stack size
+    &hedge->request[slot],    // Parameters
+    TASMOTA_HEDGE_PRIORITY,   // Priority
+    NULL,                     // Task handle
+    0                         // Core 0
+  );
+  if (created == pdPASS) return true;
+  
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  hedge->refs--;
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+  return false;
+}
+
+static int tasmotaHttpGetHedged(const String& ip, const String& url, const TasmotaTimeouts& t, String& response) {
+  TasmotaHedge* hedge = new TasmotaHedge();
+  hedge->ip = ip;
+  hedge->url = url;
+  hedge->timeouts = t;
+  hedge->done = xSemaphoreCreateCounting(2, 0);
+  hedge->refs = 1;  // The caller
+  for (int i = 0; i < 2; i++) {
+    hedge->code[i] = 0;
+    hedge->request[i] = { hedge, i };
+  }
+  
+  if (!hedge->done || !tasmotaHedgeStart(hedge, 0)) {
+    if (hedge->done) vSemaphoreDelete(hedge->done);
+    delete hedge;
+    return tasmotaHttpGet(ip, url, t, response);
+  }
+  
+  int started = 1;
+  int finished = 0;
+  int winner = -1;
+  TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(t.connectMs + t.readMs + 200);
+  
+  // First request slower than p95: send the hedge
+  if (xSemaphoreTake(hedge->done, pdMS_TO_TICKS(t.p95Ms)) == pdTRUE) {
+    finished = 1;
+  } else if (tasmotaHedgeStart(hedge, 1)) {
+    started = 2;
+    portENTER_CRITICAL(&tasmotaLinkMux);
+    TasmotaLinkStats* link = tasmotaLinkFor(tasmotaIpToU32(ip));
+    if (link) link->hedges++;
+    portEXIT_CRITICAL(&tasmotaLinkMux);
+  }
+  
+  for (;;) {
+    if (finished > 0) {
+      portENTER_CRITICAL(&tasmotaLinkMux);
+      for (int i = 0; i < started; i++) {
+        if (hedge->code[i] == HTTP_CODE_OK && winner < 0) winner = i;
       }
-      http.end();
-      return response;  // Success - return immediately
-    } else if (tasmotaDebug) {
-      // Only log errors in debug mode to reduce serial spam
-      Serial.printf("[TASMOTA DEBUG] %s HTTP %d\n", ip.c_str(), httpCode);
+      portEXIT_CRITICAL(&tasmotaLinkMux);
     }
+    if (winner >= 0 || finished >= started) break;
     
-    http.end();
-    
-    // Wait before retry with watchdog feeding
-    if (attempt < retries - 1) {
-      Serial.printf("[TASMOTA] Retry %d/%d for %s...\n", attempt + 1, retries - 1, ip.c_str());
-      yield();
-      lv_timer_handler();
-      delay(100);
-      yield();
-      lv_timer_handler();
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(deadline - now) <= 0) break;
+    if (xSemaphoreTake(hedge->done, deadline - now) == pdTRUE) finished++;
+  }
+  
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  int firstCode = hedge->code[0];
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+  
+  int code = winner >= 0 ? HTTP_CODE_OK : (firstCode != 0 ? firstCode : HTTPC_ERROR_READ_TIMEOUT);
+  if (winner >= 0) {
+    response = hedge->response[winner];
+    if (winner == 1) {
+      portENTER_CRITICAL(&tasmotaLinkMux);
+      TasmotaLinkStats* link = tasmotaLinkFor(tasmotaIpToU32(ip));
+      if (link) link->hedgeWins++;
+      portEXIT_CRITICAL(&tasmotaLinkMux);
+    }
+  }
+  
+  tasmotaHedgeRelease(hedge);
+  return code;
+}
+
+// ============================================================
+// Send Command to Tasmota Device (with optional retry)
+// ============================================================
+// MQTT topic of a device if it can be reached through the broker
+static String tasmotaMqttTopicFor(const String& ip) {
+  if (!tasmotaMqttConnected()) return "";
+  String topic;
+  tasmotaDevicesLock();
+  for (const auto& device : tasmotaDevices) {
+    if (device.ip == ip) topic = device.topic;
+  }
+  tasmotaDevicesUnlock();
+  return topic;
+}
+
+// One command through the circuit breaker (tasmota_breaker.h)
+struct TasmotaSendContext {
+  uint32_t addr;
+  TasmotaBreaker scratch;   // Breaker without a link slot (unparsable address, full table)
+  const String* ip;
+  const String* command;
+  String topic;             // MQTT first if set - HTTP stays as fallback
+  String response;
+};
+
+static TasmotaBreaker* tasmotaSendLock(void* ctx) {
+  TasmotaSendContext* c = (TasmotaSendContext*)ctx;
+  portENTER_CRITICAL(&tasmotaLinkMux);
+  TasmotaLinkStats* link = c->addr != 0 ? tasmotaLinkFor(c->addr) : NULL;
+  return link ? &link->breaker : &c->scratch;
+}
+
+static void tasmotaSendUnlock(void* ctx) {
+  portEXIT_CRITICAL(&tasmotaLinkMux);
+}
+
+static uint32_t tasmotaSendNow() {
+  return millis();
+}
+
+// One attempt: MQTT (if the device has a topic), then HTTP
+static bool tasmotaSendAttempt(void* ctx, int attempt) {
+  TasmotaSendContext* c = (TasmotaSendContext*)ctx;
+  const String& ip = *c->ip;
+  const String& command = *c->command;
+  
+  if (c->topic.length() > 0) {
+    if (tasmotaDebug) {
+      Serial.printf("[TASMOTA DEBUG] >> %s (mqtt %s) CMD: %s\n", ip.c_str(), c->topic.c_str(), command.c_str());
+    }
+    c->response = tasmotaMqttCommand(c->topic, command);
+    if (c->response.length() > 0) {
+      if (tasmotaDebug) {
+        Serial.printf("[TASMOTA DEBUG] << %s Response: %s\n", ip.c_str(), c->response.c_str());
+      }
+      return true;
+    }
+    Serial.printf("[TASMOTA] MQTT timeout for %s, trying HTTP\n", ip.c_str());
+  }
+  
+  // Check WiFi connection before trying
+  if (WiFi.status() != WL_CONNECTED) {
+    Serial.println("[TASMOTA] WiFi disconnected, waiting...");
+    delay(100);
+    yield();
+    return false;
+  }
+  
+  // Yield to other tasks
+  yield();
+  delay(10);
+  
+  String url = "http://" + ip + "/cm?cmnd=" + urlEncode(command);
+  TasmotaTimeouts timeouts = tasmotaLinkTimeouts(ip);
+  bool hedge = tasmotaHedging && timeouts.p95Ms > 0;
+  
+  if (tasmotaDebug) {
+    if (attempt > 0) {
+      Serial.printf("[TASMOTA DEBUG] >> %s CMD: %s (retry %d)\n", ip.c_str(), command.c_str(), attempt);
+    } else {
+      Serial.printf("[TASMOTA DEBUG] >> %s CMD: %s\n", ip.c_str(), command.c_str());
+    }
+    Serial.printf("[TASMOTA DEBUG]    URL: %s (timeouts %u/%u ms%s)\n", url.c_str(),
+                  timeouts.connectMs, timeouts.readMs, hedge ? ", hedged" : "");
+  }
+  
+  int httpCode = hedge ? tasmotaHttpGetHedged(ip, url, timeouts, c->response)
+                       : tasmotaHttpGet(ip, url, timeouts, c->response);
+  
+  // Yield to other tasks after HTTP call
+  yield();
+  delay(5);
+  
+  if (httpCode == HTTP_CODE_OK) {
+    if (tasmotaDebug) {
+      Serial.printf("[TASMOTA DEBUG] << %s Response: %s\n", ip.c_str(), c->response.c_str());
+    }
+    return true;
+  }
+  if (tasmotaDebug) {
+    // Only log errors in debug mode to reduce serial spam
+    Serial.printf("[TASMOTA DEBUG] %s HTTP %d\n", ip.c_str(), httpCode);
+  }
+  c->response = "";
+  return false;
+}
+
+// Wait before retry (jittered backoff) with watchdog feeding
+static void tasmotaSendWait(void* ctx, int attempt) {
+  TasmotaSendContext* c = (TasmotaSendContext*)ctx;
+  Serial.printf("[TASMOTA] Retry %d for %s...\n", attempt, c->ip->c_str());
+  yield();
+  delay(tasmotaBackoffMs(attempt));
+  yield();
+}
+
+// `mode`: TASMOTA_SEND_PROBE for the background probe of an open circuit,
+// TASMOTA_SEND_ALWAYS for commands that must reach the plug (feeding stop).
+static String tasmotaSendCommand(const String& ip, const String& command, int retries = 3,
+                                 TasmotaSendMode mode = TASMOTA_SEND_NORMAL) {
+  TasmotaSendContext ctx;
+  ctx.addr = tasmotaIpToU32(ip);
+  ctx.scratch = TasmotaBreaker();
+  ctx.ip = &ip;
+  ctx.command = &command;
+  ctx.topic = tasmotaMqttTopicFor(ip);
+  
+  TasmotaCommandIo io = { &ctx, tasmotaSendLock, tasmotaSendUnlock, tasmotaSendNow,
+                          tasmotaSendAttempt, tasmotaSendWait };
+  TasmotaCommandOutcome out = tasmotaBreakerCommand(io, mode, retries);
+  
+  if (!out.sent) {
+    // Circuit open: failed instantly instead of waiting for timeouts
+    if (tasmotaDebug) {
+      Serial.printf("[TASMOTA DEBUG] %s circuit open - skipping CMD: %s\n", ip.c_str(), command.c_str());
     }
+  } else if (out.before == TASMOTA_BREAKER_CLOSED && out.after == TASMOTA_BREAKER_OPEN) {
+    Serial.printf("⊘ Tasmota %s: circuit open after %d failed commands\n", ip.c_str(), TASMOTA_BREAKER_THRESHOLD);
+  } else if (out.before != TASMOTA_BREAKER_CLOSED && out.after == TASMOTA_BREAKER_CLOSED) {
+    Serial.printf("✓ Tasmota %s: circuit closed - device reachable again\n", ip.c_str());
   }
   
   yield();
-  return response;  // Empty string on failure
+  return out.ok ? ctx.response : String("");  // Empty string on failure
+}
+
+// ============================================================
+// Parse a "Status" Response
+// ============================================================
+static bool tasmotaParseStatus(const String& ip, const char* json, TasmotaDevice& device) {
+  JsonDocument doc;
+  DeserializationError error = deserializeJson(doc, json);
+  
+  if (error) {
+    Serial.printf("  %s: JSON parse error: %s\n", ip.c_str(), error.c_str());
+    return false;
+  }
+  
+  // Check if it's a Tasmota device (has Status object with DeviceName or FriendlyName)
+  JsonObject status = doc["Status"];
+  if (status.isNull()) {
+    Serial.printf("  %s: No Status object in response\n", ip.c_str());
+    return false;
+  }
+  
+  device.ip = ip;
+  
+  // Get device name
+  if (status["DeviceName"].is<const char*>()) {
+    device.name = status["DeviceName"].as<String>();
+  } else if (status["FriendlyName"].is<JsonArray>() && status["FriendlyName"][0].is<const char*>()) {
+    device.name = status["FriendlyName"][0].as<String>();
+  } else {
+    device.name = "Tasmota";
+  }
+  
+  device.hostname = doc["StatusNET"]["Hostname"] | "";
+  device.topic = status["Topic"] | "";
+  device.reachable = true;
+  device.enabled = false;
+  
+  // Get power state from Status.Power
+  int power = status["Power"] | -1;
+  device.powerState = (power == 1);
+  
+  Serial.printf("  %s: Found! Name=%s, Power=%d\n", ip.c_str(), device.name.c_str(), power);
+  return true;
 }
 
 // ============================================================
@@ -162,75 +904,259 @@ static bool tasmotaCheckDevice(const String& ip, TasmotaDevice& device) {
   // Status command returns device info
   String url = "http://" + ip + "/cm?cmnd=Status";
   
-  http.begin(url);
-  http.setTimeout(2000);  // 2s timeout for weak WiFi
-  http.setConnectTimeout(1500);  // 1.5s connection timeout
+  http.begin(url);
+  http.setTimeout(2000);  // 2s timeout for weak WiFi
+  http.setConnectTimeout(1500);  // 1.5s connection timeout
+  
+  int httpCode = http.GET();
+  delay(10);  // Yield after HTTP
+  
+  if (httpCode == HTTP_CODE_OK) {
+    String response = http.getString();
+    http.end();
+    
+    // Debug output
+    Serial.printf("  %s: HTTP OK, parsing...\n", ip.c_str());
+    return tasmotaParseStatus(ip, response.c_str(), device);
+  } else if (httpCode > 0) {
+    Serial.printf("  %s: HTTP %d\n", ip.c_str(), httpCode);
+    http.end();
+  } else {
+    http.end();
+  }
+  
+  return false;
+}
+
+// ============================================================
+// Background Scan State (in DRAM to avoid cache issues)
+// ============================================================
+static DRAM_ATTR volatile bool tasmotaScanRunning = false;
+static DRAM_ATTR volatile bool tasmotaScanComplete = false;
+static DRAM_ATTR volatile int tasmotaScanProgress = 0;  // 0-254
+static DRAM_ATTR volatile int tasmotaScanFound = 0;
+static std::vector<TasmotaDevice> tasmotaScanResults;
+
+// ============================================================
+// Windowed Probe Engine
+// ============================================================
+// Discovery runs in two phases on non-blocking sockets, multiplexed
+// with select():
+//  1. Sweep: plain TCP connects to port 80 on every address. Dead
+//     addresses only cost a connect timeout shared by the whole window.
+//  2. Probe: the HTTP "Status" request, only to hosts that accepted.
+//
+// An empty /24 costs about ceil(253 / window) sweep connect timeouts:
+// 26 x 400 ms = ~10 s with the defaults (26 x 1500 ms = ~38 s before the
+// sweep had its own timeout). Window and sweep timeout are settings
+// (scanWindow / scanConnectMs); measure with test/bench/bench.py scan.
+
+#define TASMOTA_SWEEP_WINDOW       10     // Default concurrent connects in the sweep
+#define TASMOTA_SWEEP_CONNECT_MS   400    // Default sweep connect timeout (LAN RTT is a few ms)
+#define TASMOTA_SWEEP_CONNECT_MIN  100
+#define TASMOTA_SCAN_WINDOW        4      // Concurrent Status requests
+#define TASMOTA_SCAN_CONNECT_MS    1500   // Connect timeout per Status probe
+#define TASMOTA_SCAN_TIMEOUT_MS    3500   // Connect + response per Status probe
+#define TASMOTA_SCAN_MAX_RESPONSE  4096   // Status responses are ~1 KB
+#define TASMOTA_SCAN_MAX_WINDOW    10     // Largest of the two windows (lwIP has 16 sockets)
+
+static DRAM_ATTR volatile uint8_t tasmotaScanPhase = 0;     // 0 = sweep, 1 = probe
+static DRAM_ATTR unsigned long tasmotaScanSweepMs = 0;
+static DRAM_ATTR unsigned long tasmotaScanProbeMs = 0;
+static DRAM_ATTR int tasmotaScanResponders = 0;
+static DRAM_ATTR uint8_t tasmotaSweepWindow = TASMOTA_SWEEP_WINDOW;        // Setting
+static DRAM_ATTR uint16_t tasmotaSweepConnectMs = TASMOTA_SWEEP_CONNECT_MS;  // Setting
+static DRAM_ATTR uint8_t tasmotaScanSweepWindow = TASMOTA_SWEEP_WINDOW;    // Used by the running scan
+static DRAM_ATTR uint16_t tasmotaScanSweepConnectMs = TASMOTA_SWEEP_CONNECT_MS;
+
+static uint8_t tasmotaClampSweepWindow(int window) {
+  return constrain(window, 1, TASMOTA_SCAN_MAX_WINDOW);
+}
+
+static uint16_t tasmotaClampSweepConnectMs(int connectMs) {
+  return constrain(connectMs, TASMOTA_SWEEP_CONNECT_MIN, TASMOTA_SCAN_CONNECT_MS);
+}
+
+struct TasmotaProbe {
+  int fd;                   // -1 = slot free
+  uint8_t host;             // Last octet of the address
+  bool connected;           // Request sent, reading the response
+  unsigned long startedAt;
+  String response;
+};
+
+// Open a socket and start a non-blocking connect. Returns false if the
+// address failed right away (the probe is then finished).
+static bool tasmotaProbeStart(TasmotaProbe& probe, uint32_t addr, uint8_t host) {
+  probe.fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (probe.fd < 0) return false;
+  
+  lwip_fcntl(probe.fd, F_SETFL, lwip_fcntl(probe.fd, F_GETFL, 0) | O_NONBLOCK);
+  
+  struct sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(80);
+  sa.sin_addr.s_addr = addr;
+  
+  probe.host = host;
+  probe.connected = false;
+  probe.startedAt = millis();
+  probe.response = "";
+  
+  if (lwip_connect(probe.fd, (struct sockaddr*)&sa, sizeof(sa)) < 0 && errno != EINPROGRESS) {
+    lwip_close(probe.fd);
+    probe.fd = -1;
+    return false;
+  }
+  return true;
+}
+
+static void tasmotaProbeClose(TasmotaProbe& probe) {
+  if (probe.fd >= 0) lwip_close(probe.fd);
+  probe.fd = -1;
+  probe.response = "";
+}
+
+// Complete HTTP response (server closed the connection) -> device entry
+static bool tasmotaProbeParse(TasmotaProbe& probe, const String& ip, TasmotaDevice& device) {
+  int bodyStart = probe.response.indexOf("\r\n\r\n");
+  if (bodyStart < 0 || !probe.response.startsWith("HTTP/1.")) return false;
+  
+  int code = probe.response.substring(9, 12).toInt();
+  if (code != HTTP_CODE_OK) {
+    Serial.printf("  %s: HTTP %d\n", ip.c_str(), code);
+    return false;
+  }
+  return tasmotaParseStatus(ip, probe.response.c_str() + bodyStart + 4, device);
+}
+
+enum TasmotaProbeResult : uint8_t {
+  PROBE_PENDING,
+  PROBE_DEAD,       // No connection / no Tasmota
+  PROBE_ACCEPTED,   // Sweep: port 80 open
+  PROBE_FOUND       // Probe: Tasmota device added to the results
+};
+
+// Advance one probe after select()
+static TasmotaProbeResult tasmotaProbeStep(TasmotaProbe& probe, bool readable, bool writable,
+                                           bool sendStatus, unsigned long connectMs, const String& ip) {
+  unsigned long elapsed = millis() - probe.startedAt;
+  
+  if (!probe.connected) {
+    if (writable) {
+      int sockErr = 0;
+      socklen_t errLen = sizeof(sockErr);
+      lwip_getsockopt(probe.fd, SOL_SOCKET, SO_ERROR, &sockErr, &errLen);
+      if (sockErr != 0) return PROBE_DEAD;  // Refused / unreachable
+      if (!sendStatus) return PROBE_ACCEPTED;
+      
+      // HTTP/1.0: the device closes the connection after the response
+      String request = "GET /cm?cmnd=Status HTTP/1.0\r\nHost: " + ip + "\r\n\r\n";
+      if (lwip_send(probe.fd, request.c_str(), request.length(), 0) != (int)request.length()) return PROBE_DEAD;
+      probe.connected = true;
+      return PROBE_PENDING;
+    }
+    return elapsed > connectMs ? PROBE_DEAD : PROBE_PENDING;
+  }
+  
+  if (readable) {
+    char buf[512];
+    int n = lwip_recv(probe.fd, buf, sizeof(buf), 0);
+    if (n > 0) {
+      probe.response.concat(buf, n);
+      if (probe.response.length() < TASMOTA_SCAN_MAX_RESPONSE) return PROBE_PENDING;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return PROBE_PENDING;
+    }
+    
+    // Closed by the device (or buffer full) - response complete
+    TasmotaDevice device;
+    if (tasmotaProbeParse(probe, ip, device)) {
+      Serial.printf("✓ Found Tasmota: %s (%s)\n", device.name.c_str(), ip.c_str());
+      tasmotaScanResults.push_back(device);
+      tasmotaScanFound = tasmotaScanResults.size();
+      return PROBE_FOUND;
+    }
+    return PROBE_DEAD;
+  }
+  return elapsed > TASMOTA_SCAN_TIMEOUT_MS ? PROBE_DEAD : PROBE_PENDING;
+}
+
+// Run one phase over the given hosts (last octets). In the sweep, hosts
+// that accept the connection are collected in accepted[]. Every address
+// whose outcome is final advances tasmotaScanProgress. Returns false if
+// the scan was cancelled.
+static bool tasmotaRunProbes(const uint8_t* hosts, int count, int window, unsigned long connectMs,
+                             bool sendStatus, uint8_t* accepted, int* acceptedCount) {
+  IPAddress localIP = WiFi.localIP();
+  String baseIP = String(localIP[0]) + "." + String(localIP[1]) + "." + String(localIP[2]) + ".";
+  
+  TasmotaProbe probes[TASMOTA_SCAN_MAX_WINDOW];
+  if (window > TASMOTA_SCAN_MAX_WINDOW) window = TASMOTA_SCAN_MAX_WINDOW;
+  for (int p = 0; p < window; p++) probes[p].fd = -1;
   
-  int httpCode = http.GET();
-  delay(10);  // Yield after HTTP
+  int next = 0;
+  int done = 0;
   
-  if (httpCode == HTTP_CODE_OK) {
-    String response = http.getString();
-    http.end();
+  while (done < count) {
+    if (!tasmotaScanRunning) {
+      for (int p = 0; p < window; p++) tasmotaProbeClose(probes[p]);
+      return false;
+    }
     
-    // Debug output
-    Serial.printf("  %s: HTTP OK, parsing...\n", ip.c_str());
+    // Keep the window full
+    for (int p = 0; p < window && next < count; p++) {
+      if (probes[p].fd >= 0) continue;
+      
+      uint8_t host = hosts[next++];
+      IPAddress target(localIP[0], localIP[1], localIP[2], host);
+      if (!tasmotaProbeStart(probes[p], (uint32_t)target, host)) {
+        done++;
+        tasmotaScanProgress++;
+      }
+    }
     
-    // Parse JSON response
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, response);
+    // Wait for any probe to become ready
+    fd_set readSet, writeSet;
+    FD_ZERO(&readSet);
+    FD_ZERO(&writeSet);
+    int maxFd = -1;
+    for (int p = 0; p < window; p++) {
+      if (probes[p].fd < 0) continue;
+      FD_SET(probes[p].fd, probes[p].connected ? &readSet : &writeSet);
+      if (probes[p].fd > maxFd) maxFd = probes[p].fd;
+    }
     
-    if (error) {
-      Serial.printf("  %s: JSON parse error: %s\n", ip.c_str(), error.c_str());
-      return false;
+    if (maxFd >= 0) {
+      struct timeval tv = {0, 50000};  // 50 ms - also checks timeouts and cancel
+      lwip_select(maxFd + 1, &readSet, &writeSet, NULL, &tv);
+    } else if (next < count) {
+      vTaskDelay(pdMS_TO_TICKS(50));  // Out of sockets - retry shortly
     }
     
-    // Check if it's a Tasmota device (has Status object with DeviceName or FriendlyName)
-    JsonObject status = doc["Status"];
-    if (!status.isNull()) {
-      device.ip = ip;
+    for (int p = 0; p < window; p++) {
+      TasmotaProbe& probe = probes[p];
+      if (probe.fd < 0) continue;
       
-      // Get device name
-      if (status["DeviceName"].is<const char*>()) {
-        device.name = status["DeviceName"].as<String>();
-      } else if (status["FriendlyName"].is<JsonArray>() && status["FriendlyName"][0].is<const char*>()) {
-        device.name = status["FriendlyName"][0].as<String>();
+      String ip = baseIP + String(probe.host);
+      TasmotaProbeResult result = tasmotaProbeStep(probe, FD_ISSET(probe.fd, &readSet),
+                                                   FD_ISSET(probe.fd, &writeSet), sendStatus,
+                                                   connectMs, ip);
+      if (result == PROBE_PENDING) continue;
+      
+      if (result == PROBE_ACCEPTED) {
+        accepted[(*acceptedCount)++] = probe.host;  // Final after the Status probe
       } else {
-        device.name = "Tasmota";
+        tasmotaScanProgress++;
       }
-      
-      device.hostname = doc["StatusNET"]["Hostname"] | "";
-      device.reachable = true;
-      device.enabled = false;
-      
-      // Get power state from Status.Power
-      int power = status["Power"] | -1;
-      device.powerState = (power == 1);
-      
-      Serial.printf("  %s: Found! Name=%s, Power=%d\n", ip.c_str(), device.name.c_str(), power);
-      return true;
-    } else {
-      Serial.printf("  %s: No Status object in response\n", ip.c_str());
+      tasmotaProbeClose(probe);
+      done++;
     }
-  } else if (httpCode > 0) {
-    Serial.printf("  %s: HTTP %d\n", ip.c_str(), httpCode);
-    http.end();
-  } else {
-    http.end();
   }
-  
-  return false;
+  return true;
 }
 
-// ============================================================
-// Background Scan State (in DRAM to avoid cache issues)
-// ============================================================
-static DRAM_ATTR volatile bool tasmotaScanRunning = false;
-static DRAM_ATTR volatile bool tasmotaScanComplete = false;
-static DRAM_ATTR volatile int tasmotaScanProgress = 0;  // 0-254
-static DRAM_ATTR volatile int tasmotaScanFound = 0;
-static std::vector<TasmotaDevice> tasmotaScanResults;
-
 // ============================================================
 // Background Scan Task
 // ============================================================
@@ -240,43 +1166,51 @@ static void tasmotaScanTask(void* parameter) {
   tasmotaScanResults.clear();
   tasmotaScanProgress = 0;
   tasmotaScanFound = 0;
+  tasmotaScanPhase = 0;
+  tasmotaScanSweepMs = 0;
+  tasmotaScanProbeMs = 0;
+  tasmotaScanResponders = 0;
   
   // Get local IP
   IPAddress localIP = WiFi.localIP();
-  String baseIP = String(localIP[0]) + "." + String(localIP[1]) + "." + String(localIP[2]) + ".";
-  
-  Serial.printf("Scanning network: %s0/24\n", baseIP.c_str());
+  Serial.printf("Scanning network: %d.%d.%d.0/24\n", localIP[0], localIP[1], localIP[2]);
   
-  // Scan all IPs
+  uint8_t hosts[254];
+  uint8_t responders[254];
+  int hostCount = 0;
   for (int i = 1; i < 255; i++) {
-    if (!tasmotaScanRunning) {
-      Serial.println("Scan cancelled");
-      break;
-    }
-    
-    tasmotaScanProgress = i;
-    String ip = baseIP + String(i);
-    
-    // Skip our own IP
-    if (ip == localIP.toString()) continue;
-    
-    TasmotaDevice device;
-    if (tasmotaCheckDevice(ip, device)) {
-      Serial.printf("✓ Found Tasmota: %s (%s)\n", device.name.c_str(), ip.c_str());
-      tasmotaScanResults.push_back(device);
-      tasmotaScanFound = tasmotaScanResults.size();
-    }
-    
-    // Progress every 25 IPs
-    if (i % 25 == 0) {
-      Serial.printf("  Scanned %d/254 IPs... (found: %d)\n", i, tasmotaScanFound);
+    if (i == localIP[3]) {
+      tasmotaScanProgress++;  // Skip our own IP
+      continue;
     }
-    
-    // Small delay to be nice to other tasks
-    vTaskDelay(pdMS_TO_TICKS(10));
+    hosts[hostCount++] = i;
+  }
+  
+  // Phase 1: TCP sweep of port 80
+  unsigned long phaseStart = millis();
+  bool completed = tasmotaRunProbes(hosts, hostCount, tasmotaScanSweepWindow, tasmotaScanSweepConnectMs,
+                                    false, responders, &tasmotaScanResponders);
+  tasmotaScanSweepMs = millis() - phaseStart;
+  Serial.printf("  Sweep: %d/%d hosts accept port 80 (%lu ms, window %u, connect %u ms)\n",
+                tasmotaScanResponders, hostCount, tasmotaScanSweepMs,
+                tasmotaScanSweepWindow, tasmotaScanSweepConnectMs);
+  
+  // Phase 2: Status request to responders only
+  if (completed) {
+    tasmotaScanPhase = 1;
+    phaseStart = millis();
+    int unused = 0;
+    completed = tasmotaRunProbes(responders, tasmotaScanResponders, TASMOTA_SCAN_WINDOW,
+                                 TASMOTA_SCAN_CONNECT_MS, true, NULL, &unused);
+    tasmotaScanProbeMs = millis() - phaseStart;
+  }
+  
+  if (!completed) {
+    Serial.println("Scan cancelled");
   }
   
-  Serial.printf("=== Scan complete: %d devices found ===\n\n", tasmotaScanResults.size());
+  Serial.printf("=== Scan complete: %d devices found in %lu ms ===\n\n",
+                tasmotaScanResults.size(), tasmotaScanSweepMs + tasmotaScanProbeMs);
   
   tasmotaScanRunning = false;
   tasmotaScanComplete = true;
@@ -288,13 +1222,17 @@ static void tasmotaScanTask(void* parameter) {
 // ============================================================
 // Start Network Scan (non-blocking)
 // ============================================================
-static String tasmotaStartScan() {
+// Sweep with the given window / connect timeout instead of the settings
+// (test/bench/bench.py scan compares them)
+static String tasmotaStartScanWith(int window, int connectMs) {
   if (tasmotaScanRunning) {
     return "{\"success\":false,\"message\":\"Scan already running\"}";
   }
   
   tasmotaScanRunning = true;
   tasmotaScanComplete = false;
+  tasmotaScanSweepWindow = tasmotaClampSweepWindow(window);
+  tasmotaScanSweepConnectMs = tasmotaClampSweepConnectMs(connectMs);
   
   // Create background task with lower priority
   xTaskCreatePinnedToCore(
@@ -310,6 +1248,10 @@ static String tasmotaStartScan() {
   return "{\"success\":true,\"message\":\"Scan started\"}";
 }
 
+static String tasmotaStartScan() {
+  return tasmotaStartScanWith(tasmotaSweepWindow, tasmotaSweepConnectMs);
+}
+
 // ============================================================
 // Get Scan Results
 // ============================================================
@@ -321,11 +1263,20 @@ static String tasmotaGetScanResults() {
     doc["scanning"] = true;
     doc["progress"] = tasmotaScanProgress;
     doc["found"] = tasmotaScanFound;
+    doc["phase"] = tasmotaScanPhase == 0 ? "sweep" : "probe";
     doc["message"] = "Scan in progress...";
   } else if (tasmotaScanComplete) {
     doc["success"] = true;
     doc["scanning"] = false;
     doc["count"] = tasmotaScanResults.size();
+    doc["responders"] = tasmotaScanResponders;
+    
+    JsonObject timing = doc["timing"].to<JsonObject>();
+    timing["sweep_ms"] = tasmotaScanSweepMs;
+    timing["probe_ms"] = tasmotaScanProbeMs;
+    timing["total_ms"] = tasmotaScanSweepMs + tasmotaScanProbeMs;
+    timing["sweep_window"] = tasmotaScanSweepWindow;
+    timing["sweep_connect_ms"] = tasmotaScanSweepConnectMs;
     
     JsonArray devices = doc["devices"].to<JsonArray>();
     for (const auto& dev : tasmotaScanResults) {
@@ -333,6 +1284,7 @@ static String tasmotaGetScanResults() {
       d["ip"] = dev.ip;
       d["name"] = dev.name;
       d["hostname"] = dev.hostname;
+      d["topic"] = dev.topic;
       d["powerState"] = dev.powerState;
       d["reachable"] = true;
       d["enabled"] = false;
@@ -353,213 +1305,663 @@ static String tasmotaGetScanResults() {
   return result;
 }
 
-// Legacy function - now starts background scan
-static String tasmotaScanNetwork() {
-  return tasmotaStartScan();
+// Legacy function - now starts background scan
+static String tasmotaScanNetwork() {
+  return tasmotaStartScan();
+}
+
+// ============================================================
+// Get Power State of a Device (using Status 0 to not affect PulseTime)
+// Returns: 1 = ON, 0 = OFF, -1 = error/unknown
+// ============================================================
+// `topic` (optional) receives the MQTT topic reported by the device.
+// `probe` sends it as the background probe of an open circuit.
+static int tasmotaGetPowerStateEx(const String& ip, String* topic = NULL, bool probe = false) {
+  // Use "Status 0" instead of "Power" to avoid resetting PulseTime timer
+  String response = tasmotaSendCommand(ip, "Status 0", 3, probe ? TASMOTA_SEND_PROBE : TASMOTA_SEND_NORMAL);
+  
+  if (response.length() == 0) {
+    return -1;  // Error - no response
+  }
+  
+  JsonDocument doc;
+  if (deserializeJson(doc, response) == DeserializationError::Ok) {
+    if (topic) *topic = doc["Status"]["Topic"] | "";
+    
+    // Try StatusSTS.POWER first (most reliable, string "ON"/"OFF")
+    if (doc["StatusSTS"].is<JsonObject>()) {
+      String stspower = doc["StatusSTS"]["POWER"] | "";
+      if (tasmotaDebug) Serial.printf("[TASMOTA DEBUG] StatusSTS.POWER = '%s'\n", stspower.c_str());
+      if (stspower == "ON") return 1;
+      if (stspower == "OFF") return 0;
+    }
+    
+    // Try Status.Power (can be int or string depending on Tasmota version)
+    if (doc["Status"].is<JsonObject>()) {
+      JsonVariant pv = doc["Status"]["Power"];
+      if (pv.is<int>()) {
+        int power = pv.as<int>();
+        if (tasmotaDebug) Serial.printf("[TASMOTA DEBUG] Status.Power (int) = %d\n", power);
+        if (power == 1) return 1;
+        if (power == 0) return 0;
+      } else if (pv.is<const char*>()) {
+        String powerStr = pv.as<String>();
+        if (tasmotaDebug) Serial.printf("[TASMOTA DEBUG] Status.Power (str) = '%s'\n", powerStr.c_str());
+        if (powerStr == "1" || powerStr == "ON") return 1;
+        if (powerStr == "0" || powerStr == "OFF") return 0;
+      }
+    }
+    
+    // Fallback: try direct POWER field (for simple Power command response)
+    String powerStr = doc["POWER"] | doc["POWER1"] | "";
+    if (powerStr.length() > 0) {
+      if (tasmotaDebug) Serial.printf("[TASMOTA DEBUG] POWER field = '%s'\n", powerStr.c_str());
+      if (powerStr == "ON") return 1;
+      if (powerStr == "OFF") return 0;
+    }
+  }
+  
+  return -1;  // Error - invalid response
+}
+
+// Legacy wrapper for compatibility
+static bool tasmotaGetPowerState(const String& ip) {
+  int state = tasmotaGetPowerStateEx(ip);
+  return (state == 1);
+}
+
+// ============================================================
+// Command Batching (Backlog0)
+// ============================================================
+// A power change used to take 2-4 separate requests per device
+// (PowerOnState, PulseTime, Power). "Backlog0" runs the whole sequence
+// in one request without the inter-command delay of "Backlog" and
+// answers with the merged results, e.g.
+//   {"PowerOnState":5,"PulseTime":{"Set":1000,"Remaining":0},"POWER":"OFF"}
+// Firmware without Backlog0 answers {"Command":"Unknown"} or without the
+// merged results. Such devices are remembered and get one request per
+// command, as before.
+
+#define TASMOTA_BACKLOG_MAX_LEGACY  16    // Remembered devices without Backlog0
+
+static uint32_t tasmotaBacklogLegacy[TASMOTA_BACKLOG_MAX_LEGACY];
+static int tasmotaBacklogLegacyCount = 0;
+static portMUX_TYPE tasmotaBacklogMux = portMUX_INITIALIZER_UNLOCKED;
+
+static bool tasmotaBacklogSupported(const String& ip) {
+  uint32_t addr = tasmotaIpToU32(ip);
+  bool supported = true;
+  portENTER_CRITICAL(&tasmotaBacklogMux);
+  for (int i = 0; i < tasmotaBacklogLegacyCount; i++) {
+    if (tasmotaBacklogLegacy[i] == addr) {
+      supported = false;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&tasmotaBacklogMux);
+  return supported;
+}
+
+static void tasmotaBacklogMarkLegacy(const String& ip) {
+  uint32_t addr = tasmotaIpToU32(ip);
+  portENTER_CRITICAL(&tasmotaBacklogMux);
+  bool known = false;
+  for (int i = 0; i < tasmotaBacklogLegacyCount; i++) {
+    if (tasmotaBacklogLegacy[i] == addr) known = true;
+  }
+  if (!known && tasmotaBacklogLegacyCount < TASMOTA_BACKLOG_MAX_LEGACY) {
+    tasmotaBacklogLegacy[tasmotaBacklogLegacyCount++] = addr;
+  }
+  portEXIT_CRITICAL(&tasmotaBacklogMux);
+  Serial.printf("⚠ Tasmota %s: Backlog0 not supported, sending commands one by one\n", ip.c_str());
+}
+
+// Power state reported in a command response: 1 = ON, 0 = OFF, -1 = none
+static int tasmotaResponsePower(const String& response) {
+  if (response.length() == 0) return -1;
+  
+  JsonDocument doc;
+  if (deserializeJson(doc, response) != DeserializationError::Ok) return -1;
+  
+  String power = doc["POWER"] | doc["POWER1"] | "";
+  if (power == "ON") return 1;
+  if (power == "OFF") return 0;
+  return -1;
+}
+
+// Send commands as one Backlog0 request (or one by one on legacy firmware).
+// The last command gets `lastRetries` attempts, the others 2 each.
+// Returns the merged response, or that of the last command on fallback.
+static String tasmotaSendBatch(const String& ip, const String* commands, int count,
+                               bool expectPower, int lastRetries = 3,
+                               TasmotaSendMode mode = TASMOTA_SEND_NORMAL) {
+  if (count <= 0) return "";
+  if (count == 1) return tasmotaSendCommand(ip, commands[0], lastRetries, mode);
+  
+  if (tasmotaBacklogSupported(ip)) {
+    String backlog = "Backlog0 ";
+    for (int i = 0; i < count; i++) {
+      if (i > 0) backlog += ";";
+      backlog += commands[i];
+    }
+    
+    String response = tasmotaSendCommand(ip, backlog, lastRetries, mode);
+    if (response.length() == 0) return response;  // Device unreachable - no fallback
+    
+    bool unknown = response.indexOf("\"Unknown\"") >= 0;
+    bool merged = !expectPower || tasmotaResponsePower(response) >= 0;
+    if (!unknown && merged) return response;
+    
+    tasmotaBacklogMarkLegacy(ip);
+  }
+  
+  String response;
+  for (int i = 0; i < count; i++) {
+    response = tasmotaSendCommand(ip, commands[i], i == count - 1 ? lastRetries : 2, mode);
+  }
+  return response;
+}
+
+// Run setup commands followed by "Power ON/OFF" in one request.
+// Returns true if the device reports the requested power state.
+#define TASMOTA_BATCH_MAX  6     // Commands per batch including the power command
+
+static bool tasmotaPowerBatch(const String& ip, const String* setup, int setupCount, bool on,
+                              String* responseOut = NULL,
+                              TasmotaSendMode mode = TASMOTA_SEND_NORMAL) {
+  String commands[TASMOTA_BATCH_MAX];
+  int count = 0;
+  for (int i = 0; i < setupCount && count < TASMOTA_BATCH_MAX - 1; i++) {
+    commands[count++] = setup[i];
+  }
+  commands[count++] = on ? "Power ON" : "Power OFF";
+  
+  String response = tasmotaSendBatch(ip, commands, count, true, 3, mode);  // 3 retries
+  if (responseOut) *responseOut = response;
+  return tasmotaResponsePower(response) == (on ? 1 : 0);
+}
+
+// ============================================================
+// Completion Event Rule
+// ============================================================
+// While feeding, a rule on the plug reports every power change to
+// /api/tasmota-event via WebQuery. The auto-on is then seen immediately
+// instead of on the next poll. The rule is sent together with the power
+// command; it is only considered armed if the merged response shows it
+// enabled (firmware without rules/WebQuery keeps the faster polling).
+// Rule3 is used so that the commonly used Rule1 stays untouched.
+
+#define TASMOTA_EVENT_RULE  "Rule3"
+
+static int tasmotaEventRuleCommands(String* out) {
+  String url = "http://" + WiFi.localIP().toString() + "/api/tasmota-event?power=%value%";
+  out[0] = String(TASMOTA_EVENT_RULE) + " ON Power1#State DO WebQuery " + url + " GET ENDON";
+  out[1] = String(TASMOTA_EVENT_RULE) + " 1";
+  return 2;
+}
+
+static bool tasmotaResponseRuleArmed(const String& response) {
+  JsonDocument doc;
+  if (deserializeJson(doc, response) != DeserializationError::Ok) return false;
+  String state = doc[TASMOTA_EVENT_RULE]["State"] | "";
+  return state == "ON";
+}
+
+// ============================================================
+// Turn Device ON (with retry)
+// ============================================================
+// If `armed` is given, the completion rule is installed in the same request.
+static bool tasmotaTurnOn(const String& ip, bool* armed = NULL) {
+  Serial.printf("Tasmota %s: Turning ON\n", ip.c_str());
+  if (!armed) return tasmotaPowerBatch(ip, NULL, 0, true);
+  
+  String setup[2];
+  int setupCount = tasmotaEventRuleCommands(setup);
+  String response;
+  bool ok = tasmotaPowerBatch(ip, setup, setupCount, true, &response);
+  *armed = tasmotaResponseRuleArmed(response);
+  return ok;
+}
+
+// ============================================================
+// Turn Device OFF (with optional PulseTime for auto-on)
+// ============================================================
+// If `armed` is given, the completion rule is installed in the same request.
+// Commands that precede "Power OFF": auto-on after `autoOnSeconds` or none
+static int tasmotaAutoOnSetup(int autoOnSeconds, String* out) {
+  if (autoOnSeconds > 0) {
+    // Use PowerOnState 5 (inverted PulseTime) for auto-on after OFF
+    // PulseTime 112-64900 = 1-64788 seconds (value - 100 = seconds)
+    int pulseValue = autoOnSeconds + 100;
+    if (pulseValue > 64900) pulseValue = 64900;
+    
+    // Set PowerOnState 5 = inverted PulseTime (OFF -> wait -> ON), then PulseTime
+    out[0] = "PowerOnState 5";
+    out[1] = "PulseTime " + String(pulseValue);
+    return 2;
+  }
+  
+  // Disable auto-on
+  out[0] = "PulseTime 0";
+  return 1;
+}
+
+static bool tasmotaTurnOff(const String& ip, int autoOnSeconds = 0, bool* armed = NULL) {
+  Serial.printf("Tasmota %s: Turning OFF", ip.c_str());
+  if (autoOnSeconds > 0) {
+    Serial.printf(" (auto-on in %d sec via PowerOnState 5)\n", autoOnSeconds);
+  } else {
+    Serial.println();
+  }
+  
+  String setup[4];
+  int setupCount = tasmotaAutoOnSetup(autoOnSeconds, setup);
+  
+  if (!armed) return tasmotaPowerBatch(ip, setup, setupCount, false);
+  
+  setupCount += tasmotaEventRuleCommands(setup + setupCount);
+  String response;
+  bool ok = tasmotaPowerBatch(ip, setup, setupCount, false, &response);
+  *armed = tasmotaResponseRuleArmed(response);
+  return ok;
+}
+
+// ============================================================
+// Concurrent Device Dispatch
+// ============================================================
+// All enabled devices are driven at the same time by a small worker
+// pool, so the total time of a start/stop is that of the slowest
+// device instead of the sum. The commands for one device stay in order.
+// Workers only see a snapshot of the device list; results are written
+// back after all workers are done.
+
+#define TASMOTA_DISPATCH_WORKERS   4      // Devices handled in parallel
+#define TASMOTA_DISPATCH_STACK     6144
+#define TASMOTA_DISPATCH_PRIORITY  2
+
+struct TasmotaDispatchItem {
+  String ip;
+  String name;
+  bool turnOn;
+  bool armed;               // Completion rule installed (start) / to remove (stop)
+  bool prepareOnly;         // Device group member: setup only, the group packet switches it
+  bool ok;
+  unsigned long elapsedMs;
+};
+
+struct TasmotaDispatch {
+  TasmotaDispatchItem* items;
+  int count;
+  int next;                 // Next item to take (guarded by tasmotaDispatchMux)
+  bool starting;            // true = start feeding, false = stop feeding
+  SemaphoreHandle_t done;   // Given by each worker task when it finishes
+};
+
+static portMUX_TYPE tasmotaDispatchMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Start feeding for one device - turn OFF/ON based on setting
+static bool tasmotaStartDevice(TasmotaDispatchItem& item) {
+  // Install the completion rule unless power changes already arrive via MQTT
+  item.armed = false;
+  bool* arm = tasmotaMqttTopicFor(item.ip).length() > 0 ? NULL : &item.armed;
+  
+  if (item.turnOn) {
+    // Turn ON during feeding (inverted)
+    if (tasmotaTurnOn(item.ip, arm)) {
+      Serial.printf("✓ %s (%s) turned ON (inverted)\n", item.name.c_str(), item.ip.c_str());
+      return true;
+    }
+    Serial.printf("✗ %s (%s) failed to turn ON\n", item.name.c_str(), item.ip.c_str());
+    return false;
+  }
+  
+  // Turn OFF during feeding (normal) with PulseTime for automatic turn-on
+  if (tasmotaTurnOff(item.ip, tasmotaPulseTime, arm)) {
+    Serial.printf("✓ %s (%s) turned OFF\n", item.name.c_str(), item.ip.c_str());
+    return true;
+  }
+  Serial.printf("✗ %s (%s) failed to turn OFF\n", item.name.c_str(), item.ip.c_str());
+  return false;
+}
+
+// Commands that precede the power command when feeding stops
+static int tasmotaRestoreSetup(bool armed, String* out) {
+  // Disable auto-on: PulseTime 0 and restore PowerOnState 3 ("last state").
+  // The completion rule is disabled first so the power change is not reported.
+  int count = 0;
+  if (armed) out[count++] = String(TASMOTA_EVENT_RULE) + " 0";
+  out[count++] = "PulseTime 0";
+  out[count++] = "PowerOnState 3";
+  return count;
+}
+
+// Stop feeding for one device - reverse the action. Sent even if the
+// circuit is open (tasmotaFeedingSendMode).
+static bool tasmotaStopDevice(TasmotaDispatchItem& item) {
+  TasmotaSendMode mode = tasmotaFeedingSendMode(false);
+  
+  // Restore settings in the same request as the power command
+  String setup[3];
+  int setupCount = tasmotaRestoreSetup(item.armed, setup);
+  
+  if (item.turnOn) {
+    // Was ON during feeding, turn OFF now (inverted)
+    if (tasmotaPowerBatch(item.ip, setup, setupCount, false, NULL, mode)) {
+      Serial.printf("✓ %s (%s) turned OFF (inverted)\n", item.name.c_str(), item.ip.c_str());
+      return true;
+    }
+    Serial.printf("✗ %s (%s) failed to turn OFF\n", item.name.c_str(), item.ip.c_str());
+    return false;
+  }
+  
+  // Was OFF during feeding, turn ON now (normal)
+  if (tasmotaPowerBatch(item.ip, setup, setupCount, true, NULL, mode)) {
+    Serial.printf("✓ %s (%s) turned ON\n", item.name.c_str(), item.ip.c_str());
+    return true;
+  }
+  Serial.printf("✗ %s (%s) failed to turn ON\n", item.name.c_str(), item.ip.c_str());
+  return false;
+}
+
+// Device group member: send everything except the power command, which
+// follows for the whole group as one multicast packet
+static bool tasmotaPrepareDevice(TasmotaDispatchItem& item, bool starting) {
+  String commands[5];
+  int count = 0;
+  
+  if (starting) {
+    bool arm = tasmotaMqttTopicFor(item.ip).length() == 0;
+    if (!item.turnOn) count += tasmotaAutoOnSetup(tasmotaPulseTime, commands + count);
+    if (arm) count += tasmotaEventRuleCommands(commands + count);
+    item.armed = false;
+    if (count == 0) return true;
+    
+    String response = tasmotaSendBatch(item.ip, commands, count, false);
+    if (arm) item.armed = tasmotaResponseRuleArmed(response);
+    if (response.length() == 0) {
+      Serial.printf("✗ %s (%s) failed to prepare\n", item.name.c_str(), item.ip.c_str());
+      return false;
+    }
+    return true;
+  }
+  
+  count = tasmotaRestoreSetup(item.armed, commands);
+  if (tasmotaSendBatch(item.ip, commands, count, false, 3, tasmotaFeedingSendMode(false)).length() == 0) {
+    Serial.printf("✗ %s (%s) failed to prepare\n", item.name.c_str(), item.ip.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Take items until the list is exhausted
+static void tasmotaDispatchRun(TasmotaDispatch* dispatch) {
+  for (;;) {
+    portENTER_CRITICAL(&tasmotaDispatchMux);
+    int i = dispatch->next < dispatch->count ? dispatch->next++ : -1;
+    portEXIT_CRITICAL(&tasmotaDispatchMux);
+    if (i < 0) break;
+    
+    TasmotaDispatchItem& item = dispatch->items[i];
+    unsigned long start = millis();
+    if (tasmotaFeedingSendMode(dispatch->starting) == TASMOTA_SEND_NORMAL &&
+        tasmotaBreakerState(item.ip) != TASMOTA_BREAKER_CLOSED) {
+      // Known dead device - skip the start instead of waiting for timeouts.
+      // A stop is always sent: a skipped stop leaves the plug off.
+      Serial.printf("⊘ %s (%s) skipped - circuit open\n", item.name.c_str(), item.ip.c_str());
+      item.ok = false;
+    } else if (item.prepareOnly) {
+      item.ok = tasmotaPrepareDevice(item, dispatch->starting);
+    } else {
+      item.ok = dispatch->starting ? tasmotaStartDevice(item) : tasmotaStopDevice(item);
+    }
+    item.elapsedMs = millis() - start;
+  }
+}
+
+static void tasmotaDispatchWorker(void* param) {
+  TasmotaDispatch* dispatch = (TasmotaDispatch*)param;
+  tasmotaDispatchRun(dispatch);
+  xSemaphoreGive(dispatch->done);
+  vTaskDelete(NULL);
 }
 
-// ============================================================
-// Get Power State of a Device (using Status 0 to not affect PulseTime)
-// Returns: 1 = ON, 0 = OFF, -1 = error/unknown
-// ============================================================
-static int tasmotaGetPowerStateEx(const String& ip) {
-  // Use "Status 0" instead of "Power" to avoid resetting PulseTime timer
-  String response = tasmotaSendCommand(ip, "Status 0");
+// Run the items on the worker pool; returns the number of workers used
+static int tasmotaDispatchItems(std::vector<TasmotaDispatchItem>& items, bool starting) {
+  TasmotaDispatch dispatch;
+  dispatch.items = items.data();
+  dispatch.count = items.size();
+  dispatch.next = 0;
+  dispatch.starting = starting;
+  dispatch.done = xSemaphoreCreateCounting(TASMOTA_DISPATCH_WORKERS, 0);
   
-  if (response.length() == 0) {
-    return -1;  // Error - no response
+  // The calling task is one of the workers
+  int workers = min((int)items.size(), TASMOTA_DISPATCH_WORKERS);
+  int spawned = 0;
+  for (int w = 1; w < workers && dispatch.done; w++) {
+    BaseType_t created = xTaskCreatePinnedToCore(
+      tasmotaDispatchWorker,      // Task function
+      "tasmota_dispatch",         // Name
+      TASMOTA_DISPATCH_STACK,     // Stack size
+      &dispatch,                  // Parameters
+      TASMOTA_DISPATCH_PRIORITY,  // Priority
+      NULL,                       // Task handle
+      0                           // Core 0
+    );
+    if (created == pdPASS) spawned++;
   }
   
-  JsonDocument doc;
-  if (deserializeJson(doc, response) == DeserializationError::Ok) {
-    // Try StatusSTS.POWER first (most reliable, string "ON"/"OFF")
-    if (doc["StatusSTS"].is<JsonObject>()) {
-      String stspower = doc["StatusSTS"]["POWER"] | "";
-      if (tasmotaDebug) Serial.printf("[TASMOTA DEBUG] StatusSTS.POWER = '%s'\n", stspower.c_str());
-      if (stspower == "ON") return 1;
-      if (stspower == "OFF") return 0;
-    }
-    
-    // Try Status.Power (can be int or string depending on Tasmota version)
-    if (doc["Status"].is<JsonObject>()) {
-      JsonVariant pv = doc["Status"]["Power"];
-      if (pv.is<int>()) {
-        int power = pv.as<int>();
-        if (tasmotaDebug) Serial.printf("[TASMOTA DEBUG] Status.Power (int) = %d\n", power);
-        if (power == 1) return 1;
-        if (power == 0) return 0;
-      } else if (pv.is<const char*>()) {
-        String powerStr = pv.as<String>();
-        if (tasmotaDebug) Serial.printf("[TASMOTA DEBUG] Status.Power (str) = '%s'\n", powerStr.c_str());
-        if (powerStr == "1" || powerStr == "ON") return 1;
-        if (powerStr == "0" || powerStr == "OFF") return 0;
-      }
+  tasmotaDispatchRun(&dispatch);
+  for (int w = 0; w < spawned; w++) {
+    xSemaphoreTake(dispatch.done, portMAX_DELAY);
+  }
+  if (dispatch.done) vSemaphoreDelete(dispatch.done);
+  return spawned + 1;
+}
+
+// Switch the device group members with one packet after their setup was
+// sent. Members that do not acknowledge are switched individually.
+static void tasmotaDispatchGroup(std::vector<TasmotaDispatchItem>& items, bool starting) {
+  std::vector<int> members;
+  for (size_t i = 0; i < items.size(); i++) {
+    if (items[i].prepareOnly) members.push_back(i);
+  }
+  if (members.empty()) return;
+  
+  // Start: turnOn devices are ON, others OFF - stop reverses it
+  bool on = (items[members[0]].turnOn == starting);
+  uint32_t acked[TASMOTA_GROUP_MAX_MEMBERS];
+  int ackCount = tasmotaGroupSendPower(on, acked, TASMOTA_GROUP_MAX_MEMBERS);
+  
+  std::vector<TasmotaDispatchItem> retry;
+  std::vector<int> retryIndex;
+  for (int i : members) {
+    uint32_t addr = tasmotaIpToU32(items[i].ip);
+    bool ack = false;
+    for (int a = 0; a < ackCount; a++) {
+      if (acked[a] == addr) ack = true;
     }
+    if (ack) continue;
     
-    // Fallback: try direct POWER field (for simple Power command response)
-    String powerStr = doc["POWER"] | doc["POWER1"] | "";
-    if (powerStr.length() > 0) {
-      if (tasmotaDebug) Serial.printf("[TASMOTA DEBUG] POWER field = '%s'\n", powerStr.c_str());
-      if (powerStr == "ON") return 1;
-      if (powerStr == "OFF") return 0;
-    }
+    Serial.printf("⚠ %s (%s) did not acknowledge the group - switching directly\n",
+                  items[i].name.c_str(), items[i].ip.c_str());
+    TasmotaDispatchItem item = items[i];
+    item.prepareOnly = false;
+    retry.push_back(item);
+    retryIndex.push_back(i);
   }
+  if (retry.empty()) return;
   
-  return -1;  // Error - invalid response
-}
-
-// Legacy wrapper for compatibility
-static bool tasmotaGetPowerState(const String& ip) {
-  int state = tasmotaGetPowerStateEx(ip);
-  return (state == 1);
+  tasmotaDispatchItems(retry, starting);
+  for (size_t r = 0; r < retry.size(); r++) {
+    TasmotaDispatchItem& item = items[retryIndex[r]];
+    item.ok = retry[r].ok;
+    item.armed = retry[r].armed;
+    item.elapsedMs += retry[r].elapsedMs;
+  }
 }
 
-// ============================================================
-// Turn Device ON (with retry)
-// ============================================================
-static bool tasmotaTurnOn(const String& ip) {
-  Serial.printf("Tasmota %s: Turning ON\n", ip.c_str());
-  String response = tasmotaSendCommand(ip, "Power ON", 3);  // 3 retries
-  return response.indexOf("ON") >= 0;
+// Marks the items the group packet will switch and returns their number,
+// 0 if the group cannot be used: every learned member must be one of the
+// items and all must share one action
+static int tasmotaGroupSelect(std::vector<TasmotaDispatchItem>& items) {
+  uint32_t members[TASMOTA_GROUP_MAX_MEMBERS];
+  int memberCount = tasmotaGroupGetMembers(members, TASMOTA_GROUP_MAX_MEMBERS);
+  if (memberCount == 0) return 0;
+  
+  const TasmotaDispatchItem* first = NULL;
+  for (int m = 0; m < memberCount; m++) {
+    const TasmotaDispatchItem* match = NULL;
+    for (const auto& item : items) {
+      if (tasmotaIpToU32(item.ip) == members[m]) match = &item;
+    }
+    if (!match) {
+      Serial.printf("⚠ Device group member %s is not an enabled device - switching individually\n",
+                    IPAddress(members[m]).toString().c_str());
+      return 0;
+    }
+    if (first && match->turnOn != first->turnOn) {
+      Serial.println("⚠ Device group members have different actions - switching individually");
+      return 0;
+    }
+    first = match;
+  }
+  
+  for (auto& item : items) {
+    uint32_t addr = tasmotaIpToU32(item.ip);
+    for (int m = 0; m < memberCount; m++) {
+      if (members[m] == addr) item.prepareOnly = true;
+    }
+  }
+  return memberCount;
 }
 
-// ============================================================
-// Turn Device OFF (with optional PulseTime for auto-on)
-// ============================================================
-static bool tasmotaTurnOff(const String& ip, int autoOnSeconds = 0) {
-  Serial.printf("Tasmota %s: Turning OFF", ip.c_str());
+// Drive all enabled devices concurrently. Returns true if all succeeded.
+// Bumps the device generation before and after, so a poll that overlaps
+// the dispatch cannot write back states from before the command.
+static bool tasmotaDispatchAll(bool starting) {
+  std::vector<TasmotaDispatchItem> items;
+  tasmotaDevicesLock();
+  tasmotaDeviceGeneration++;
+  for (auto& device : tasmotaDevices) {
+    if (starting) device.feedingSeen = false;
+    if (device.enabled) {
+      items.push_back({device.ip, device.name, device.turnOn, device.eventArmed, false, false, 0});
+    }
+  }
+  tasmotaDevicesUnlock();
+  if (items.empty()) return true;
   
-  if (autoOnSeconds > 0) {
-    // Use PowerOnState 5 (inverted PulseTime) for auto-on after OFF
-    // PulseTime 112-64900 = 1-64788 seconds (value - 100 = seconds)
-    int pulseValue = autoOnSeconds + 100;
-    if (pulseValue > 64900) pulseValue = 64900;
-    
-    Serial.printf(" (auto-on in %d sec via PowerOnState 5)\n", autoOnSeconds);
-    
-    // Set PowerOnState 5 = inverted PulseTime (OFF -> wait -> ON)
-    tasmotaSendCommand(ip, "PowerOnState 5", 2);
+  unsigned long start = millis();
+  
+  // Device group fast path: the packet switches every learned member, so
+  // each one must be an enabled device here and all must take the same
+  // action. Otherwise every device is switched individually.
+  int groupMembers = tasmotaGroupReady() ? tasmotaGroupSelect(items) : 0;
+  
+  int workers = tasmotaDispatchItems(items, starting);
+  if (groupMembers > 0) tasmotaDispatchGroup(items, starting);
+  
+  // Aggregate results and write them back to the device list
+  bool allOk = true;
+  tasmotaDevicesLock();
+  tasmotaDeviceGeneration++;
+  for (const auto& item : items) {
+    allOk = allOk && item.ok;
+    Serial.printf("  %-16s %-20s %s %5lu ms%s\n", item.ip.c_str(), item.name.c_str(),
+                  item.ok ? "✓" : "✗", item.elapsedMs,
+                  starting && item.armed ? " (event rule armed)" : "");
     
-    // Set PulseTime
-    String cmd = "PulseTime " + String(pulseValue);
-    tasmotaSendCommand(ip, cmd, 2);
-  } else {
-    Serial.println();
-    // Disable auto-on
-    tasmotaSendCommand(ip, "PulseTime 0", 2);
+    for (auto& device : tasmotaDevices) {
+      if (device.ip != item.ip) continue;
+      device.actionOk = item.ok;
+      device.actionMs = item.elapsedMs;
+      device.reachable = tasmotaBreakerState(device.ip) == TASMOTA_BREAKER_CLOSED;
+      device.eventArmed = starting && item.ok && item.armed;
+      if (item.ok) {
+        // Start: turnOn devices are ON, others OFF - stop reverses it
+        device.powerState = (device.turnOn == starting);
+      }
+    }
   }
+  tasmotaDevicesUnlock();
   
-  String response = tasmotaSendCommand(ip, "Power OFF", 3);  // 3 retries for Power OFF
-  return response.indexOf("OFF") >= 0;
+  Serial.printf("  %d device(s) in %lu ms (%d workers, %d via device group)\n", items.size(),
+                millis() - start, workers, groupMembers);
+  return allOk;
 }
 
 // ============================================================
 // Start Feeding Mode - Turn OFF/ON selected devices based on setting
 // ============================================================
-void tasmotaStartFeeding() {
-  if (!tasmotaEnabled || tasmotaDevices.empty()) {
+bool tasmotaStartFeeding() {
+  if (!tasmotaEnabled || tasmotaDeviceCount() == 0) {
     Serial.println("⊘ Tasmota disabled or no devices configured");
-    return;
+    return true;
   }
   
   Serial.println("\n=== Tasmota: Starting Feeding Mode ===");
-  
-  for (auto& device : tasmotaDevices) {
-    if (device.enabled) {
-      if (device.turnOn) {
-        // Turn ON during feeding (inverted)
-        if (tasmotaTurnOn(device.ip)) {
-          device.powerState = true;
-          Serial.printf("✓ %s (%s) turned ON (inverted)\n", device.name.c_str(), device.ip.c_str());
-        } else {
-          Serial.printf("✗ %s (%s) failed to turn ON\n", device.name.c_str(), device.ip.c_str());
-        }
-      } else {
-        // Turn OFF during feeding (normal) with PulseTime for automatic turn-on
-        if (tasmotaTurnOff(device.ip, tasmotaPulseTime)) {
-          device.powerState = false;
-          Serial.printf("✓ %s (%s) turned OFF\n", device.name.c_str(), device.ip.c_str());
-        } else {
-          Serial.printf("✗ %s (%s) failed to turn OFF\n", device.name.c_str(), device.ip.c_str());
-        }
-      }
-    }
-  }
+  bool allOk = tasmotaDispatchAll(true);
   
   tasmotaFeedingActive = true;
   tasmotaFeedingStartTime = millis();
+  tasmotaPollNow();  // Confirm the feeding state - auto-end waits for it
   Serial.println("=== Tasmota: Feeding Mode Started ===\n");
+  return allOk;
 }
 
 // ============================================================
 // Stop Feeding Mode - Reverse the action
 // ============================================================
-void tasmotaStopFeeding() {
-  if (!tasmotaEnabled || tasmotaDevices.empty()) {
+bool tasmotaStopFeeding() {
+  size_t deviceCount = tasmotaDeviceCount();
+  if (!tasmotaEnabled || deviceCount == 0) {
     Serial.println("⊘ Tasmota disabled or no devices configured");
-    return;
+    return true;
   }
   
   Serial.println("\n=== Tasmota: Stopping Feeding Mode ===");
   Serial.printf("Devices count: %d, tasmotaFeedingActive: %s\n", 
-                tasmotaDevices.size(), tasmotaFeedingActive ? "true" : "false");
+                (int)deviceCount, tasmotaFeedingActive ? "true" : "false");
   
-  for (auto& device : tasmotaDevices) {
-    Serial.printf("Device: %s, enabled=%d, turnOn=%d\n", 
-                  device.name.c_str(), device.enabled, device.turnOn);
-    
-    if (device.enabled) {
-      // Disable auto-on: PulseTime 0 and restore PowerOnState 3
-      Serial.printf("Sending PulseTime 0 to %s\n", device.ip.c_str());
-      tasmotaSendCommand(device.ip, "PulseTime 0");
-      Serial.printf("Sending PowerOnState 3 to %s\n", device.ip.c_str());
-      tasmotaSendCommand(device.ip, "PowerOnState 3");  // Restore to "last state"
-      
-      if (device.turnOn) {
-        // Was ON during feeding, turn OFF now (inverted)
-        Serial.printf("turnOn=true -> Turning OFF %s\n", device.ip.c_str());
-        if (tasmotaTurnOff(device.ip, 0)) {
-          device.powerState = false;
-          Serial.printf("✓ %s (%s) turned OFF (inverted)\n", device.name.c_str(), device.ip.c_str());
-        } else {
-          Serial.printf("✗ %s (%s) failed to turn OFF\n", device.name.c_str(), device.ip.c_str());
-        }
-      } else {
-        // Was OFF during feeding, turn ON now (normal)
-        Serial.printf("turnOn=false -> Turning ON %s\n", device.ip.c_str());
-        if (tasmotaTurnOn(device.ip)) {
-          device.powerState = true;
-          Serial.printf("✓ %s (%s) turned ON\n", device.name.c_str(), device.ip.c_str());
-        } else {
-          Serial.printf("✗ %s (%s) failed to turn ON\n", device.name.c_str(), device.ip.c_str());
-        }
-      }
-    }
-  }
+  bool allOk = tasmotaDispatchAll(false);
   
   tasmotaFeedingActive = false;
+  tasmotaStatusChanged();
   Serial.println("=== Tasmota: Feeding Mode Stopped ===\n");
+  return allOk;
 }
 
 // ============================================================
 // Save Tasmota Configuration
 // ============================================================
 void tasmotaSaveConfig() {
+  TasmotaMqttConfig mqtt = tasmotaMqttGetConfig();
   preferences.putBool("tasmota_en", tasmotaEnabled);
   preferences.putInt("tasmota_pulse", tasmotaPulseTime);
+  preferences.putString("tasmota_mqtt", mqtt.host);
+  preferences.putUShort("tasmota_mport", mqtt.port);
+  preferences.putString("tasmota_muser", mqtt.user);
+  preferences.putString("tasmota_mpass", encryptString(mqtt.pass));
+  preferences.putString("tasmota_group", tasmotaGroupGetName());
+  preferences.putBool("tasmota_hedge", tasmotaHedging);
+  preferences.putUChar("tasmota_swin", tasmotaSweepWindow);
+  preferences.putUShort("tasmota_sconn", tasmotaSweepConnectMs);
   
   // Save device list as JSON
   JsonDocument doc;
   JsonArray arr = doc.to<JsonArray>();
   
+  tasmotaDevicesLock();
   for (const auto& device : tasmotaDevices) {
     if (device.enabled) {
       JsonObject d = arr.add<JsonObject>();
       d["ip"] = device.ip;
       d["name"] = device.name;
+      d["topic"] = device.topic;
       d["turnOn"] = device.turnOn;
     }
   }
+  tasmotaDevicesUnlock();
   
   String deviceJson;
   serializeJson(doc, deviceJson);
@@ -572,13 +1974,26 @@ void tasmotaSaveConfig() {
 // Load Tasmota Configuration
 // ============================================================
 void tasmotaLoadConfig() {
+  if (!tasmotaDevicesMutex) tasmotaDevicesMutex = xSemaphoreCreateRecursiveMutex();
+  
   tasmotaEnabled = preferences.getBool("tasmota_en", false);
   tasmotaPulseTime = preferences.getInt("tasmota_pulse", 900);
   
+  String mqttPass = preferences.getString("tasmota_mpass", "");
+  tasmotaMqttConfigure(preferences.getString("tasmota_mqtt", ""),
+                       preferences.getUShort("tasmota_mport", TASMOTA_MQTT_DEFAULT_PORT),
+                       preferences.getString("tasmota_muser", ""),
+                       mqttPass.length() > 0 ? decryptString(mqttPass) : "");
+  tasmotaGroupConfigure(preferences.getString("tasmota_group", ""));
+  tasmotaHedging = preferences.getBool("tasmota_hedge", false);
+  tasmotaSweepWindow = tasmotaClampSweepWindow(preferences.getUChar("tasmota_swin", TASMOTA_SWEEP_WINDOW));
+  tasmotaSweepConnectMs = tasmotaClampSweepConnectMs(preferences.getUShort("tasmota_sconn", TASMOTA_SWEEP_CONNECT_MS));
+  
   String deviceJson = preferences.getString("tasmota_devs", "[]");
   
   JsonDocument doc;
   if (deserializeJson(doc, deviceJson) == DeserializationError::Ok) {
+    tasmotaDevicesLock();
     tasmotaDevices.clear();
     
     JsonArray arr = doc.as<JsonArray>();
@@ -586,18 +2001,21 @@ void tasmotaLoadConfig() {
       TasmotaDevice device;
       device.ip = d["ip"].as<String>();
       device.name = d["name"].as<String>();
+      device.topic = d["topic"] | "";
       device.turnOn = d["turnOn"] | false;
       device.enabled = true;
       device.reachable = false;  // Will be checked later
       device.powerState = false;
       tasmotaDevices.push_back(device);
     }
+    tasmotaDevicesUnlock();
   }
   
-  Serial.printf("✓ Tasmota config loaded: %s, %d devices, %d sec pulse\n",
+  Serial.printf("✓ Tasmota config loaded: %s, %d devices, %d sec pulse, MQTT %s\n",
                 tasmotaEnabled ? "enabled" : "disabled",
-                tasmotaDevices.size(),
-                tasmotaPulseTime);
+                (int)tasmotaDeviceCount(),
+                tasmotaPulseTime,
+                tasmotaMqttEnabled() ? tasmotaMqttGetConfig().host.c_str() : "off");
 }
 
 // ============================================================
@@ -607,16 +2025,30 @@ String tasmotaGetSettings() {
   JsonDocument doc;
   doc["enabled"] = tasmotaEnabled;
   doc["pulseTime"] = tasmotaPulseTime;  // camelCase for JavaScript
+  TasmotaMqttConfig mqtt = tasmotaMqttGetConfig();
+  doc["mqttHost"] = mqtt.host;
+  doc["mqttPort"] = mqtt.port;
+  doc["mqttUser"] = mqtt.user;
+  doc["mqttPass"] = mqtt.pass;
+  doc["mqttConnected"] = tasmotaMqttConnected();
+  doc["groupName"] = tasmotaGroupGetName();
+  doc["hedging"] = tasmotaHedging;
+  doc["scanWindow"] = tasmotaSweepWindow;
+  doc["scanConnectMs"] = tasmotaSweepConnectMs;
+  doc["groupMembers"] = tasmotaGroupMemberTotal();
   
   JsonArray devices = doc["devices"].to<JsonArray>();
+  tasmotaDevicesLock();
   for (const auto& device : tasmotaDevices) {
     JsonObject d = devices.add<JsonObject>();
     d["ip"] = device.ip;
     d["name"] = device.name;
+    d["topic"] = device.topic;
     d["enabled"] = device.enabled;
     d["turnOn"] = device.turnOn;
     d["power"] = device.powerState ? "ON" : "OFF";
   }
+  tasmotaDevicesUnlock();
   
   String result;
   serializeJson(doc, result);
@@ -636,21 +2068,55 @@ bool tasmotaUpdateSettings(const String& json) {
   // Accept both pulseTime (JS) and pulse_time (internal)
   tasmotaPulseTime = doc["pulseTime"] | doc["pulse_time"] | 900;
   
-  // Update device list
+  // MQTT broker (optional - empty host = HTTP only)
+  if (!doc["mqttHost"].isNull()) {
+    tasmotaMqttConfigure(doc["mqttHost"] | "", doc["mqttPort"] | TASMOTA_MQTT_DEFAULT_PORT,
+                         doc["mqttUser"] | "", doc["mqttPass"] | "");
+  }
+  
+  tasmotaHedging = doc["hedging"] | tasmotaHedging;
+  tasmotaSweepWindow = tasmotaClampSweepWindow(doc["scanWindow"] | (int)tasmotaSweepWindow);
+  tasmotaSweepConnectMs = tasmotaClampSweepConnectMs(doc["scanConnectMs"] | (int)tasmotaSweepConnectMs);
+  
+  // Device group for the multicast fast path (empty = off)
+  if (!doc["groupName"].isNull()) {
+    String groupName = doc["groupName"] | "";
+    if (groupName != tasmotaGroupGetName()) tasmotaGroupConfigure(groupName);
+  }
+  
+  // Update device list - built outside the lock, swapped in under it.
+  // Devices that stay keep their runtime state (a feeding may be running).
   if (doc["devices"].is<JsonArray>()) {
-    tasmotaDevices.clear();
+    std::vector<TasmotaDevice> devices;
     
     JsonArray arr = doc["devices"].as<JsonArray>();
     for (JsonObject d : arr) {
       TasmotaDevice device;
       device.ip = d["ip"].as<String>();
       device.name = d["name"].as<String>();
+      device.topic = d["topic"] | "";
       device.enabled = d["enabled"] | true;
       device.turnOn = d["turnOn"] | false;
       device.reachable = true;
       device.powerState = false;
-      tasmotaDevices.push_back(device);
+      devices.push_back(device);
+    }
+    
+    tasmotaDevicesLock();
+    for (auto& device : devices) {
+      for (const auto& old : tasmotaDevices) {
+        if (old.ip != device.ip) continue;
+        if (device.topic.length() == 0) device.topic = old.topic;
+        device.powerState = old.powerState;
+        device.reachable = old.reachable;
+        device.actionMs = old.actionMs;
+        device.actionOk = old.actionOk;
+        device.eventArmed = old.eventArmed;
+        device.feedingSeen = old.feedingSeen;
+      }
     }
+    tasmotaDevices.swap(devices);
+    tasmotaDevicesUnlock();
   }
   
   tasmotaSaveConfig();
@@ -661,6 +2127,8 @@ bool tasmotaUpdateSettings(const String& json) {
 // Add a single Tasmota device
 // ============================================================
 void tasmotaAddDevice(const String& ip, const String& name, bool enabled, bool turnOn) {
+  tasmotaDevicesLock();
+  
   // Check if device already exists
   for (auto& device : tasmotaDevices) {
     if (device.ip == ip) {
@@ -668,6 +2136,7 @@ void tasmotaAddDevice(const String& ip, const String& name, bool enabled, bool t
       device.name = name;
       device.enabled = enabled;
       device.turnOn = turnOn;
+      tasmotaDevicesUnlock();
       Serial.printf("Updated existing Tasmota device: %s (%s)\n", name.c_str(), ip.c_str());
       return;
     }
@@ -682,6 +2151,7 @@ void tasmotaAddDevice(const String& ip, const String& name, bool enabled, bool t
   device.reachable = true;
   device.powerState = false;
   tasmotaDevices.push_back(device);
+  tasmotaDevicesUnlock();
   Serial.printf("Added new Tasmota device: %s (%s)\n", name.c_str(), ip.c_str());
 }
 
@@ -689,13 +2159,15 @@ void tasmotaAddDevice(const String& ip, const String& name, bool enabled, bool t
 // Remove a Tasmota device by IP
 // ============================================================
 void tasmotaRemoveDevice(const String& ip) {
+  tasmotaDevicesLock();
   for (auto it = tasmotaDevices.begin(); it != tasmotaDevices.end(); ++it) {
     if (it->ip == ip) {
       Serial.printf("Removed Tasmota device: %s (%s)\n", it->name.c_str(), ip.c_str());
       tasmotaDevices.erase(it);
-      return;
+      break;
     }
   }
+  tasmotaDevicesUnlock();
 }
 
 // ============================================================
@@ -705,15 +2177,21 @@ String tasmotaGetDevicesJson() {
   JsonDocument doc;
   JsonArray devices = doc.to<JsonArray>();
   
+  tasmotaDevicesLock();
   for (const auto& device : tasmotaDevices) {
     JsonObject d = devices.add<JsonObject>();
     d["ip"] = device.ip;
     d["name"] = device.name;
+    d["topic"] = device.topic;
     d["enabled"] = device.enabled;
     d["turnOn"] = device.turnOn;
     d["reachable"] = device.reachable;
     d["power"] = device.powerState ? "ON" : "OFF";
+    d["actionOk"] = device.actionOk;
+    d["actionMs"] = device.actionMs;
+    tasmotaLinkAddStatsJson(device.ip, d["latency"].to<JsonObject>());
   }
+  tasmotaDevicesUnlock();
   
   String result;
   serializeJson(doc, result);
@@ -757,22 +2235,66 @@ String tasmotaTestDevice(const String& ip) {
 // ============================================================
 // Update Power States of all enabled devices
 // ============================================================
+// Copies the enabled devices under the device lock, queries them without
+// it and writes each result back by IP under the lock again. A result is
+// dropped if a start/stop dispatch ran in between (device generation
+// changed) - it may predate the command.
 void tasmotaUpdatePowerStates() {
   if (tasmotaDebug) {
     Serial.println("[TASMOTA DEBUG] Updating power states...");
   }
+  
+  // Devices reachable through MQTT push their state and are not polled.
+  // Devices with an open circuit are only probed once their cooldown passed.
+  std::vector<String> ips;
+  std::vector<bool> probes;
+  tasmotaDevicesLock();
+  uint32_t generation = tasmotaDeviceGeneration;
   for (auto& device : tasmotaDevices) {
+    if (!device.enabled) continue;
+    
+    TasmotaBreakerState breaker = tasmotaBreakerState(device.ip);
+    if (breaker != TASMOTA_BREAKER_CLOSED) {
+      device.reachable = false;
+      if (tasmotaBreakerProbeDue(device.ip)) {
+        ips.push_back(device.ip);
+        probes.push_back(true);
+      }
+    } else if (tasmotaMqttTopicFor(device.ip).length() == 0) {
+      ips.push_back(device.ip);
+      probes.push_back(false);
+    }
+  }
+  tasmotaDevicesUnlock();
+  
+  for (size_t i = 0; i < ips.size(); i++) {
+    const String& ip = ips[i];
+    
     // Yield to other tasks for each device
     delay(50);
     
-    if (device.enabled) {
-      bool oldState = device.powerState;
-      int newState = tasmotaGetPowerStateEx(device.ip);
+    String topic;
+    int newState = tasmotaGetPowerStateEx(ip, &topic, probes[i]);
+    
+    tasmotaDevicesLock();
+    if (generation != tasmotaDeviceGeneration) {
+      tasmotaDevicesUnlock();
+      if (tasmotaDebug) {
+        Serial.println("[TASMOTA DEBUG] Start/stop during the poll - results dropped");
+      }
+      tasmotaPollNow();  // Query again with the new states
+      return;
+    }
+    for (auto& device : tasmotaDevices) {
+      if (device.ip != ip) continue;
       
       if (newState >= 0) {
+        // Learn the MQTT topic of devices added before it was known
+        if (device.topic.length() == 0 && topic.length() > 0) device.topic = topic;
+        
         // Valid response - update state
-        device.powerState = (newState == 1);
-        device.reachable = true;
+        bool oldState = device.powerState;
+        tasmotaDeviceReported(device, newState == 1);
         if (tasmotaDebug && oldState != device.powerState) {
           Serial.printf("[TASMOTA DEBUG] %s state changed: %s -> %s\n", 
             device.name.c_str(), 
@@ -781,6 +2303,7 @@ void tasmotaUpdatePowerStates() {
         }
       } else {
         // Error - keep old state, mark as possibly unreachable
+        device.reachable = false;
         if (tasmotaDebug) {
           Serial.printf("[TASMOTA DEBUG] %s query failed - keeping state: %s\n", 
             device.name.c_str(), 
@@ -788,52 +2311,186 @@ void tasmotaUpdatePowerStates() {
         }
       }
     }
+    tasmotaDevicesUnlock();
   }
 }
 
 // ============================================================
 // Check if all Tasmota devices are back to normal state
 // Returns true if feeding mode should be considered complete
+// (uses the power states of the last poll)
 // ============================================================
+// A device takes part in the feeding if its command succeeded or it was
+// seen in its feeding state anyway. It is complete once it has reported
+// its feeding state after the start and is back to normal now:
+// turnOn=false devices are OFF during feeding (PulseTime turns them back
+// ON), turnOn=true devices are ON during feeding. Devices whose command
+// failed are not waited for; if all failed the feeding never auto-ends.
+static bool tasmotaDeviceParticipates(const TasmotaDevice& device) {
+  return device.enabled && (device.actionOk || device.feedingSeen);
+}
+
+static bool tasmotaDeviceRestored(const TasmotaDevice& device) {
+  return device.feedingSeen && device.powerState != device.turnOn;
+}
+
 bool tasmotaCheckFeedingComplete() {
-  if (!tasmotaFeedingActive || !tasmotaEnabled || tasmotaDevices.empty()) {
+  if (!tasmotaFeedingActive || !tasmotaEnabled) {
     return false;
   }
   
-  int enabledCount = 0;
+  int participating = 0;
   int completedCount = 0;
   
-  for (auto& device : tasmotaDevices) {
-    if (device.enabled) {
-      enabledCount++;
-      
-      // Update power state
-      bool currentPower = tasmotaGetPowerState(device.ip);
-      device.powerState = currentPower;
-      
-      // Check if device is back to "normal" state
-      // turnOn=false means device should be OFF during feeding, so complete when ON
-      // turnOn=true means device should be ON during feeding, so complete when OFF
-      if (device.turnOn) {
-        // Inverted: was ON during feeding, complete when OFF
-        if (!currentPower) completedCount++;
-      } else {
-        // Normal: was OFF during feeding, complete when ON (PulseTime triggered)
-        if (currentPower) completedCount++;
-      }
-    }
+  tasmotaDevicesLock();
+  for (const auto& device : tasmotaDevices) {
+    if (!tasmotaDeviceParticipates(device)) continue;
+    participating++;
+    if (tasmotaDeviceRestored(device)) completedCount++;
   }
+  tasmotaDevicesUnlock();
   
-  return (enabledCount > 0 && completedCount == enabledCount);
+  return (participating > 0 && completedCount == participating);
 }
 
 // ============================================================
-// Get Tasmota Feeding Status as JSON
+// Background State Poller
 // ============================================================
-String tasmotaGetFeedingStatus() {
-  // Yield to other tasks at start
-  delay(10);
+// One task queries the devices and publishes the feeding status as a
+// serialized snapshot. /api/tasmota-status and every other reader get a
+// copy of that snapshot, so any number of open browser tabs cause no
+// extra requests to the plugs. The poll runs faster while feeding so the
+// auto-end is detected quickly - unless every plug reports its power
+// changes through the completion rule, then polling is only a fallback.
+
+#define TASMOTA_POLL_IDLE_MS      60000   // Poll interval without feeding
+#define TASMOTA_POLL_FEEDING_MS   5000    // Poll interval while feeding
+#define TASMOTA_POLL_FALLBACK_MS  30000   // Poll interval while feeding, all rules armed
+#define TASMOTA_AUTO_END_GRACE_MS 10000   // No auto-end this soon after the start
+#define TASMOTA_POLL_STACK        6144
+#define TASMOTA_POLL_PRIORITY     1
+#define TASMOTA_POLL_CORE         0
+
+static DRAM_ATTR unsigned long tasmotaPollIdleMs = TASMOTA_POLL_IDLE_MS;
+static DRAM_ATTR unsigned long tasmotaPollFeedingMs = TASMOTA_POLL_FEEDING_MS;
+static TaskHandle_t tasmotaPollTaskHandle = NULL;
+static SemaphoreHandle_t tasmotaStatusMutex = NULL;  // Guards the snapshot
+static String tasmotaStatusSnapshot = "";
+static DRAM_ATTR volatile bool tasmotaPollForced = false;
+
+void tasmotaSetPollInterval(unsigned long idleMs, unsigned long feedingMs) {
+  if (idleMs > 0) tasmotaPollIdleMs = idleMs;
+  if (feedingMs > 0) tasmotaPollFeedingMs = feedingMs;
+  if (tasmotaPollTaskHandle) xTaskNotifyGive(tasmotaPollTaskHandle);
+}
+
+// Ask the poller to query all devices now
+void tasmotaPollNow() {
+  tasmotaPollForced = true;
+  if (tasmotaPollTaskHandle) xTaskNotifyGive(tasmotaPollTaskHandle);
+}
+
+// Device states changed locally (start/stop, event) - republish the
+// snapshot without querying the devices
+void tasmotaStatusChanged() {
+  if (tasmotaPollTaskHandle) xTaskNotifyGive(tasmotaPollTaskHandle);
+}
+
+static unsigned long tasmotaPollInterval() {
+  if (!tasmotaFeedingActive) return tasmotaPollIdleMs;
+  
+  unsigned long interval = TASMOTA_POLL_FALLBACK_MS;
+  tasmotaDevicesLock();
+  for (const auto& device : tasmotaDevices) {
+    bool pushed = device.eventArmed || (device.topic.length() > 0 && tasmotaMqttConnected()) ||
+                  (tasmotaGroupReady() && tasmotaGroupIsMember(tasmotaIpToU32(device.ip)));
+    if (device.enabled && !pushed) interval = tasmotaPollFeedingMs;
+  }
+  tasmotaDevicesUnlock();
+  return interval;
+}
+
+// ============================================================
+// Power Change Event (from the completion rule)
+// Returns false if the sender is not a configured device
+// ============================================================
+// Power value of an event: 1, 0 or -1 if malformed
+int tasmotaEventPower(const String& power) {
+  if (power == "1" || power == "ON") return 1;
+  if (power == "0" || power == "OFF") return 0;
+  return -1;
+}
+
+// Runs in the AsyncTCP task - only updates the list under the device lock
+bool tasmotaHandleEvent(const String& ip, const String& power) {
+  int state = tasmotaEventPower(power);
+  
+  bool known = false;
+  tasmotaDevicesLock();
+  for (auto& device : tasmotaDevices) {
+    if (device.ip != ip) continue;
+    
+    known = true;
+    device.reachable = true;
+    if (state >= 0) tasmotaDeviceReported(device, state == 1);
+  }
+  tasmotaDevicesUnlock();
+  if (!known) return false;
+  
+  if (tasmotaDebug) {
+    Serial.printf("[TASMOTA DEBUG] Event from %s: power=%s\n", ip.c_str(), power.c_str());
+  }
+  if (state >= 0) {
+    tasmotaStatusChanged();
+  } else {
+    tasmotaPollNow();  // Unexpected payload - ask the device
+  }
+  return true;
+}
+
+// Power state shared by a device group member (runs in the group task)
+static void tasmotaGroupStateChanged(uint32_t ip, int power) {
+  bool known = false;
+  tasmotaDevicesLock();
+  for (auto& device : tasmotaDevices) {
+    if (tasmotaIpToU32(device.ip) != ip) continue;
+    
+    known = true;
+    tasmotaDeviceReported(device, power == 1);
+  }
+  tasmotaDevicesUnlock();
+  if (!known) return;
   
+  if (tasmotaDebug) {
+    Serial.printf("[TASMOTA DEBUG] Group %s: power=%d\n", IPAddress(ip).toString().c_str(), power);
+  }
+  tasmotaStatusChanged();
+}
+
+// Power state pushed over MQTT (runs in the MQTT task, inside
+// PubSubClient::loop() - the device lock nests in tasmotaMqttMutex)
+static void tasmotaMqttStateChanged(const String& topic, int power, bool online) {
+  bool known = false;
+  tasmotaDevicesLock();
+  for (auto& device : tasmotaDevices) {
+    if (device.topic.length() == 0 || device.topic != topic) continue;
+    
+    known = true;
+    if (power >= 0) tasmotaDeviceReported(device, power == 1);
+    device.reachable = online;
+  }
+  tasmotaDevicesUnlock();
+  if (!known) return;
+  
+  if (tasmotaDebug) {
+    Serial.printf("[TASMOTA DEBUG] MQTT %s: power=%d online=%d\n", topic.c_str(), power, online);
+  }
+  tasmotaStatusChanged();
+}
+
+// Build the feeding status from the cached device states (no network I/O).
+// generation receives the device generation the status was built from.
+static String tasmotaBuildFeedingStatus(bool& allComplete, uint32_t* generation = NULL) {
   JsonDocument doc;
   
   doc["active"] = tasmotaFeedingActive;
@@ -843,23 +2500,16 @@ String tasmotaGetFeedingStatus() {
   if (tasmotaFeedingActive) {
     unsigned long elapsed = (millis() - tasmotaFeedingStartTime) / 1000;
     doc["elapsedSeconds"] = elapsed;
-    
-    if (tasmotaDebug) {
-      Serial.printf("[TASMOTA DEBUG] Feeding status poll - elapsed: %lu sec\n", elapsed);
-    }
-    
-    // Yield before status update
-    delay(20);
-    
-    // Update power states from devices when feeding is active
-    tasmotaUpdatePowerStates();
   }
   
   int enabledCount = 0;
+  int participating = 0;
   int completedCount = 0;
   
   JsonArray devices = doc["devices"].to<JsonArray>();
   
+  tasmotaDevicesLock();
+  if (generation) *generation = tasmotaDeviceGeneration;
   for (const auto& device : tasmotaDevices) {
     if (device.enabled) {
       enabledCount++;
@@ -868,41 +2518,158 @@ String tasmotaGetFeedingStatus() {
       d["ip"] = device.ip;
       d["name"] = device.name;
       d["powerState"] = device.powerState;
+      d["reachable"] = device.reachable;
+      d["circuit"] = tasmotaBreakerName(tasmotaBreakerState(device.ip));
       d["turnOn"] = device.turnOn;  // What action during feeding
       
-      // Determine expected state and if complete
-      bool expectedDuringFeeding = device.turnOn;  // ON if turnOn, OFF if !turnOn
-      bool isInFeedingState = (device.powerState == expectedDuringFeeding);
+      // Expected state: ON if turnOn, OFF if !turnOn
+      bool isInFeedingState = (device.powerState == device.turnOn);
+      bool restored = tasmotaDeviceRestored(device);
       
       d["inFeedingState"] = isInFeedingState;
-      d["completed"] = !isInFeedingState;  // Completed when NOT in feeding state anymore
+      d["confirmed"] = device.feedingSeen;  // Reported its feeding state since the start
+      d["completed"] = restored;
       
-      if (!isInFeedingState) completedCount++;
+      if (tasmotaDeviceParticipates(device)) {
+        participating++;
+        if (restored) completedCount++;
+      }
     }
   }
+  tasmotaDevicesUnlock();
+  
+  allComplete = (participating > 0 && completedCount == participating);
   
   doc["totalDevices"] = enabledCount;
   doc["completedDevices"] = completedCount;
-  doc["allComplete"] = (enabledCount > 0 && completedCount == enabledCount);
+  doc["allComplete"] = allComplete;
   
-  // Auto-end feeding mode when all devices are back to normal
-  if (tasmotaFeedingActive && enabledCount > 0 && completedCount == enabledCount) {
-    Serial.println("\n=== Tasmota: All devices restored - auto-ending feeding mode ===");
-    tasmotaFeedingActive = false;
-    feedingModeActive = false;  // Update global state
-    
-    // Clean up: disable PulseTime and restore PowerOnState
-    for (auto& device : tasmotaDevices) {
-      if (device.enabled) {
-        tasmotaSendCommand(device.ip, "PulseTime 0");
-        tasmotaSendCommand(device.ip, "PowerOnState 3");
+  String result;
+  serializeJson(doc, result);
+  return result;
+}
+
+static void tasmotaPublishStatus(const String& status) {
+  xSemaphoreTake(tasmotaStatusMutex, portMAX_DELAY);
+  tasmotaStatusSnapshot = status;
+  xSemaphoreGive(tasmotaStatusMutex);
+}
+
+// Auto-end feeding mode when all devices are back to normal. Skipped if
+// a start/stop ran since the status was built (generation changed).
+static void tasmotaAutoEndFeeding(uint32_t generation) {
+  std::vector<String> ips;
+  std::vector<bool> armed;
+  tasmotaDevicesLock();
+  if (generation != tasmotaDeviceGeneration || !tasmotaFeedingActive) {
+    tasmotaDevicesUnlock();
+    return;
+  }
+  Serial.println("\n=== Tasmota: All devices restored - auto-ending feeding mode ===");
+  tasmotaFeedingActive = false;
+  feedingModeActive = false;  // Update global state
+  
+  // Clean up: disable the completion rule and PulseTime, restore PowerOnState
+  for (auto& device : tasmotaDevices) {
+    if (device.enabled) {
+      ips.push_back(device.ip);
+      armed.push_back(device.eventArmed);
+    }
+    device.eventArmed = false;
+  }
+  tasmotaDevicesUnlock();
+  ledSetBase(LED_PATTERN_IDLE);
+  
+  for (size_t i = 0; i < ips.size(); i++) {
+    String cleanup[3];
+    int count = 0;
+    if (armed[i]) cleanup[count++] = String(TASMOTA_EVENT_RULE) + " 0";
+    cleanup[count++] = "PulseTime 0";
+    cleanup[count++] = "PowerOnState 3";
+    tasmotaSendBatch(ips[i], cleanup, count, false, 3, tasmotaFeedingSendMode(false));
+  }
+  Serial.println("=== Feeding mode auto-stopped ===\n");
+}
+
+static void tasmotaPollTask(void* param) {
+  unsigned long lastPoll = 0;
+  bool firstPoll = true;
+  
+  for (;;) {
+    // Woken early by an event or start/stop: only republish the snapshot
+    bool due = firstPoll || tasmotaPollForced || (millis() - lastPoll) >= tasmotaPollInterval();
+    if (due) {
+      firstPoll = false;
+      tasmotaPollForced = false;
+      lastPoll = millis();
+      
+      if (tasmotaEnabled && tasmotaDeviceCount() > 0 && WiFi.status() == WL_CONNECTED) {
+        tasmotaUpdatePowerStates();
+        if (tasmotaDebug) {
+          Serial.printf("[TASMOTA DEBUG] Poll took %lu ms\n", millis() - lastPoll);
+        }
       }
     }
-    Serial.println("=== Feeding mode auto-stopped ===\n");
+    
+    bool allComplete = false;
+    bool feeding = tasmotaFeedingActive;
+    uint32_t generation = 0;
+    String status = tasmotaBuildFeedingStatus(allComplete, &generation);
+    
+    // Only after every device confirmed its feeding state (see
+    // tasmotaDeviceRestored) and never right after the start
+    if (feeding && allComplete && millis() - tasmotaFeedingStartTime >= TASMOTA_AUTO_END_GRACE_MS) {
+      tasmotaAutoEndFeeding(generation);
+      status = tasmotaBuildFeedingStatus(allComplete);
+    }
+    tasmotaPublishStatus(status);
+    
+    // Sleep until the next poll or until woken by an event/tasmotaPollNow()
+    unsigned long interval = tasmotaPollInterval();
+    unsigned long elapsed = millis() - lastPoll;
+    unsigned long wait = elapsed < interval ? interval - elapsed : 0;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
   }
+}
+
+void tasmotaPollerBegin() {
+  if (tasmotaPollTaskHandle) return;
+  if (!tasmotaDevicesMutex) tasmotaDevicesMutex = xSemaphoreCreateRecursiveMutex();
+  if (!tasmotaStatusMutex) tasmotaStatusMutex = xSemaphoreCreateMutex();
   
-  String result;
-  serializeJson(doc, result);
+  tasmotaMqttSetStateHandler(tasmotaMqttStateChanged);
+  tasmotaMqttBegin();
+  tasmotaGroupSetStateHandler(tasmotaGroupStateChanged);
+  tasmotaGroupBegin();
+  
+  xTaskCreatePinnedToCore(
+    tasmotaPollTask,          // Task function
+    "tasmota_poll",           // Name
+    TASMOTA_POLL_STACK,       // Stack size
+    NULL,                     // Parameters
+    TASMOTA_POLL_PRIORITY,    // Priority
+    &tasmotaPollTaskHandle,   // Task handle
+    TASMOTA_POLL_CORE         // Core
+  );
+}
+
+// ============================================================
+// Get Tasmota Feeding Status as JSON (cached snapshot)
+// ============================================================
+String tasmotaGetFeedingStatus() {
+  if (!tasmotaStatusMutex) {
+    bool allComplete;
+    return tasmotaBuildFeedingStatus(allComplete);  // Poller not started yet
+  }
+  
+  xSemaphoreTake(tasmotaStatusMutex, portMAX_DELAY);
+  String result = tasmotaStatusSnapshot;
+  xSemaphoreGive(tasmotaStatusMutex);
+  
+  if (result.length() == 0) {
+    bool allComplete;
+    result = tasmotaBuildFeedingStatus(allComplete);
+  }
   return result;
 }
 
@@ -0,0 +1,169 @@
+/**
+ * @file tasmota_breaker.h
+ * @brief Per-device circuit breaker for the Tasmota plugs
+ *
+ * After TASMOTA_BREAKER_THRESHOLD failed commands in a row (a command
+ * counts once, whatever its retries) the circuit opens and commands
+ * fail instantly instead of waiting for timeouts. After a cooldown the
+ * poller sends a single probe (half-open); success closes the circuit,
+ * failure opens it again with a doubled cooldown. Commands that restore
+ * a plug (feeding stop) are always sent, as a probe if the circuit is
+ * open: a skipped stop leaves a pump off until its PulseTime fallback.
+ *
+ * The state machine and the command loop run on the caller's clock and
+ * I/O hooks, kept apart from the link table in tasmota_api.h so they
+ * also build on the host (test/test_tasmota_breaker).
+ */
+
+#ifndef TASMOTA_BREAKER_H
+#define TASMOTA_BREAKER_H
+
+#include <stdint.h>
+
+// ============================================================
+// Configuration
+// ============================================================
+#define TASMOTA_BREAKER_THRESHOLD   3       // Consecutive failed commands to open
+#define TASMOTA_BREAKER_COOLDOWN    30000   // First probe after 30 s
+#define TASMOTA_BREAKER_MAX_COOLDOWN 300000 // Probe at least every 5 minutes
+
+enum TasmotaBreakerState : uint8_t {
+  TASMOTA_BREAKER_CLOSED = 0,   // Requests pass
+  TASMOTA_BREAKER_OPEN,         // Requests fail instantly
+  TASMOTA_BREAKER_HALF_OPEN     // One probe request in flight
+};
+
+struct TasmotaBreaker {
+  TasmotaBreakerState state;
+  uint8_t consecutiveFailures;
+  uint32_t openedAt;        // When the circuit opened (or the probe left)
+  uint32_t cooldownMs;
+};
+
+static const char* tasmotaBreakerName(TasmotaBreakerState state) {
+  switch (state) {
+    case TASMOTA_BREAKER_OPEN: return "open";
+    case TASMOTA_BREAKER_HALF_OPEN: return "half-open";
+    default: return "closed";
+  }
+}
+
+// Result of a request - returns the state before it
+static TasmotaBreakerState tasmotaBreakerRecord(TasmotaBreaker& b, bool ok, uint32_t now) {
+  TasmotaBreakerState before = b.state;
+  if (ok) {
+    b.state = TASMOTA_BREAKER_CLOSED;
+    b.consecutiveFailures = 0;
+    return before;
+  }
+
+  if (b.consecutiveFailures < 255) b.consecutiveFailures++;
+  if (b.state == TASMOTA_BREAKER_HALF_OPEN) {
+    // Probe failed - back off further
+    b.state = TASMOTA_BREAKER_OPEN;
+    b.openedAt = now;
+    b.cooldownMs = b.cooldownMs * 2 < TASMOTA_BREAKER_MAX_COOLDOWN ? b.cooldownMs * 2
+                                                                   : TASMOTA_BREAKER_MAX_COOLDOWN;
+  } else if (b.state == TASMOTA_BREAKER_CLOSED &&
+             b.consecutiveFailures >= TASMOTA_BREAKER_THRESHOLD) {
+    b.state = TASMOTA_BREAKER_OPEN;
+    b.openedAt = now;
+    b.cooldownMs = TASMOTA_BREAKER_COOLDOWN;
+  }
+  return before;
+}
+
+// May a request be sent? A probe is let through (half-open) once the
+// cooldown of an open circuit has passed.
+static bool tasmotaBreakerTryPass(TasmotaBreaker& b, bool probe, uint32_t now) {
+  bool allow = true;
+  if (b.state == TASMOTA_BREAKER_HALF_OPEN) {
+    // Probe in flight - another probe only if that one never reported back
+    allow = probe && (now - b.openedAt) >= TASMOTA_BREAKER_COOLDOWN;
+  } else if (b.state == TASMOTA_BREAKER_OPEN) {
+    allow = probe && (now - b.openedAt) >= b.cooldownMs;
+  }
+  if (allow && b.state != TASMOTA_BREAKER_CLOSED) {
+    b.state = TASMOTA_BREAKER_HALF_OPEN;
+    b.openedAt = now;
+  }
+  return allow;
+}
+
+// Open circuit whose cooldown has passed (due for a background probe)
+static bool tasmotaBreakerDue(const TasmotaBreaker& b, uint32_t now) {
+  if (b.state == TASMOTA_BREAKER_OPEN) return (now - b.openedAt) >= b.cooldownMs;
+  if (b.state == TASMOTA_BREAKER_HALF_OPEN) return (now - b.openedAt) >= TASMOTA_BREAKER_COOLDOWN;
+  return false;
+}
+
+// ============================================================
+// Command Loop
+// ============================================================
+enum TasmotaSendMode : uint8_t {
+  TASMOTA_SEND_NORMAL = 0,  // Skipped while the circuit is open
+  TASMOTA_SEND_PROBE,       // Background probe: one attempt, only when due
+  TASMOTA_SEND_ALWAYS       // Restore commands: sent even if the circuit is open
+};
+
+// Feeding start may skip a dead plug, feeding stop must always reach it
+static TasmotaSendMode tasmotaFeedingSendMode(bool starting) {
+  return starting ? TASMOTA_SEND_NORMAL : TASMOTA_SEND_ALWAYS;
+}
+
+struct TasmotaCommandIo {
+  void* ctx;
+  TasmotaBreaker* (*lock)(void* ctx);   // Breaker of the device, held until unlock()
+  void (*unlock)(void* ctx);
+  uint32_t (*now)();                    // Breaker clock
+  bool (*send)(void* ctx, int attempt); // One request (attempt is 0-based) - true on an answer
+  void (*wait)(void* ctx, int attempt); // Backoff before retry `attempt` (1-based)
+};
+
+struct TasmotaCommandOutcome {
+  bool sent;                            // false = skipped, circuit open
+  bool ok;
+  int attempts;
+  TasmotaBreakerState before;           // Breaker state around the command
+  TasmotaBreakerState after;
+};
+
+// Run one command with up to `retries` attempts through the breaker.
+// The whole command is one success or failure for the breaker.
+static TasmotaCommandOutcome tasmotaBreakerCommand(const TasmotaCommandIo& io, TasmotaSendMode mode,
+                                                   int retries) {
+  TasmotaCommandOutcome out = { false, false, 0, TASMOTA_BREAKER_CLOSED, TASMOTA_BREAKER_CLOSED };
+
+  TasmotaBreaker* b = io.lock(io.ctx);
+  out.before = b->state;
+  bool pass;
+  if (mode == TASMOTA_SEND_ALWAYS) {
+    // Sent as a probe: the result decides about the circuit
+    pass = true;
+    if (b->state == TASMOTA_BREAKER_OPEN) {
+      b->state = TASMOTA_BREAKER_HALF_OPEN;
+      b->openedAt = io.now();
+    }
+  } else {
+    pass = tasmotaBreakerTryPass(*b, mode == TASMOTA_SEND_PROBE, io.now());
+  }
+  out.after = b->state;
+  io.unlock(io.ctx);
+  if (!pass) return out;
+
+  out.sent = true;
+  if (mode == TASMOTA_SEND_PROBE) retries = 1;
+  for (int attempt = 0; attempt < retries && !out.ok; attempt++) {
+    if (attempt > 0) io.wait(io.ctx, attempt);
+    out.attempts++;
+    out.ok = io.send(io.ctx, attempt);
+  }
+
+  b = io.lock(io.ctx);
+  tasmotaBreakerRecord(*b, out.ok, io.now());
+  out.after = b->state;
+  io.unlock(io.ctx);
+  return out;
+}
+
+#endif // TASMOTA_BREAKER_H
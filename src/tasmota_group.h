@@ -0,0 +1,393 @@
+/**
+ * @file tasmota_group.h
+ * @brief Tasmota Device Groups (UDP multicast) fast path
+ *
+ * Tasmota devices sharing a DevGroupName switch together when one
+ * multicast message with a new power state is sent to the group. The
+ * controller joins the group (239.255.250.250:4447), learns the members
+ * from their replies to a status request and sends the feeding on/off
+ * state as a single packet. Members acknowledge by unicast; a member
+ * without acknowledgement is switched individually by the caller.
+ *
+ * Packet layout (little endian):
+ *   "TASMOTA_DGR" <group name>\0 <sequence:2> <flags:2> { <item> <value> } 0
+ * Items 1-63 carry 8-bit, 64-127 16-bit and 128-191 32-bit values.
+ * DGR_ITEM_POWER holds the relay bitmask in bits 0-23 and the relay
+ * count in bits 24-31.
+ *
+ * The group name is set from the web handler under tasmotaGroupConfigMutex;
+ * the group task applies it to the socket it owns on reconfigure.
+ */
+
+#ifndef TASMOTA_GROUP_H
+#define TASMOTA_GROUP_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <esp_random.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// ============================================================
+// Configuration
+// ============================================================
+#define TASMOTA_GROUP_ADDR          "239.255.250.250"
+#define TASMOTA_GROUP_PORT          4447
+#define TASMOTA_GROUP_MAX_MEMBERS   16
+#define TASMOTA_GROUP_REPEATS       3       // Each message is sent 3 times (UDP)
+#define TASMOTA_GROUP_REPEAT_MS     30
+#define TASMOTA_GROUP_ACK_WAIT      300     // Wait for acknowledgements (ms)
+#define TASMOTA_GROUP_STATUS_MS     300000  // Re-learn members every 5 minutes
+#define TASMOTA_GROUP_STACK         4096
+#define TASMOTA_GROUP_PRIORITY      1
+#define TASMOTA_GROUP_CORE          0
+
+#define DGR_HEADER                  "TASMOTA_DGR"
+#define DGR_FLAG_STATUS_REQUEST     2
+#define DGR_FLAG_ACK                8
+#define DGR_ITEM_EOL                0
+#define DGR_ITEM_MAX_8BIT           63
+#define DGR_ITEM_MAX_16BIT          127
+#define DGR_ITEM_POWER              128
+#define DGR_ITEM_MAX_32BIT          191
+
+// Power state received from a member: ip (network order), power 1/0
+typedef void (*TasmotaGroupStateHandler)(uint32_t ip, int power);
+
+// ============================================================
+// Group State
+// ============================================================
+static String tasmotaGroupName = "";                  // Guarded by tasmotaGroupConfigMutex
+static String tasmotaGroupJoined = "";                // Group task only
+static SemaphoreHandle_t tasmotaGroupConfigMutex = NULL;
+static DRAM_ATTR volatile bool tasmotaGroupHasName = false;
+static DRAM_ATTR volatile bool tasmotaGroupReconfigure = false;
+static int tasmotaGroupSocket = -1;
+static uint32_t tasmotaGroupLocalIp = 0;
+static DRAM_ATTR uint16_t tasmotaGroupSequence = 0;
+static TaskHandle_t tasmotaGroupTaskHandle = NULL;
+static TasmotaGroupStateHandler tasmotaGroupStateHandler = NULL;
+
+static uint32_t tasmotaGroupMembers[TASMOTA_GROUP_MAX_MEMBERS];
+static int tasmotaGroupMemberCount = 0;
+
+static DRAM_ATTR uint16_t tasmotaGroupAckSequence = 0;
+static uint32_t tasmotaGroupAcks[TASMOTA_GROUP_MAX_MEMBERS];
+static int tasmotaGroupAckCount = 0;
+
+static portMUX_TYPE tasmotaGroupMux = portMUX_INITIALIZER_UNLOCKED;
+
+bool tasmotaGroupEnabled() { return tasmotaGroupHasName; }
+
+bool tasmotaGroupReady() { return tasmotaGroupEnabled() && tasmotaGroupSocket >= 0; }
+
+void tasmotaGroupSetStateHandler(TasmotaGroupStateHandler handler) {
+  tasmotaGroupStateHandler = handler;
+}
+
+// Set the device group name (empty = fast path off) - the group task rejoins
+void tasmotaGroupConfigure(const String& name) {
+  if (!tasmotaGroupConfigMutex) tasmotaGroupConfigMutex = xSemaphoreCreateMutex();
+  
+  xSemaphoreTake(tasmotaGroupConfigMutex, portMAX_DELAY);
+  tasmotaGroupName = name;
+  tasmotaGroupHasName = name.length() > 0;
+  tasmotaGroupReconfigure = true;
+  xSemaphoreGive(tasmotaGroupConfigMutex);
+}
+
+// Copy of the configured group name
+String tasmotaGroupGetName() {
+  if (!tasmotaGroupConfigMutex) return "";
+  
+  xSemaphoreTake(tasmotaGroupConfigMutex, portMAX_DELAY);
+  String name = tasmotaGroupName;
+  xSemaphoreGive(tasmotaGroupConfigMutex);
+  return name;
+}
+
+bool tasmotaGroupIsMember(uint32_t ip) {
+  bool member = false;
+  portENTER_CRITICAL(&tasmotaGroupMux);
+  for (int i = 0; i < tasmotaGroupMemberCount; i++) {
+    if (tasmotaGroupMembers[i] == ip) member = true;
+  }
+  portEXIT_CRITICAL(&tasmotaGroupMux);
+  return member;
+}
+
+int tasmotaGroupMemberTotal() { return tasmotaGroupMemberCount; }
+
+// Copy of the learned members (network order) - returns the count
+int tasmotaGroupGetMembers(uint32_t* members, int maxMembers) {
+  portENTER_CRITICAL(&tasmotaGroupMux);
+  int count = min(tasmotaGroupMemberCount, maxMembers);
+  for (int i = 0; i < count; i++) members[i] = tasmotaGroupMembers[i];
+  portEXIT_CRITICAL(&tasmotaGroupMux);
+  return count;
+}
+
+static void tasmotaGroupAddMember(uint32_t ip) {
+  portENTER_CRITICAL(&tasmotaGroupMux);
+  bool known = false;
+  for (int i = 0; i < tasmotaGroupMemberCount; i++) {
+    if (tasmotaGroupMembers[i] == ip) known = true;
+  }
+  if (!known && tasmotaGroupMemberCount < TASMOTA_GROUP_MAX_MEMBERS) {
+    tasmotaGroupMembers[tasmotaGroupMemberCount++] = ip;
+  }
+  portEXIT_CRITICAL(&tasmotaGroupMux);
+}
+
+// ============================================================
+// Packet Encoding
+// ============================================================
+// Writes header, group name, sequence and flags; returns the length
+static int tasmotaGroupHeader(uint8_t* buf, int size, const String& name,
+                              uint16_t sequence, uint16_t flags) {
+  int headerLen = strlen(DGR_HEADER);
+  int nameLen = name.length() + 1;
+  if (headerLen + nameLen + 4 > size) return -1;
+
+  int len = 0;
+  memcpy(buf + len, DGR_HEADER, headerLen);
+  len += headerLen;
+  memcpy(buf + len, name.c_str(), nameLen);
+  len += nameLen;
+  buf[len++] = sequence & 0xFF;
+  buf[len++] = sequence >> 8;
+  buf[len++] = flags & 0xFF;
+  buf[len++] = flags >> 8;
+  return len;
+}
+
+static bool tasmotaGroupSend(const uint8_t* buf, int len) {
+  struct sockaddr_in to;
+  memset(&to, 0, sizeof(to));
+  to.sin_family = AF_INET;
+  to.sin_port = htons(TASMOTA_GROUP_PORT);
+  to.sin_addr.s_addr = inet_addr(TASMOTA_GROUP_ADDR);
+  return lwip_sendto(tasmotaGroupSocket, buf, len, 0, (struct sockaddr*)&to, sizeof(to)) == len;
+}
+
+// Ask all members for their full status (used to learn the members)
+static void tasmotaGroupRequestStatus() {
+  uint8_t buf[64];
+  int len = tasmotaGroupHeader(buf, sizeof(buf) - 1, tasmotaGroupJoined, ++tasmotaGroupSequence,
+                               DGR_FLAG_STATUS_REQUEST);
+  if (len < 0) return;
+  buf[len++] = DGR_ITEM_EOL;
+  tasmotaGroupSend(buf, len);
+}
+
+// ============================================================
+// Switch the Group
+// Returns the number of members that acknowledged; their addresses
+// (network order) are written to `acked`.
+// ============================================================
+int tasmotaGroupSendPower(bool on, uint32_t* acked, int maxAcked) {
+  if (!tasmotaGroupReady()) return 0;
+
+  // Runs on a feeding worker - use the configured name, not the group task's copy
+  String name = tasmotaGroupGetName();
+  uint8_t buf[64];
+  uint16_t sequence = ++tasmotaGroupSequence;
+  int len = tasmotaGroupHeader(buf, sizeof(buf) - 6, name, sequence, 0);
+  if (len < 0) return 0;
+
+  uint32_t power = (on ? 1u : 0u) | (1u << 24);  // Relay 1, one relay
+  buf[len++] = DGR_ITEM_POWER;
+  buf[len++] = power & 0xFF;
+  buf[len++] = (power >> 8) & 0xFF;
+  buf[len++] = (power >> 16) & 0xFF;
+  buf[len++] = power >> 24;
+  buf[len++] = DGR_ITEM_EOL;
+
+  portENTER_CRITICAL(&tasmotaGroupMux);
+  tasmotaGroupAckSequence = sequence;
+  tasmotaGroupAckCount = 0;
+  portEXIT_CRITICAL(&tasmotaGroupMux);
+
+  // Members drop repeated sequence numbers, so repeating is safe
+  unsigned long start = millis();
+  for (int i = 0; i < TASMOTA_GROUP_REPEATS; i++) {
+    if (i > 0) vTaskDelay(pdMS_TO_TICKS(TASMOTA_GROUP_REPEAT_MS));
+    tasmotaGroupSend(buf, len);
+  }
+
+  // All known members acknowledged, or timeout
+  while (millis() - start < TASMOTA_GROUP_ACK_WAIT) {
+    if (tasmotaGroupAckCount >= tasmotaGroupMemberCount && tasmotaGroupMemberCount > 0) break;
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+
+  portENTER_CRITICAL(&tasmotaGroupMux);
+  int count = min(tasmotaGroupAckCount, maxAcked);
+  for (int i = 0; i < count; i++) acked[i] = tasmotaGroupAcks[i];
+  tasmotaGroupAckSequence = 0;
+  portEXIT_CRITICAL(&tasmotaGroupMux);
+
+  Serial.printf("  Device group '%s': %s sent, %d/%d member(s) acknowledged in %lu ms\n",
+                name.c_str(), on ? "ON" : "OFF", count, tasmotaGroupMemberCount,
+                millis() - start);
+  return count;
+}
+
+// ============================================================
+// Packet Decoding
+// ============================================================
+static void tasmotaGroupReceive(const uint8_t* buf, int len, uint32_t from) {
+  int headerLen = strlen(DGR_HEADER);
+  if (len < headerLen + 5 || memcmp(buf, DGR_HEADER, headerLen) != 0) return;
+
+  // Group name must match
+  const char* name = (const char*)buf + headerLen;
+  int nameLen = strnlen(name, len - headerLen);
+  if (headerLen + nameLen + 5 > len || tasmotaGroupJoined != name) return;
+
+  int pos = headerLen + nameLen + 1;
+  uint16_t sequence = buf[pos] | (buf[pos + 1] << 8);
+  uint16_t flags = buf[pos + 2] | (buf[pos + 3] << 8);
+  pos += 4;
+
+  tasmotaGroupAddMember(from);
+
+  if (flags & DGR_FLAG_ACK) {
+    portENTER_CRITICAL(&tasmotaGroupMux);
+    if (sequence == tasmotaGroupAckSequence && tasmotaGroupAckCount < TASMOTA_GROUP_MAX_MEMBERS) {
+      bool known = false;
+      for (int i = 0; i < tasmotaGroupAckCount; i++) {
+        if (tasmotaGroupAcks[i] == from) known = true;
+      }
+      if (!known) tasmotaGroupAcks[tasmotaGroupAckCount++] = from;
+    }
+    portEXIT_CRITICAL(&tasmotaGroupMux);
+    return;
+  }
+
+  // Walk the numeric items for the power state; strings and arrays are skipped
+  while (pos < len) {
+    uint8_t item = buf[pos++];
+    if (item == DGR_ITEM_EOL || item > DGR_ITEM_MAX_32BIT) break;
+
+    int size = item <= DGR_ITEM_MAX_8BIT ? 1 : item <= DGR_ITEM_MAX_16BIT ? 2 : 4;
+    if (pos + size > len) break;
+
+    if (item == DGR_ITEM_POWER && tasmotaGroupStateHandler) {
+      tasmotaGroupStateHandler(from, buf[pos] & 1);
+    }
+    pos += size;
+  }
+}
+
+// ============================================================
+// Socket Handling
+// ============================================================
+static void tasmotaGroupClose() {
+  if (tasmotaGroupSocket >= 0) {
+    lwip_close(tasmotaGroupSocket);
+    tasmotaGroupSocket = -1;
+  }
+}
+
+static bool tasmotaGroupOpen() {
+  int sock = lwip_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (sock < 0) return false;
+
+  int reuse = 1;
+  lwip_setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(TASMOTA_GROUP_PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (lwip_bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+    lwip_close(sock);
+    return false;
+  }
+
+  struct ip_mreq mreq;
+  mreq.imr_multiaddr.s_addr = inet_addr(TASMOTA_GROUP_ADDR);
+  mreq.imr_interface.s_addr = (uint32_t)WiFi.localIP();
+  if (lwip_setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+    lwip_close(sock);
+    return false;
+  }
+
+  struct timeval tv = { 0, 200000 };  // 200 ms receive timeout
+  lwip_setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  tasmotaGroupSocket = sock;
+  tasmotaGroupLocalIp = (uint32_t)WiFi.localIP();
+  return true;
+}
+
+static void tasmotaGroupTask(void* param) {
+  uint8_t buf[512];
+  unsigned long lastStatus = 0;
+
+  for (;;) {
+    bool connected = WiFi.status() == WL_CONNECTED;
+    bool reconfigure = tasmotaGroupReconfigure;
+
+    if (tasmotaGroupSocket >= 0 &&
+        (reconfigure || !connected || !tasmotaGroupEnabled() ||
+         (uint32_t)WiFi.localIP() != tasmotaGroupLocalIp)) {
+      tasmotaGroupClose();
+    }
+
+    if (reconfigure) {
+      xSemaphoreTake(tasmotaGroupConfigMutex, portMAX_DELAY);
+      tasmotaGroupReconfigure = false;
+      tasmotaGroupJoined = tasmotaGroupName;
+      xSemaphoreGive(tasmotaGroupConfigMutex);
+      
+      portENTER_CRITICAL(&tasmotaGroupMux);
+      tasmotaGroupMemberCount = 0;
+      portEXIT_CRITICAL(&tasmotaGroupMux);
+    }
+
+    if (tasmotaGroupSocket < 0) {
+      if (connected && tasmotaGroupJoined.length() > 0 && tasmotaGroupOpen()) {
+        Serial.printf("✓ Device group '%s' joined\n", tasmotaGroupJoined.c_str());
+        if (tasmotaGroupSequence == 0) tasmotaGroupSequence = esp_random() & 0x7FFF;
+        tasmotaGroupRequestStatus();
+        lastStatus = millis();
+      } else {
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        continue;
+      }
+    }
+
+    if (millis() - lastStatus >= TASMOTA_GROUP_STATUS_MS) {
+      tasmotaGroupRequestStatus();
+      lastStatus = millis();
+    }
+
+    struct sockaddr_in from;
+    socklen_t fromLen = sizeof(from);
+    int len = lwip_recvfrom(tasmotaGroupSocket, buf, sizeof(buf), 0, (struct sockaddr*)&from, &fromLen);
+    if (len > 0 && from.sin_addr.s_addr != tasmotaGroupLocalIp) {
+      tasmotaGroupReceive(buf, len, from.sin_addr.s_addr);
+    }
+  }
+}
+
+void tasmotaGroupBegin() {
+  if (tasmotaGroupTaskHandle) return;
+  if (!tasmotaGroupConfigMutex) tasmotaGroupConfigMutex = xSemaphoreCreateMutex();
+
+  xTaskCreatePinnedToCore(
+    tasmotaGroupTask,         // Task function
+    "tasmota_dgr",            // Name
+    TASMOTA_GROUP_STACK,      // Stack size
+    NULL,                     // Parameters
+    TASMOTA_GROUP_PRIORITY,   // Priority
+    &tasmotaGroupTaskHandle,  // Task handle
+    TASMOTA_GROUP_CORE        // Core
+  );
+}
+
+#endif // TASMOTA_GROUP_H
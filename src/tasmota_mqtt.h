@@ -0,0 +1,342 @@
+/**
+ * @file tasmota_mqtt.h
+ * @brief Optional MQTT transport for Tasmota devices
+ *
+ * With a broker configured, commands for devices with a known topic are
+ * published to cmnd/<topic>/<Command> over one persistent connection
+ * instead of one HTTP request each. Power state arrives as push updates
+ * from stat/<topic>/POWER, stat/<topic>/RESULT, tele/<topic>/STATE and
+ * tele/<topic>/LWT. The default Tasmota FullTopic (%prefix%/%topic%/)
+ * is assumed.
+ *
+ * A command waits for the stat/<topic>/RESULT (or STATUS*) messages it
+ * causes and returns them merged into one JSON object, the same shape as
+ * the HTTP /cm response. Backlog commands publish one RESULT per command.
+ *
+ * PubSubClient is only touched under tasmotaMqttMutex. Broker settings
+ * come from the web handler and are handed to the MQTT task under
+ * tasmotaMqttConfigMutex; the connection state is a flag the MQTT task
+ * writes. Lock order: tasmotaMqttMutex before the Tasmota device lock
+ * (the state handler runs inside PubSubClient::loop()).
+ */
+
+#ifndef TASMOTA_MQTT_H
+#define TASMOTA_MQTT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// ============================================================
+// Configuration
+// ============================================================
+#define TASMOTA_MQTT_DEFAULT_PORT   1883
+#define TASMOTA_MQTT_TIMEOUT        1500    // Wait for command results (ms)
+#define TASMOTA_MQTT_RECONNECT_MS   5000    // Delay between connection attempts
+#define TASMOTA_MQTT_BUFFER         2048    // Status responses are ~1.5 KB
+#define TASMOTA_MQTT_MAX_PENDING    4       // Concurrent commands (dispatch workers)
+#define TASMOTA_MQTT_GROUP_TOPIC    "tasmotas"  // Tasmota default group topic
+#define TASMOTA_MQTT_STACK          6144
+#define TASMOTA_MQTT_PRIORITY       1
+#define TASMOTA_MQTT_CORE           0
+
+// Power state push: power 1/0 (-1 = unknown), online false on LWT "Offline"
+typedef void (*TasmotaMqttStateHandler)(const String& topic, int power, bool online);
+
+struct TasmotaMqttConfig {
+  String host;      // Empty = MQTT off
+  uint16_t port;
+  String user;
+  String pass;
+};
+
+// ============================================================
+// MQTT State
+// ============================================================
+static TasmotaMqttConfig tasmotaMqttSettings = {"", TASMOTA_MQTT_DEFAULT_PORT, "", ""};  // Guarded by tasmotaMqttConfigMutex
+static TasmotaMqttConfig tasmotaMqttActive = {"", TASMOTA_MQTT_DEFAULT_PORT, "", ""};    // MQTT task only
+
+static WiFiClient tasmotaMqttNet;
+static PubSubClient tasmotaMqttClient(tasmotaMqttNet);
+static SemaphoreHandle_t tasmotaMqttMutex = NULL;         // Guards tasmotaMqttClient
+static SemaphoreHandle_t tasmotaMqttPendingMutex = NULL;  // Guards tasmotaMqttPending
+static SemaphoreHandle_t tasmotaMqttConfigMutex = NULL;   // Guards tasmotaMqttSettings
+static TaskHandle_t tasmotaMqttTaskHandle = NULL;
+static TasmotaMqttStateHandler tasmotaMqttStateHandler = NULL;
+static DRAM_ATTR volatile bool tasmotaMqttReconfigure = false;
+static DRAM_ATTR volatile bool tasmotaMqttHasBroker = false;     // Settings have a host
+static DRAM_ATTR volatile bool tasmotaMqttIsConnected = false;   // Written by the MQTT task only
+
+// A command waiting for its results
+struct TasmotaMqttPending {
+  String topic;
+  JsonDocument* merged;
+  int expected;             // RESULT messages to wait for
+  int received;
+  SemaphoreHandle_t done;
+};
+
+static TasmotaMqttPending tasmotaMqttPending[TASMOTA_MQTT_MAX_PENDING];
+
+bool tasmotaMqttEnabled() { return tasmotaMqttHasBroker; }
+
+bool tasmotaMqttConnected() {
+  return tasmotaMqttHasBroker && tasmotaMqttIsConnected;
+}
+
+void tasmotaMqttSetStateHandler(TasmotaMqttStateHandler handler) {
+  tasmotaMqttStateHandler = handler;
+}
+
+// Apply new broker settings - the connection task picks them up and reconnects
+void tasmotaMqttConfigure(const String& host, uint16_t port, const String& user, const String& pass) {
+  if (!tasmotaMqttConfigMutex) tasmotaMqttConfigMutex = xSemaphoreCreateMutex();
+  
+  xSemaphoreTake(tasmotaMqttConfigMutex, portMAX_DELAY);
+  tasmotaMqttSettings.host = host;
+  tasmotaMqttSettings.port = port > 0 ? port : TASMOTA_MQTT_DEFAULT_PORT;
+  tasmotaMqttSettings.user = user;
+  tasmotaMqttSettings.pass = pass;
+  tasmotaMqttHasBroker = host.length() > 0;
+  tasmotaMqttReconfigure = true;
+  xSemaphoreGive(tasmotaMqttConfigMutex);
+}
+
+// Copy of the broker settings (for the settings page and flash)
+TasmotaMqttConfig tasmotaMqttGetConfig() {
+  if (!tasmotaMqttConfigMutex) return tasmotaMqttSettings;  // Not configured yet
+  
+  xSemaphoreTake(tasmotaMqttConfigMutex, portMAX_DELAY);
+  TasmotaMqttConfig config = tasmotaMqttSettings;
+  xSemaphoreGive(tasmotaMqttConfigMutex);
+  return config;
+}
+
+// ============================================================
+// Incoming Messages
+// ============================================================
+// Split "<prefix>/<topic>/<suffix>" (default FullTopic)
+static bool tasmotaMqttSplitTopic(const char* full, String& prefix, String& topic, String& suffix) {
+  String s = full;
+  int a = s.indexOf('/');
+  int b = s.lastIndexOf('/');
+  if (a < 0 || b <= a) return false;
+  prefix = s.substring(0, a);
+  topic = s.substring(a + 1, b);
+  suffix = s.substring(b + 1);
+  return true;
+}
+
+static int tasmotaMqttPowerValue(const String& value) {
+  if (value == "ON") return 1;
+  if (value == "OFF") return 0;
+  return -1;
+}
+
+// Merge a RESULT/STATUS message into the pending command of the topic
+static void tasmotaMqttDeliverResult(const String& topic, JsonDocument& msg) {
+  xSemaphoreTake(tasmotaMqttPendingMutex, portMAX_DELAY);
+  for (int i = 0; i < TASMOTA_MQTT_MAX_PENDING; i++) {
+    TasmotaMqttPending& p = tasmotaMqttPending[i];
+    if (!p.merged || p.topic != topic) continue;
+
+    for (JsonPair kv : msg.as<JsonObject>()) {
+      (*p.merged)[kv.key()] = kv.value();
+    }
+    if (++p.received >= p.expected) xSemaphoreGive(p.done);
+    break;
+  }
+  xSemaphoreGive(tasmotaMqttPendingMutex);
+}
+
+static void tasmotaMqttCallback(char* fullTopic, byte* payload, unsigned int length) {
+  String prefix, topic, suffix;
+  if (!tasmotaMqttSplitTopic(fullTopic, prefix, topic, suffix)) return;
+
+  String value;
+  value.concat((const char*)payload, length);
+
+  if (prefix == "tele" && suffix == "LWT") {
+    if (tasmotaMqttStateHandler) tasmotaMqttStateHandler(topic, -1, value == "Online");
+    return;
+  }
+
+  if (prefix == "stat" && (suffix == "POWER" || suffix == "POWER1")) {
+    if (tasmotaMqttStateHandler) tasmotaMqttStateHandler(topic, tasmotaMqttPowerValue(value), true);
+    return;
+  }
+
+  bool result = (prefix == "stat" && (suffix == "RESULT" || suffix.startsWith("STATUS")));
+  bool state = (prefix == "tele" && suffix == "STATE");
+  if (!result && !state) return;
+
+  JsonDocument msg;
+  if (deserializeJson(msg, value) != DeserializationError::Ok || !msg.is<JsonObject>()) return;
+
+  if (result) tasmotaMqttDeliverResult(topic, msg);
+
+  String power = msg["POWER"] | msg["POWER1"] | "";
+  if (power.length() > 0 && tasmotaMqttStateHandler) {
+    tasmotaMqttStateHandler(topic, tasmotaMqttPowerValue(power), true);
+  }
+}
+
+// ============================================================
+// Send Command (returns merged results, empty on timeout)
+// ============================================================
+String tasmotaMqttCommand(const String& topic, const String& command,
+                          unsigned long timeoutMs = TASMOTA_MQTT_TIMEOUT) {
+  if (!tasmotaMqttConnected() || topic.length() == 0) return "";
+
+  // "Power ON" -> cmnd/<topic>/Power with payload "ON"
+  int space = command.indexOf(' ');
+  String name = space < 0 ? command : command.substring(0, space);
+  String args = space < 0 ? "" : command.substring(space + 1);
+
+  int expected = 1;
+  if (name.startsWith("Backlog")) {
+    for (unsigned int i = 0; i < args.length(); i++) {
+      if (args[i] == ';') expected++;
+    }
+  }
+
+  // Register before publishing so no result can be missed
+  JsonDocument merged;
+  merged.to<JsonObject>();
+  int slot = -1;
+  xSemaphoreTake(tasmotaMqttPendingMutex, portMAX_DELAY);
+  for (int i = 0; i < TASMOTA_MQTT_MAX_PENDING; i++) {
+    TasmotaMqttPending& p = tasmotaMqttPending[i];
+    if (p.merged && p.topic == topic) {
+      slot = -1;  // One command per device at a time
+      break;
+    }
+    if (!p.merged && slot < 0) slot = i;
+  }
+  if (slot >= 0) {
+    TasmotaMqttPending& p = tasmotaMqttPending[slot];
+    if (!p.done) p.done = xSemaphoreCreateBinary();
+    xSemaphoreTake(p.done, 0);  // Clear a stale give
+    p.topic = topic;
+    p.merged = &merged;
+    p.expected = expected;
+    p.received = 0;
+  }
+  xSemaphoreGive(tasmotaMqttPendingMutex);
+  if (slot < 0) return "";
+
+  String cmndTopic = "cmnd/" + topic + "/" + name;
+  xSemaphoreTake(tasmotaMqttMutex, portMAX_DELAY);
+  bool sent = tasmotaMqttClient.publish(cmndTopic.c_str(), args.c_str());
+  xSemaphoreGive(tasmotaMqttMutex);
+
+  if (sent) {
+    xSemaphoreTake(tasmotaMqttPending[slot].done, pdMS_TO_TICKS(timeoutMs));
+  }
+
+  xSemaphoreTake(tasmotaMqttPendingMutex, portMAX_DELAY);
+  tasmotaMqttPending[slot].merged = NULL;
+  tasmotaMqttPending[slot].topic = "";
+  int received = tasmotaMqttPending[slot].received;
+  xSemaphoreGive(tasmotaMqttPendingMutex);
+
+  // Partial Backlog results are returned as well - callers check the fields
+  if (!sent || received == 0) return "";
+
+  String response;
+  serializeJson(merged, response);
+  return response;
+}
+
+// ============================================================
+// Connection Task
+// ============================================================
+// PubSubClient keeps the host pointer - tasmotaMqttActive outlives the connection
+static bool tasmotaMqttConnect() {
+  String clientId = "feeding-break-" + WiFi.macAddress();
+  clientId.replace(":", "");
+
+  const TasmotaMqttConfig& cfg = tasmotaMqttActive;
+  tasmotaMqttClient.setServer(cfg.host.c_str(), cfg.port);
+  bool ok = cfg.user.length() > 0
+    ? tasmotaMqttClient.connect(clientId.c_str(), cfg.user.c_str(), cfg.pass.c_str())
+    : tasmotaMqttClient.connect(clientId.c_str());
+
+  if (!ok) {
+    Serial.printf("✗ MQTT: Connection to %s:%u failed (state %d)\n",
+                  cfg.host.c_str(), cfg.port, tasmotaMqttClient.state());
+    return false;
+  }
+
+  tasmotaMqttClient.subscribe("stat/+/+");
+  tasmotaMqttClient.subscribe("tele/+/+");
+
+  // Ask all devices for their power state (answered on stat/<topic>/POWER)
+  tasmotaMqttClient.publish("cmnd/" TASMOTA_MQTT_GROUP_TOPIC "/Power", "");
+
+  Serial.printf("✓ MQTT: Connected to %s:%u\n", cfg.host.c_str(), cfg.port);
+  return true;
+}
+
+static void tasmotaMqttTask(void* param) {
+  unsigned long lastAttempt = 0;
+  bool firstAttempt = true;
+
+  for (;;) {
+    xSemaphoreTake(tasmotaMqttMutex, portMAX_DELAY);
+
+    if (tasmotaMqttReconfigure) {
+      xSemaphoreTake(tasmotaMqttConfigMutex, portMAX_DELAY);
+      tasmotaMqttReconfigure = false;
+      TasmotaMqttConfig config = tasmotaMqttSettings;
+      xSemaphoreGive(tasmotaMqttConfigMutex);
+      
+      if (tasmotaMqttClient.connected()) tasmotaMqttClient.disconnect();
+      tasmotaMqttActive = config;  // After the disconnect - the client points into it
+      firstAttempt = true;
+    }
+
+    if (tasmotaMqttActive.host.length() > 0 && WiFi.status() == WL_CONNECTED) {
+      if (tasmotaMqttClient.connected()) {
+        tasmotaMqttClient.loop();
+      } else if (firstAttempt || millis() - lastAttempt >= TASMOTA_MQTT_RECONNECT_MS) {
+        firstAttempt = false;
+        lastAttempt = millis();
+        tasmotaMqttConnect();
+      }
+    } else if (tasmotaMqttClient.connected()) {
+      tasmotaMqttClient.disconnect();
+    }
+    bool connected = tasmotaMqttClient.connected();
+    tasmotaMqttIsConnected = connected;
+
+    xSemaphoreGive(tasmotaMqttMutex);
+    vTaskDelay(pdMS_TO_TICKS(connected ? 10 : 500));
+  }
+}
+
+void tasmotaMqttBegin() {
+  if (tasmotaMqttTaskHandle) return;
+  if (!tasmotaMqttMutex) tasmotaMqttMutex = xSemaphoreCreateMutex();
+  if (!tasmotaMqttPendingMutex) tasmotaMqttPendingMutex = xSemaphoreCreateMutex();
+  if (!tasmotaMqttConfigMutex) tasmotaMqttConfigMutex = xSemaphoreCreateMutex();
+  tasmotaMqttReconfigure = true;  // Take over the settings loaded before the task existed
+
+  tasmotaMqttClient.setBufferSize(TASMOTA_MQTT_BUFFER);
+  tasmotaMqttClient.setCallback(tasmotaMqttCallback);
+
+  xTaskCreatePinnedToCore(
+    tasmotaMqttTask,          // Task function
+    "tasmota_mqtt",           // Name
+    TASMOTA_MQTT_STACK,       // Stack size
+    NULL,                     // Parameters
+    TASMOTA_MQTT_PRIORITY,    // Priority
+    &tasmotaMqttTaskHandle,   // Task handle
+    TASMOTA_MQTT_CORE         // Core
+  );
+}
+
+#endif // TASMOTA_MQTT_H
@@ -0,0 +1,402 @@
+/**
+ * @file tls_session.h
+ * @brief TLS session resumption for the cloud API connections
+ *
+ * WiFiClientSecure always performs a full handshake and offers no hook to
+ * hand mbedTLS a previous session. TlsResumeClient replaces the connect
+ * step (insecure mode only, as used for all cloud calls) and offers the
+ * cached session ID / ticket of the host, so reconnects use the
+ * abbreviated handshake. Everything after the handshake (read, write,
+ * stop) is the stock WiFiClientSecure code operating on the same
+ * sslclient context.
+ *
+ * Sessions are cached per host in RAM and, if TLS_SESSION_PERSIST is set,
+ * stored obfuscated with the device key in Preferences so the first
+ * request after a reboot can resume as well. Flash is only written when
+ * the session ID or ticket changed, and at most every
+ * TLS_SESSION_PERSIST_MIN_MS per host.
+ *
+ * The handshake loop reads ssl_context.state, which is private from
+ * mbedTLS 3 on (Arduino-ESP32 3.x). There TlsResumeClient falls back to
+ * the stock WiFiClientSecure connect, i.e. full handshakes.
+ */
+
+#ifndef TLS_SESSION_H
+#define TLS_SESSION_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <Preferences.h>
+#include <ArduinoJson.h>
+#include <lwip/sockets.h>
+#include <mbedtls/version.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/error.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "crypto.h"
+
+extern Preferences preferences;
+
+// ============================================================
+// Configuration
+// ============================================================
+#define TLS_SESSION_CACHE_SIZE     2       // One per cloud host
+#define TLS_SESSION_PERSIST        1       // Keep sessions across reboots
+#define TLS_SESSION_MAX_BLOB       4096    // Upper bound for a stored session
+#define TLS_HANDSHAKE_TIMEOUT      10000   // ms
+#define TLS_SESSION_PERSIST_MIN_MS 900000  // Rewrite a host's session at most every 15 min
+
+// Stepping the handshake needs the public ssl_context of mbedTLS 2.x
+#define TLS_SESSION_RESUME_SUPPORTED  (MBEDTLS_VERSION_MAJOR < 3)
+
+// ============================================================
+// Session Cache
+// ============================================================
+struct TlsSessionEntry {
+  String host;
+  mbedtls_ssl_session session;
+  bool valid;
+  unsigned long lastUsed;
+  unsigned long persistedAt;   // 0 = not written since boot
+};
+
+struct TlsSessionStats {
+  uint32_t handshakes;       // All completed handshakes
+  uint32_t resumeAttempts;   // Handshakes that offered a cached session
+  uint32_t resumed;          // ... and were accepted by the server
+  uint32_t failures;         // Connect or handshake errors
+  uint32_t fullMsTotal;
+  uint32_t resumedMsTotal;
+  uint32_t lastMs;
+};
+
+static TlsSessionEntry tlsSessionCache[TLS_SESSION_CACHE_SIZE];
+static TlsSessionStats tlsSessionStats = {0, 0, 0, 0, 0, 0, 0};
+static SemaphoreHandle_t tlsSessionMutex = NULL;
+
+// Create the cache mutex - call once from setup() before any HTTPS request
+void tlsSessionCacheBegin() {
+  if (tlsSessionMutex) return;
+  tlsSessionMutex = xSemaphoreCreateMutex();
+  for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+    mbedtls_ssl_session_init(&tlsSessionCache[i].session);
+    tlsSessionCache[i].valid = false;
+    tlsSessionCache[i].persistedAt = 0;
+  }
+}
+
+// Find the entry of a host, or -1 - caller must hold the mutex
+static int tlsSessionFind(const char* host) {
+  for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+    if (tlsSessionCache[i].valid && tlsSessionCache[i].host == host) return i;
+  }
+  return -1;
+}
+
+// ============================================================
+// Persistence (Preferences keys tls_sess0..N)
+// ============================================================
+#if TLS_SESSION_PERSIST
+static void tlsSessionXor(uint8_t* buf, size_t len) {
+  uint8_t key[16];
+  getEncryptionKey(key);
+  for (size_t i = 0; i < len; i++) buf[i] ^= key[i % 16];
+}
+
+// Blob layout: [host length][host][mbedtls session], XOR'd with device key
+static void tlsSessionPersist(int slot) {
+  TlsSessionEntry& e = tlsSessionCache[slot];
+  size_t sessLen = 0;
+  mbedtls_ssl_session_save(&e.session, NULL, 0, &sessLen);
+  size_t hostLen = e.host.length();
+  size_t total = 1 + hostLen + sessLen;
+  if (sessLen == 0 || hostLen > 255 || total > TLS_SESSION_MAX_BLOB) return;
+
+  uint8_t* blob = (uint8_t*)malloc(total);
+  if (!blob) return;
+  blob[0] = (uint8_t)hostLen;
+  memcpy(blob + 1, e.host.c_str(), hostLen);
+  if (mbedtls_ssl_session_save(&e.session, blob + 1 + hostLen, sessLen, &sessLen) == 0) {
+    tlsSessionXor(blob, total);
+    String key = "tls_sess" + String(slot);
+    preferences.putBytes(key.c_str(), blob, total);
+  }
+  free(blob);
+}
+
+// Restore cached sessions from flash - call from setup() after preferences.begin()
+void tlsSessionCacheLoad() {
+  tlsSessionCacheBegin();
+  int restored = 0;
+
+  for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+    String key = "tls_sess" + String(i);
+    size_t total = preferences.getBytesLength(key.c_str());
+    if (total < 2 || total > TLS_SESSION_MAX_BLOB) continue;
+
+    uint8_t* blob = (uint8_t*)malloc(total);
+    if (!blob) continue;
+    preferences.getBytes(key.c_str(), blob, total);
+    tlsSessionXor(blob, total);
+
+    size_t hostLen = blob[0];
+    if (1 + hostLen < total) {
+      TlsSessionEntry& e = tlsSessionCache[i];
+      mbedtls_ssl_session_free(&e.session);
+      mbedtls_ssl_session_init(&e.session);
+      if (mbedtls_ssl_session_load(&e.session, blob + 1 + hostLen, total - 1 - hostLen) == 0) {
+        e.host = String((const char*)(blob + 1)).substring(0, hostLen);
+        e.valid = true;
+        e.lastUsed = 0;
+        restored++;
+      }
+    }
+    free(blob);
+  }
+
+  if (restored > 0) {
+    Serial.printf("✓ %d TLS session(s) restored for resumption\n", restored);
+  }
+}
+#else
+void tlsSessionCacheLoad() {
+  tlsSessionCacheBegin();
+}
+#endif
+
+#if TLS_SESSION_RESUME_SUPPORTED
+// A session the server can resume carries an ID or a ticket
+static bool tlsSessionResumable(const mbedtls_ssl_session& s) {
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+  if (s.ticket_len > 0) return true;
+#endif
+  return s.id_len > 0;
+}
+
+static bool tlsSessionSameId(const mbedtls_ssl_session& a, const mbedtls_ssl_session& b) {
+  if (a.id_len != b.id_len || memcmp(a.id, b.id, a.id_len) != 0) return false;
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+  if (a.ticket_len != b.ticket_len) return false;
+  if (a.ticket_len > 0 && memcmp(a.ticket, b.ticket, a.ticket_len) != 0) return false;
+#endif
+  return true;
+}
+
+// Record a completed handshake and store its session. Flash is only
+// written for a new session ID or ticket - a server that never resumes
+// (no ID, no ticket) or keeps resuming the same session costs no writes.
+static void tlsSessionStore(const char* host, mbedtls_ssl_context* ssl,
+                            bool offered, bool resumed, uint32_t elapsedMs) {
+  xSemaphoreTake(tlsSessionMutex, portMAX_DELAY);
+
+  tlsSessionStats.handshakes++;
+  tlsSessionStats.lastMs = elapsedMs;
+  if (offered) tlsSessionStats.resumeAttempts++;
+  if (resumed) {
+    tlsSessionStats.resumed++;
+    tlsSessionStats.resumedMsTotal += elapsedMs;
+  } else {
+    tlsSessionStats.fullMsTotal += elapsedMs;
+  }
+
+  int slot = tlsSessionFind(host);
+  if (slot < 0) {
+    // Free slot, or else the least recently used one
+    slot = 0;
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+      if (!tlsSessionCache[i].valid) { slot = i; break; }
+      if (tlsSessionCache[i].lastUsed < tlsSessionCache[slot].lastUsed) slot = i;
+    }
+  }
+
+  TlsSessionEntry& e = tlsSessionCache[slot];
+  mbedtls_ssl_session fresh;
+  mbedtls_ssl_session_init(&fresh);
+  bool valid = (mbedtls_ssl_get_session(ssl, &fresh) == 0) && tlsSessionResumable(fresh);
+  bool changed = valid && !(e.valid && e.host == host && tlsSessionSameId(e.session, fresh));
+
+  if (valid && !changed) {
+    mbedtls_ssl_session_free(&fresh);  // Same session - keep the cached copy
+  } else {
+    mbedtls_ssl_session_free(&e.session);
+    e.session = fresh;                 // Takes over ticket / peer cert buffers
+    e.valid = valid;
+    if (e.host != host) e.persistedAt = 0;
+  }
+  e.host = host;
+  e.lastUsed = millis();
+
+#if TLS_SESSION_PERSIST
+  if (changed && (e.persistedAt == 0 || millis() - e.persistedAt >= TLS_SESSION_PERSIST_MIN_MS)) {
+    tlsSessionPersist(slot);
+    e.persistedAt = millis();
+  }
+#endif
+
+  xSemaphoreGive(tlsSessionMutex);
+}
+#endif // TLS_SESSION_RESUME_SUPPORTED
+
+// ============================================================
+// Resuming TLS Client
+// ============================================================
+#if TLS_SESSION_RESUME_SUPPORTED
+class TlsResumeClient : public WiFiClientSecure {
+public:
+  using WiFiClientSecure::connect;
+
+  int connect(const char* host, uint16_t port) {
+    return connect(host, port, TLS_HANDSHAKE_TIMEOUT);
+  }
+
+  int connect(const char* host, uint16_t port, int32_t timeout) {
+    IPAddress ip;
+    if (!WiFi.hostByName(host, ip)) {
+      return 0;
+    }
+
+    // stop() frees the previous mbedTLS state - every free below is
+    // paired with these inits, also when the TCP connect fails
+    stop();
+    mbedtls_ssl_init(&sslclient->ssl_ctx);
+    mbedtls_ssl_config_init(&sslclient->ssl_conf);
+    mbedtls_ctr_drbg_init(&sslclient->drbg_ctx);
+    mbedtls_entropy_init(&sslclient->entropy_ctx);
+
+    unsigned long start = millis();
+    bool offered = false;
+    bool fullHandshake = false;
+
+    if (!tcpConnect(ip, port, timeout > 0 ? timeout : TLS_HANDSHAKE_TIMEOUT) ||
+        !handshake(host, offered, fullHandshake)) {
+      stop();
+      xSemaphoreTake(tlsSessionMutex, portMAX_DELAY);
+      tlsSessionStats.failures++;
+      xSemaphoreGive(tlsSessionMutex);
+      return 0;
+    }
+
+    tlsSessionStore(host, &sslclient->ssl_ctx, offered, offered && !fullHandshake, millis() - start);
+
+    _connected = true;
+    return 1;
+  }
+
+private:
+  // Non-blocking connect with timeout, same socket options as ssl_client.cpp
+  bool tcpConnect(const IPAddress& ip, uint16_t port, int32_t timeout) {
+    int fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) return false;
+    sslclient->socket = fd;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = (uint32_t)ip;
+    addr.sin_port = htons(port);
+
+    lwip_fcntl(fd, F_SETFL, lwip_fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int res = lwip_connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+    if (res < 0 && errno != EINPROGRESS) return false;
+
+    fd_set fdset;
+    FD_ZERO(&fdset);
+    FD_SET(fd, &fdset);
+    struct timeval tv;
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+    if (lwip_select(fd + 1, NULL, &fdset, NULL, &tv) <= 0) return false;
+
+    int sockErr = 0;
+    socklen_t errLen = sizeof(sockErr);
+    lwip_getsockopt(fd, SOL_SOCKET, SO_ERROR, &sockErr, &errLen);
+    if (sockErr != 0) return false;
+
+    lwip_setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    lwip_setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int enable = 1;
+    lwip_setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    lwip_setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+    return true;
+  }
+
+  bool handshake(const char* host, bool& offered, bool& fullHandshake) {
+    static const char* pers = "feeding_break_tls";
+
+    if (mbedtls_ctr_drbg_seed(&sslclient->drbg_ctx, mbedtls_entropy_func, &sslclient->entropy_ctx,
+                              (const unsigned char*)pers, strlen(pers)) != 0) return false;
+    if (mbedtls_ssl_config_defaults(&sslclient->ssl_conf, MBEDTLS_SSL_IS_CLIENT,
+                                    MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT) != 0) return false;
+
+    mbedtls_ssl_conf_authmode(&sslclient->ssl_conf, MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_rng(&sslclient->ssl_conf, mbedtls_ctr_drbg_random, &sslclient->drbg_ctx);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&sslclient->ssl_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
+    if (mbedtls_ssl_setup(&sslclient->ssl_ctx, &sslclient->ssl_conf) != 0) return false;
+    if (mbedtls_ssl_set_hostname(&sslclient->ssl_ctx, host) != 0) return false;
+
+    // Offer the cached session (ID or ticket) of this host
+    xSemaphoreTake(tlsSessionMutex, portMAX_DELAY);
+    int slot = tlsSessionFind(host);
+    if (slot >= 0) {
+      offered = (mbedtls_ssl_set_session(&sslclient->ssl_ctx, &tlsSessionCache[slot].session) == 0);
+      tlsSessionCache[slot].lastUsed = millis();
+    }
+    xSemaphoreGive(tlsSessionMutex);
+
+    mbedtls_ssl_set_bio(&sslclient->ssl_ctx, &sslclient->socket, mbedtls_net_send, mbedtls_net_recv, NULL);
+
+    // Step through the handshake: an abbreviated handshake goes straight
+    // from ServerHello to ChangeCipherSpec and never reaches the
+    // server certificate state
+    unsigned long start = millis();
+    while (sslclient->ssl_ctx.state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+      int ret = mbedtls_ssl_handshake_step(&sslclient->ssl_ctx);
+      if (sslclient->ssl_ctx.state == MBEDTLS_SSL_SERVER_CERTIFICATE) fullHandshake = true;
+      if (ret == 0) continue;
+      if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        char buf[96];
+        mbedtls_strerror(ret, buf, sizeof(buf));
+        Serial.printf("✗ TLS handshake with %s failed: %s\n", host, buf);
+        return false;
+      }
+      if (millis() - start > TLS_HANDSHAKE_TIMEOUT) return false;
+      vTaskDelay(2);
+    }
+    if (!offered) fullHandshake = true;
+    return true;
+  }
+};
+#else
+// mbedTLS 3: no access to the handshake state - full handshakes only
+class TlsResumeClient : public WiFiClientSecure {
+};
+#endif
+
+// ============================================================
+// Statistics
+// ============================================================
+void tlsSessionAddStatsJson(JsonObject obj) {
+  xSemaphoreTake(tlsSessionMutex, portMAX_DELAY);
+  TlsSessionStats stats = tlsSessionStats;
+  xSemaphoreGive(tlsSessionMutex);
+  uint32_t full = stats.handshakes - stats.resumed;
+
+  obj["handshakes"] = stats.handshakes;
+  obj["resume_attempts"] = stats.resumeAttempts;
+  obj["resumed"] = stats.resumed;
+  obj["failures"] = stats.failures;
+  obj["hit_rate"] = stats.resumeAttempts > 0 ? (float)stats.resumed / stats.resumeAttempts : 0.0f;
+  obj["full_avg_ms"] = full > 0 ? stats.fullMsTotal / full : 0;
+  obj["resumed_avg_ms"] = stats.resumed > 0 ? stats.resumedMsTotal / stats.resumed : 0;
+  obj["last_ms"] = stats.lastMs;
+}
+
+#endif // TLS_SESSION_H
@@ -6,7 +6,11 @@
 #include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
 #include <WebSocketsClient.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include "config.h"
+#include "https_pool.h"
+#include "cloud_listing.h"
 
 // External references
 extern String TUNZE_USERNAME;
@@ -26,11 +30,9 @@ bool tunzeLogin() {
     return false;
   }
   
-  WiFiClientSecure client;
-  client.setInsecure();
-  
-  HTTPClient http;
-  http.begin(client, "https://tunze-hub.com/action/login");
+  HttpsLease lease(TUNZE_HUB_HOST);
+  HTTPClient& http = lease.http();
+  http.begin(lease.client(), "https://tunze-hub.com/action/login");
   http.setTimeout(10000);  // 10s timeout
   http.setConnectTimeout(5000);  // 5s connect timeout
   http.addHeader("Content-Type", "application/json");
@@ -72,111 +74,118 @@ bool tunzeLogin() {
   return false;
 }
 
-String tunzeGetDevices() {
-  if (tunzeSID.isEmpty()) {
-    Serial.println("No Tunze SID - logging in first...");
-    if (!tunzeLogin()) {
-      return "{\"success\":false,\"message\":\"Login failed\"}";
-    }
-  }
-  
-  WiFiClientSecure client;
-  client.setInsecure();
-  
-  HTTPClient http;
-  http.begin(client, "https://tunze-hub.com/action/getDevices");
+// One getDevices request into result, returns the HTTP code
+static int tunzeGetDevicesOnce(JsonDocument& result) {
+  HttpsLease lease(TUNZE_HUB_HOST);
+  HTTPClient& http = lease.http();
+  http.begin(lease.client(), "https://tunze-hub.com/action/getDevices");
   http.setTimeout(8000);  // 8s timeout
   http.setConnectTimeout(4000);  // 4s connect timeout
   http.addHeader("Content-Type", "application/json");
   http.addHeader("Cookie", "SID=" + tunzeSID);
+  http.useHTTP10(true);  // No chunked encoding - the body is parsed straight from the stream
   
   Serial.println("Fetching Tunze devices...");
   int httpCode = http.POST("{}");
+  http.useHTTP10(false);  // Pooled HTTPClient - back to keep-alive for the next request
+  
+  if (httpCode != 200) {
+    http.end();
+    return httpCode;
+  }
+  
+  // Keep only the fields we emit
+  JsonDocument filter;
+  tunzeDeviceFilter(filter);
   
-  if (httpCode == 200) {
-    String payload = http.getString();
-    Serial.println("Tunze Devices Response:");
-    Serial.println(payload);
-    Serial.println("---");
+  JsonDocument doc;
+  DeserializationError error = deserializeJson(doc, http.getStream(), DeserializationOption::Filter(filter));
+  http.end();
+  
+  if (error) {
+    Serial.print("✗ JSON parse error: ");
+    Serial.println(error.c_str());
+    result["success"] = false;
+    result["message"] = "Failed to fetch devices";
+    return httpCode;
+  }
+  
+  result["success"] = true;
+  JsonArray devices = result["devices"].to<JsonArray>();
+  
+  // Parse gateways (controllers)
+  for (JsonObject gw : doc["gateways"].as<JsonArray>()) {
+    JsonObject d = devices.add<JsonObject>();
+    d["imei"] = gw["imei"].as<String>();
+    d["name"] = gw["name"].as<String>();
+    d["type"] = "Gateway";
+    d["model"] = gw["type"].as<String>();
+    d["firmware"] = gw["firmware"]["version"].as<String>();
+    d["serial"] = gw["sn"].as<String>();
     
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, payload);
+    Serial.print("Gateway: ");
+    Serial.print(gw["name"].as<String>());
+    Serial.print(" (");
+    Serial.print(gw["imei"].as<String>());
+    Serial.println(")");
+  }
+  
+  // Parse endpoints (devices)
+  for (JsonObject ep : doc["endpoints"].as<JsonArray>()) {
+    String deviceName = ep["name"] | "";
+    if (deviceName.length() == 0) {
+      deviceName = "Device " + ep["type"].as<String>();
+    }
     
-    if (!error) {
-      String result = "{\"success\":true,\"devices\":[";
-      
-      bool first = true;
-      
-      // Parse gateways (controllers)
-      if (doc["gateways"].is<JsonArray>()) {
-        JsonArray gateways = doc["gateways"];
-        for (JsonObject gw : gateways) {
-          if (!first) result += ",";
-          first = false;
-          
-          result += "{";
-          result += "\"imei\":\"" + gw["imei"].as<String>() + "\"";
-          result += ",\"name\":\"" + gw["name"].as<String>() + "\"";
-          result += ",\"type\":\"Gateway\"";
-          result += ",\"model\":\"" + gw["type"].as<String>() + "\"";
-          result += ",\"firmware\":\"" + gw["firmware"]["version"].as<String>() + "\"";
-          result += ",\"serial\":\"" + gw["sn"].as<String>() + "\"";
-          result += "}";
-          
-          Serial.print("Gateway: ");
-          Serial.print(gw["name"].as<String>());
-          Serial.print(" (");
-          Serial.print(gw["imei"].as<String>());
-          Serial.println(")");
-        }
-      }
-      
-      // Parse endpoints (devices)
-      if (doc["endpoints"].is<JsonArray>()) {
-        JsonArray endpoints = doc["endpoints"];
-        for (JsonObject ep : endpoints) {
-          if (!first) result += ",";
-          first = false;
-          
-          String deviceName = ep["name"].as<String>();
-          if (deviceName.length() == 0) {
-            deviceName = "Device " + ep["type"].as<String>();
-          }
-          
-          result += "{";
-          result += "\"imei\":\"" + ep["imei"].as<String>() + "\"";
-          result += ",\"name\":\"" + deviceName + "\"";
-          result += ",\"type\":\"Endpoint\"";
-          result += ",\"model\":\"" + ep["type"].as<String>() + "\"";
-          result += ",\"slot\":\"" + ep["slot"].as<String>() + "\"";
-          result += "}";
-          
-          Serial.print("Endpoint: ");
-          Serial.print(deviceName);
-          Serial.print(" (");
-          Serial.print(ep["type"].as<String>());
-          Serial.println(")");
-        }
+    JsonObject d = devices.add<JsonObject>();
+    d["imei"] = ep["imei"].as<String>();
+    d["name"] = deviceName;
+    d["type"] = "Endpoint";
+    d["model"] = ep["type"].as<String>();
+    d["slot"] = ep["slot"].as<String>();
+    
+    Serial.print("Endpoint: ");
+    Serial.print(deviceName);
+    Serial.print(" (");
+    Serial.print(ep["type"].as<String>());
+    Serial.println(")");
+  }
+  
+  return httpCode;
+}
+
+// Fill result with {"success":..,"devices":[..]} or {"success":false,"message":..}
+bool tunzeGetDevices(JsonDocument& result) {
+  result.clear();
+  
+  // Second attempt only after an expired session (HTTP 401)
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (tunzeSID.isEmpty()) {
+      Serial.println("No Tunze SID - logging in first...");
+      if (!tunzeLogin()) {
+        result["success"] = false;
+        result["message"] = "Login failed";
+        return false;
       }
-      
-      result += "]}";
-      http.end();
-      return result;
-    } else {
-      Serial.print("✗ JSON parse error: ");
-      Serial.println(error.c_str());
     }
-  } else if (httpCode == 401) {
-    http.end();
-    tunzeSID = "";
-    return tunzeGetDevices();
-  } else {
+    
+    int httpCode = tunzeGetDevicesOnce(result);
+    if (httpCode == 200) {
+      return result["success"].as<bool>();
+    } else if (httpCode == 401) {
+      tunzeSID = "";
+      continue;
+    }
+    
     Serial.print("✗ Failed to fetch Tunze devices with code: ");
     Serial.println(httpCode);
+    break;
   }
   
-  http.end();
-  return "{\"success\":false,\"message\":\"Failed to fetch devices\"}";
+  result.clear();
+  result["success"] = false;
+  result["message"] = "Failed to fetch devices";
+  return false;
 }
 
 void tunzeConnect() {
@@ -259,48 +268,139 @@ void tunzeWebSocketEvent(WStype_t type, uint8_t * payload, size_t length) {
   }
 }
 
-void tunzeStartFeeding() {
-  if (!tunzeConnected) {
-    Serial.println("⚠ Tunze not connected - connecting now...");
-    tunzeConnect();
-    delay(2000);
-  }
-  
-  if (!tunzeConnected) {
-    Serial.println("✗ Tunze connection failed - skipping");
-    return;
-  }
-  
+// ============================================================
+// Feeding Commands
+// tunzeWebSocket is not thread-safe and belongs to loop(). The feeding
+// backend task only queues the command and waits for loop() to report
+// the result; loop() connects first if needed and drops a request whose
+// deadline has passed, so a late "start" never lands after a "stop".
+// ============================================================
+#define TUNZE_COMMAND_TIMEOUT   7000   // Below FEEDING_DEADLINE_TUNZE
+#define TUNZE_RESULT_GRACE      300    // Backend waits this long past the deadline
+#define TUNZE_REQUEST_QUEUE     2
+
+enum TunzeCommand : uint8_t {
+  TUNZE_CMD_START,
+  TUNZE_CMD_STOP
+};
+
+struct TunzeRequest {
+  uint32_t seq;
+  TunzeCommand command;
+  unsigned long deadline;   // millis() after which loop() drops the request
+};
+
+struct TunzeResult {
+  uint32_t seq;
+  bool success;
+};
+
+static QueueHandle_t tunzeRequestQueue = NULL;
+static QueueHandle_t tunzeResultQueue = NULL;  // Length 1 - latest result wins
+static uint32_t tunzeNextSeq = 0;              // Feeding backend lock serializes callers
+
+// Create the command queues (call once in setup)
+void tunzeCommandBegin() {
+  if (tunzeRequestQueue) return;
+  tunzeRequestQueue = xQueueCreate(TUNZE_REQUEST_QUEUE, sizeof(TunzeRequest));
+  tunzeResultQueue = xQueueCreate(1, sizeof(TunzeResult));
+}
+
+// Runs on loop()
+static bool tunzeSendFeedingCommand(TunzeCommand command) {
   tunzeMessageId++;
-  String feedMsg = "{\"mid\":" + String(tunzeMessageId) + ",\"";
-  feedMsg += TUNZE_DEVICE_ID;
-  feedMsg += "-1002-0001\":[[\"acts\",200,600]]}";
+  String msg = "{\"mid\":" + String(tunzeMessageId) + ",\"";
+  msg += TUNZE_DEVICE_ID;
+  msg += (command == TUNZE_CMD_START) ? "-1002-0001\":[[\"acts\",200,600]]}" : "-1002-0001\":[[\"deas\"]]}";
   
   if (DEBUG_TUNZE) {
     Serial.print("Tunze -> ");
-    Serial.println(feedMsg);
+    Serial.println(msg);
   }
-  tunzeWebSocket.sendTXT(feedMsg);
-  Serial.println("✓ Tunze feeding mode started (10 min)");
+  bool sent = tunzeWebSocket.sendTXT(msg);
+  if (command == TUNZE_CMD_START) {
+    Serial.println("✓ Tunze feeding mode started (10 min)");
+  } else {
+    Serial.println("✓ Tunze feeding mode stopped");
+  }
+  return sent;
 }
 
-void tunzeStopFeeding() {
-  if (!tunzeConnected) {
-    Serial.println("⚠ Tunze not connected - cannot stop");
+static void tunzeReply(uint32_t seq, bool success) {
+  TunzeResult result = { seq, success };
+  xQueueOverwrite(tunzeResultQueue, &result);
+}
+
+// Execute queued feeding commands - call from loop() only, next to
+// tunzeWebSocket.loop() which drives a pending connect
+void tunzeServiceCommands() {
+  static TunzeRequest active;
+  static bool hasActive = false;
+  static bool connectIssued = false;
+  
+  if (!tunzeRequestQueue) return;
+  if (!hasActive) {
+    if (xQueueReceive(tunzeRequestQueue, &active, 0) != pdTRUE) return;
+    hasActive = true;
+    connectIssued = false;
+  }
+  
+  if ((long)(millis() - active.deadline) >= 0) {
+    Serial.println("✗ Tunze connection failed - skipping");
+    tunzeReply(active.seq, false);
+    hasActive = false;
     return;
   }
   
-  tunzeMessageId++;
-  String stopMsg = "{\"mid\":" + String(tunzeMessageId) + ",\"";
-  stopMsg += TUNZE_DEVICE_ID;
-  stopMsg += "-1002-0001\":[[\"deas\"]]}";
+  if (!tunzeConnected) {
+    if (active.command == TUNZE_CMD_STOP) {
+      Serial.println("⚠ Tunze not connected - cannot stop");
+      tunzeReply(active.seq, false);
+      hasActive = false;
+    } else if (!connectIssued) {
+      Serial.println("⚠ Tunze not connected - connecting now...");
+      tunzeConnect();
+      connectIssued = true;
+    }
+    return;  // Checked again on the next pass until connected or expired
+  }
   
-  if (DEBUG_TUNZE) {
-    Serial.print("Tunze -> ");
-    Serial.println(stopMsg);
+  tunzeReply(active.seq, tunzeSendFeedingCommand(active.command));
+  hasActive = false;
+}
+
+// Runs on the feeding backend task - waits for loop() to execute the command
+static bool tunzeRunCommand(TunzeCommand command) {
+  if (!tunzeRequestQueue) return false;
+  
+  TunzeRequest request;
+  request.seq = ++tunzeNextSeq;
+  request.command = command;
+  request.deadline = millis() + TUNZE_COMMAND_TIMEOUT;
+  if (xQueueSend(tunzeRequestQueue, &request, 0) != pdTRUE) {
+    Serial.println("✗ Tunze command queue full");
+    return false;
   }
-  tunzeWebSocket.sendTXT(stopMsg);
-  Serial.println("✓ Tunze feeding mode stopped");
+  
+  unsigned long waitUntil = request.deadline + TUNZE_RESULT_GRACE;
+  TunzeResult result;
+  long remaining;
+  while ((remaining = (long)(waitUntil - millis())) > 0) {
+    if (xQueueReceive(tunzeResultQueue, &result, pdMS_TO_TICKS(remaining)) != pdTRUE) break;
+    if (result.seq == request.seq) return result.success;
+    // Result of an earlier request we already gave up on - ignore
+  }
+  
+  Serial.println("✗ Tunze: no result from loop() in time");
+  return false;
+}
+
+bool tunzeStartFeeding() {
+  return tunzeRunCommand(TUNZE_CMD_START);
+}
+
+bool tunzeStopFeeding() {
+  return tunzeRunCommand(TUNZE_CMD_STOP);
 }
 
 #endif // TUNZE_API_H
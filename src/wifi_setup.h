@@ -6,8 +6,13 @@
 #include <ESPAsyncWebServer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <esp_wifi.h>
+#include <esp_timer.h>
+#include <esp_random.h>
 #include "config.h"
 #include "credentials.h"
+#include "led_pattern.h"
+#include "web_assets.h"
 
 // External references
 extern AsyncWebServer *configServer;
@@ -16,51 +21,71 @@ extern bool wifiConfigMode;
 extern unsigned long restartScheduledTime;
 
 void setupWiFi();
+bool setupWiFiBegin();
+void setupWiFiFinish();
 void startConfigPortal();
 void stopConfigPortal();
 void handleConfigPortal();
+void wifiReconnectBegin();
 
-void setupWiFi() {
+// Boot pipeline: association runs while the display initializes
+#define WIFI_BOOT_TIMEOUT_MS  10000   // Total time allowed from setupWiFiBegin()
+
+static unsigned long wifiBootStart = 0;
+static bool wifiBootHasCredentials = false;
+
+// Start associating with the saved network - returns immediately
+bool setupWiFiBegin() {
   String ssid, password;
   
-  if (loadWiFiCredentials(ssid, password)) {
-    Serial.println("Initializing WiFi...");
-    Serial.print("Found saved WiFi credentials\nConnecting to: ");
-    Serial.println(ssid);
-    
-    // Use WiFi events for non-blocking connection
-    WiFi.mode(WIFI_STA);
-    WiFi.setAutoReconnect(true);
-    WiFi.begin(ssid.c_str(), password.c_str());
-    
-    // Non-blocking wait with vTaskDelay to allow other tasks
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 40) {
-      vTaskDelay(pdMS_TO_TICKS(250));  // Use FreeRTOS delay instead of Arduino delay
-      Serial.print(".");
-      Serial.flush();
-      attempts++;
-    }
-    Serial.println();
-    
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.println("✓ WiFi connected!");
-      Serial.print("IP address: ");
-      Serial.println(WiFi.localIP());
-      Serial.print("Signal strength: ");
-      Serial.print(WiFi.RSSI());
-      Serial.println(" dBm");
-    } else {
-      Serial.println("✗ WiFi connection failed");
-      Serial.println("Starting configuration portal...");
-      startConfigPortal();
-    }
-  } else {
+  wifiBootStart = millis();
+  wifiBootHasCredentials = loadWiFiCredentials(ssid, password);
+  if (!wifiBootHasCredentials) return false;
+  
+  Serial.println("Initializing WiFi...");
+  Serial.print("Found saved WiFi credentials\nConnecting to: ");
+  Serial.println(ssid);
+  
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(true);
+  WiFi.begin(ssid.c_str(), password.c_str());
+  return true;
+}
+
+// Wait for the association started by setupWiFiBegin(), else start the portal
+void setupWiFiFinish() {
+  if (!wifiBootHasCredentials) {
     Serial.println("No saved WiFi credentials found");
     Serial.println("Starting configuration portal...");
     Serial.flush();
     startConfigPortal();
+    return;
+  }
+  
+  // Non-blocking wait with vTaskDelay to allow other tasks
+  while (WiFi.status() != WL_CONNECTED && millis() - wifiBootStart < WIFI_BOOT_TIMEOUT_MS) {
+    vTaskDelay(pdMS_TO_TICKS(250));  // Use FreeRTOS delay instead of Arduino delay
+    Serial.print(".");
   }
+  Serial.println();
+  
+  if (WiFi.status() == WL_CONNECTED) {
+    Serial.printf("✓ WiFi connected after %lu ms!\n", millis() - wifiBootStart);
+    Serial.print("IP address: ");
+    Serial.println(WiFi.localIP());
+    Serial.print("Signal strength: ");
+    Serial.print(WiFi.RSSI());
+    Serial.println(" dBm");
+  } else {
+    Serial.println("✗ WiFi connection failed");
+    Serial.println("Starting configuration portal...");
+    startConfigPortal();
+  }
+}
+
+void setupWiFi() {
+  setupWiFiBegin();
+  setupWiFiFinish();
 }
 
 void startConfigPortal() {
@@ -72,15 +97,8 @@ void startConfigPortal() {
   
   wifiConfigMode = true;
   
-  // Blink LED slowly in config mode (shorter)
-  if (LED_PIN >= 0) {
-    for (int i = 0; i < 3; i++) {
-      digitalWrite(LED_PIN, HIGH);
-      delay(100);
-      digitalWrite(LED_PIN, LOW);
-      delay(100);
-    }
-  }
+  // Blink LED slowly for as long as the portal runs
+  ledSetBase(LED_PATTERN_CONFIG);
   
   // IMPORTANT: Properly initialize WiFi and let LWIP stack fully start
   WiFi.mode(WIFI_OFF);
@@ -133,66 +151,10 @@ void startConfigPortal() {
     request->redirect("http://" + WiFi.softAPIP().toString() + "/");
   });
   
-  // Serve configuration page
+  // Serve configuration page - gzipped in flash (web/portal, built by web_assets.py)
   configServer->on("/", HTTP_GET, [](AsyncWebServerRequest *request){
-    String html = "<!DOCTYPE html><html><head>";
-    html += "<meta charset='UTF-8'>";
-    html += "<meta name='viewport' content='width=device-width,initial-scale=1'>";
-    html += "<title>WiFi Setup</title>";
-    html += "<style>";
-    html += "body{font-family:Arial;margin:0;padding:20px;background:#0066cc}";
-    html += ".container{max-width:400px;margin:0 auto;background:#fff;padding:30px;border-radius:10px;box-shadow:0 4px 6px rgba(0,0,0,0.3)}";
-    html += "h1{color:#0066cc;margin-top:0;text-align:center}";
-    html += "label{display:block;margin:15px 0 5px;font-weight:bold;color:#333}";
-    html += "input,select{width:100%;padding:10px;border:2px solid #ddd;border-radius:5px;box-sizing:border-box;font-size:16px}";
-    html += "input:focus,select:focus{outline:none;border-color:#0066cc}";
-    html += "button{width:100%;padding:12px;background:#0066cc;color:#fff;border:none;border-radius:5px;font-size:16px;font-weight:bold;cursor:pointer;margin-top:20px}";
-    html += "button:hover{background:#0052a3}";
-    html += ".scan{background:#28a745;margin-bottom:10px}";
-    html += ".scan:hover{background:#218838}";
-    html += "#networks{display:none;margin:10px 0}";
-    html += ".network{padding:10px;background:#f8f9fa;margin:5px 0;border-radius:5px;cursor:pointer;border:2px solid #ddd}";
-    html += ".network:hover{background:#e9ecef;border-color:#0066cc}";
-    html += ".loading{text-align:center;padding:20px;display:none}";
-    html += "</style></head><body>";
-    html += "<div class='container'>";
-    html += "<h1>🐠 WiFi Setup</h1>";
-    html += "<button class='scan' onclick='scanNetworks()'>📡 Scan Networks</button>";
-    html += "<div class='loading' id='loading'>Scanning...</div>";
-    html += "<div id='networks'></div>";
-    html += "<form action='/save' method='POST'>";
-    html += "<label>WiFi Network:</label>";
-    html += "<input type='text' name='ssid' id='ssid' placeholder='Enter SSID' required>";
-    html += "<label>Password:</label>";
-    html += "<input type='password' name='password' placeholder='Enter Password' required>";
-    html += "<button type='submit'>💾 Save & Connect</button>";
-    html += "</form></div>";
-    html += "<script>";
-    html += "function scanNetworks(){";
-    html += "document.getElementById('loading').style.display='block';";
-    html += "document.getElementById('networks').style.display='none';";
-    html += "pollScan();";
-    html += "}";
-    html += "function pollScan(){";
-    html += "fetch('/scan').then(r=>r.json()).then(data=>{";
-    html += "if(data.status=='started'||data.status=='scanning'){";
-    html += "setTimeout(pollScan,2000);";
-    html += "}else if(data.networks){";
-    html += "document.getElementById('loading').style.display='none';";
-    html += "let html='';";
-    html += "data.networks.forEach(n=>{";
-    html += "html+='<div class=\"network\" onclick=\"selectNetwork(\\''+n.ssid+'\\')\">';";
-    html += "html+='📶 '+n.ssid+' ('+n.rssi+' dBm)'+(n.secure?' 🔒':'');";
-    html += "html+='</div>';";
-    html += "});";
-    html += "document.getElementById('networks').innerHTML=html;";
-    html += "document.getElementById('networks').style.display='block';";
-    html += "}";
-    html += "}).catch(e=>{document.getElementById('loading').innerHTML='Error: '+e;});";
-    html += "}";
-    html += "function selectNetwork(ssid){document.getElementById('ssid').value=ssid;}";
-    html += "</script></body></html>";
-    AsyncWebServerResponse *response = request->beginResponse(200, "text/html", html);
+    AsyncWebServerResponse *response = request->beginResponse(200, "text/html", WEB_PORTAL_HTML_GZ, WEB_PORTAL_HTML_GZ_LEN);
+    response->addHeader("Content-Encoding", "gzip");
     response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
     response->addHeader("Pragma", "no-cache");
     response->addHeader("Expires", "0");
@@ -257,39 +219,11 @@ void startConfigPortal() {
     if (ssid.length() > 0) {
       saveWiFiCredentials(ssid, password);
       
-      String html = "<!DOCTYPE html><html><head><meta charset='UTF-8'>";
-      html += "<meta name='viewport' content='width=device-width,initial-scale=1'>";
-      html += "<title>Verbinden...</title>";
-      html += "<style>body{font-family:Arial;text-align:center;padding:50px;background:#0066cc;color:#fff}";
-      html += "h1{font-size:48px}";
-      html += ".spinner{border:8px solid #f3f3f3;border-top:8px solid #fff;border-radius:50%;width:60px;height:60px;animation:spin 1s linear infinite;margin:30px auto}";
-      html += "@keyframes spin{0%{transform:rotate(0deg)}100%{transform:rotate(360deg)}}";
-      html += "</style>";
-      html += "<script>";
-      html += "let attempts=0;";
-      html += "function checkConnection(){";
-      html += "attempts++;";
-      html += "fetch('/api/status').then(r=>r.json()).then(data=>{";
-      html += "if(data.connected && data.ip){";
-      html += "document.getElementById('status').innerHTML='✓ Verbunden!<br>Weiterleitung zu '+data.ip+'...';";
-      html += "setTimeout(function(){window.location.href='http://'+data.ip+'/';},2000);";
-      html += "}else if(attempts<20){";
-      html += "setTimeout(checkConnection,1000);";
-      html += "}else{";
-      html += "document.getElementById('status').innerHTML='⚠ Verbindung fehlgeschlagen<br>Bitte manuell zu 192.168.x.x verbinden';";
-      html += "}";
-      html += "}).catch(e=>{if(attempts<20)setTimeout(checkConnection,1000);});";
-      html += "}";
-      html += "setTimeout(checkConnection,5000);";
-      html += "</script>";
-      html += "</head><body>";
-      html += "<h1>💾 Gespeichert!</h1>";
-      html += "<p>SSID: " + ssid + "</p>";
-      html += "<div class='spinner'></div>";
-      html += "<p id='status'>Verbinde mit WiFi...</p>";
-      html += "</body></html>";
-      
-      request->send(200, "text/html", html);
+      // Static page in flash (web/portal/saved.html) - the SSID is filled in by the browser
+      AsyncWebServerResponse *response = request->beginResponse(200, "text/html", WEB_PORTAL_SAVED_HTML_GZ, WEB_PORTAL_SAVED_HTML_GZ_LEN);
+      response->addHeader("Content-Encoding", "gzip");
+      response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+      request->send(response);
       
       restartScheduledTime = millis() + 3000;
       Serial.println("Restart scheduled in 3 seconds...");
@@ -318,11 +252,6 @@ void handleConfigPortal() {
     Serial.println("Restarting now...");
     ESP.restart();
   }
-  
-  // LED blinking in config mode
-  if (LED_PIN >= 0) {
-    digitalWrite(LED_PIN, (millis() / 500) % 2);
-  }
 }
 
 void stopConfigPortal() {
@@ -344,4 +273,148 @@ void stopConfigPortal() {
   Serial.println("✓ Config portal stopped");
 }
 
-#endif // WIFI_SETUP_H
\ No newline at end of file
+
+// ============================================================
+// WiFi Reconnect State Machine
+// Driven by WiFi events and a one-shot esp_timer - nothing here
+// blocks the loop. The loop task only picks up the link lost /
+// link restored continuations (pool flush, Tunze reconnect).
+// ============================================================
+#define WIFI_RECONNECT_BASE_MS      1000    // First retry after ~1 s
+#define WIFI_RECONNECT_MAX_MS       60000   // Backoff cap
+#define WIFI_CONNECT_TIMEOUT_MS     15000   // Attempt without GOT_IP counts as failed
+
+enum WiFiLinkState : uint8_t {
+  WIFI_LINK_UP,          // Connected with IP
+  WIFI_LINK_BACKOFF,     // Waiting for the next attempt
+  WIFI_LINK_CONNECTING   // esp_wifi_connect() issued, waiting for GOT_IP
+};
+
+static WiFiLinkState wifiLinkState = WIFI_LINK_UP;
+static uint8_t wifiReconnectAttempt = 0;
+static bool wifiLinkLostPending = false;
+static bool wifiLinkRestoredPending = false;
+static esp_timer_handle_t wifiReconnectTimer = NULL;
+static portMUX_TYPE wifiLinkMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Exponential backoff with equal jitter: [cap/2, cap)
+static uint32_t wifiReconnectDelayMs(uint8_t attempt) {
+  uint32_t cap = WIFI_RECONNECT_BASE_MS << (attempt < 6 ? attempt : 6);
+  if (cap > WIFI_RECONNECT_MAX_MS) cap = WIFI_RECONNECT_MAX_MS;
+  return cap / 2 + esp_random() % (cap / 2);
+}
+
+static void wifiReconnectSchedule(uint32_t delayMs) {
+  esp_timer_stop(wifiReconnectTimer);  // Fails harmlessly if not running
+  esp_timer_start_once(wifiReconnectTimer, (uint64_t)delayMs * 1000ULL);
+}
+
+// esp_timer task: start the next attempt or give up on a stuck one
+static void wifiReconnectTimerCb(void* arg) {
+  if (wifiConfigMode) return;
+  
+  portENTER_CRITICAL(&wifiLinkMux);
+  WiFiLinkState state = wifiLinkState;
+  uint8_t attempt = wifiReconnectAttempt;
+  if (state == WIFI_LINK_BACKOFF) {
+    wifiLinkState = WIFI_LINK_CONNECTING;
+    if (wifiReconnectAttempt < 255) wifiReconnectAttempt++;
+  } else if (state == WIFI_LINK_CONNECTING) {
+    wifiLinkState = WIFI_LINK_BACKOFF;
+  }
+  portEXIT_CRITICAL(&wifiLinkMux);
+  
+  if (state == WIFI_LINK_BACKOFF) {
+    Serial.printf("WiFi reconnect attempt %u...\n", attempt + 1);
+    esp_wifi_connect();  // Result arrives as GOT_IP or STA_DISCONNECTED
+    wifiReconnectSchedule(WIFI_CONNECT_TIMEOUT_MS);
+  } else if (state == WIFI_LINK_CONNECTING) {
+    // Associated without an IP, or no event at all - abort and back off.
+    // The resulting STA_DISCONNECTED is ignored while in BACKOFF.
+    uint32_t delayMs = wifiReconnectDelayMs(attempt);
+    Serial.printf("⚠ WiFi reconnect attempt timed out - retry in %lu ms\n", (unsigned long)delayMs);
+    esp_wifi_disconnect();
+    wifiReconnectSchedule(delayMs);
+  }
+}
+
+// Arduino event task
+static void wifiLinkEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  if (wifiConfigMode) return;
+  
+  if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+    portENTER_CRITICAL(&wifiLinkMux);
+    WiFiLinkState state = wifiLinkState;
+    if (state != WIFI_LINK_BACKOFF) {
+      wifiLinkState = WIFI_LINK_BACKOFF;
+      if (state == WIFI_LINK_UP) {
+        wifiReconnectAttempt = 0;
+        wifiLinkLostPending = true;
+      }
+    }
+    uint8_t attempt = wifiReconnectAttempt;
+    portEXIT_CRITICAL(&wifiLinkMux);
+    
+    if (state == WIFI_LINK_BACKOFF) return;  // Already waiting for the timer
+    
+    uint32_t delayMs = wifiReconnectDelayMs(attempt);
+    if (state == WIFI_LINK_CONNECTING) {
+      Serial.printf("⚠ WiFi reconnect failed (reason %u) - retry in %lu ms\n",
+                    info.wifi_sta_disconnected.reason, (unsigned long)delayMs);
+    }
+    wifiReconnectSchedule(delayMs);
+  } else if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    esp_timer_stop(wifiReconnectTimer);
+    
+    portENTER_CRITICAL(&wifiLinkMux);
+    if (wifiLinkState != WIFI_LINK_UP) wifiLinkRestoredPending = true;
+    wifiLinkState = WIFI_LINK_UP;
+    wifiReconnectAttempt = 0;
+    portEXIT_CRITICAL(&wifiLinkMux);
+  }
+}
+
+// Take over reconnects from the WiFi library (call once after setupWiFi)
+void wifiReconnectBegin() {
+  if (wifiConfigMode || wifiReconnectTimer) return;
+  
+  esp_timer_create_args_t args = {};
+  args.callback = wifiReconnectTimerCb;
+  args.name = "wifi_reconnect";
+  if (esp_timer_create(&args, &wifiReconnectTimer) != ESP_OK) {
+    Serial.println("✗ Failed to create WiFi reconnect timer - using library auto-reconnect");
+    return;
+  }
+  
+  // The library would reconnect immediately and without backoff
+  WiFi.setAutoReconnect(false);
+  WiFi.onEvent(wifiLinkEvent);
+  
+  if (WiFi.status() != WL_CONNECTED) {
+    // Link dropped between setupWiFi() and now - no event will follow
+    portENTER_CRITICAL(&wifiLinkMux);
+    wifiLinkState = WIFI_LINK_BACKOFF;
+    wifiLinkLostPending = true;
+    portEXIT_CRITICAL(&wifiLinkMux);
+    wifiReconnectSchedule(wifiReconnectDelayMs(0));
+  }
+}
+
+// Continuations for the loop task - each returns true once per transition
+bool wifiTakeLinkLost() {
+  portENTER_CRITICAL(&wifiLinkMux);
+  bool pending = wifiLinkLostPending;
+  wifiLinkLostPending = false;
+  portEXIT_CRITICAL(&wifiLinkMux);
+  return pending;
+}
+
+bool wifiTakeLinkRestored() {
+  portENTER_CRITICAL(&wifiLinkMux);
+  bool pending = wifiLinkRestoredPending;
+  wifiLinkRestoredPending = false;
+  portEXIT_CRITICAL(&wifiLinkMux);
+  return pending;
+}
+
+#endif // WIFI_SETUP_H
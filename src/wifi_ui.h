@@ -451,10 +451,9 @@ static void wifi_connect_btn_event_cb(lv_event_t *e) {
     // Show spinner
     if (wifi_spinner) lv_obj_clear_flag(wifi_spinner, LV_OBJ_FLAG_HIDDEN);
     
-    // Schedule restart after short delay to let UI update
+    // Restart from the main loop after a short delay to let UI update
     // This avoids the flash cache conflict
-    delay(500);
-    ESP.restart();
+    scheduleRestart(500);
   }
 }
 
@@ -896,8 +895,11 @@ void showWiFiScreen() {
   
   // Auto-start network scan only in edit mode
   if (wifi_edit_mode) {
-    delay(500);  // Wait for screen transition
-    wifi_do_scan();
+    // Wait for the screen transition without blocking the LVGL task
+    lv_timer_t *timer = lv_timer_create([](lv_timer_t *t) {
+      if (wifi_screen && lv_scr_act() == wifi_screen && !wifi_scanning) wifi_do_scan();
+    }, 500, NULL);
+    lv_timer_set_repeat_count(timer, 1);
   }
 }
 
@@ -0,0 +1,528 @@
+"""
+Latency benchmarks: local stand-in server + driver for /api/bench
+The controller is the client - this script serves the stand-in on the LAN,
+starts the benchmark on the device and prints the per-series latencies.
+
+  python test/bench/bench.py https --device 192.168.1.50
+  python test/bench/bench.py tasmota --device 192.168.1.50
+  sudo python test/bench/bench.py scan --device 192.168.1.50 --members 192.168.1.60,192.168.1.61,192.168.1.62
+  python test/bench/bench.py mqtt --device 192.168.1.50 --broker 192.168.1.10
+  sudo python test/bench/bench.py group --device 192.168.1.50 --members 192.168.1.60,192.168.1.61
+  sudo python test/bench/bench.py events --device 192.168.1.50 --members 192.168.1.60,192.168.1.61
+
+https: TLS stand-in (self-signed, HTTP/1.1 keep-alive) for the cloud APIs.
+       Compares a new TLS connection per request, a resumed TLS session
+       and a pooled keep-alive connection (HttpsLease).
+tasmota: fake Tasmota plug (plain HTTP keep-alive, default port 8080).
+       Compares a new TCP connection per command with the plug connection
+       cache (TasmotaConnLease) and prints its reuse ratio.
+scan:  fake Tasmota plugs on port 80 of --members (local addresses,
+       default this host; needs root or CAP_NET_BIND_SERVICE), the last
+       --black-holes of them hung: they accept the connection and never
+       answer. Then one Tasmota network scan per sweep window / connect
+       timeout: every fake plug must be found, no hung one listed, and
+       the scan must end within the worst case of its windows (every
+       sweep slot waiting its connect timeout, every probe slot its
+       Status timeout). Prints sweep and probe time against that bound.
+mqtt:  scripted fake Tasmota plugs (fake_tasmota.py) on an MQTT broker,
+       e.g. a local Mosquitto. The Tasmota settings of the controller are
+       replaced by the fake plugs for the run and restored afterwards.
+       Runs feeding start/stop through /api/feeding and checks that every
+       plug got its command over MQTT and that its pushed state reached
+       /api/tasmota-status. Use a test controller: Red Sea and Tunze are
+       switched as well if enabled.
+group: Tasmota device group members (fake_tasmota.py) on UDP multicast,
+       each with a fake plug on port 80 of its own address (--members,
+       local addresses of this machine; needs root). Feeding start/stop
+       must switch all of them with the group packet. Then the last member
+       is dropped from the device list: the group must not be used any
+       more, the others are switched over HTTP and the dropped member
+       must stay untouched. Settings are restored afterwards.
+events: fake plugs (fake_tasmota.py) that fire the Rule3 WebQuery to
+       /api/tasmota-event from their own address (--members, default this
+       host), each with a fake plug on port 80 answering the polls (needs
+       root). Every ON/OFF event must be accepted and reach
+       /api/tasmota-status within --event-ms. Malformed power values must
+       get HTTP 400 and leave the state alone, a sender outside the
+       device list HTTP 403. Settings are restored afterwards.
+
+https and tasmota need a bench build of the firmware: /api/bench only
+exists with -D NET_BENCH (pio run -e esp32s3_bench -t upload).
+
+Requires Python 3.8+ and the openssl command line tool (https only).
+"""
+import argparse
+import json
+import math
+import os
+import shutil
+import socket
+import ssl
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import urllib.parse
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+from fake_tasmota import FakeGroupMember, FakeHungPlug, FakeMqttPlug, FakeRulePlug
+
+SCAN_WINDOW = 4          # TASMOTA_SCAN_WINDOW in tasmota_api.h
+SCAN_TIMEOUT_MS = 3500   # TASMOTA_SCAN_TIMEOUT_MS
+
+BODY = json.dumps({"success": True, "payload": "x" * 512}).encode()
+
+class KeepAliveHandler(BaseHTTPRequestHandler):
+    """Answers every GET with a small JSON body on a keep-alive connection"""
+    protocol_version = "HTTP/1.1"
+    delay_ms = 0
+    connections = 0
+    requests = 0
+
+    def setup(self):
+        super().setup()
+        # Headers and body are separate writes - no Nagle stall in between
+        self.connection.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        type(self).connections += 1
+
+    def do_GET(self):
+        type(self).requests += 1
+        if self.delay_ms:
+            time.sleep(self.delay_ms / 1000)
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(BODY)))
+        self.end_headers()
+        self.wfile.write(BODY)
+
+    def log_message(self, format, *args):
+        pass
+
+class FakeTasmotaHandler(KeepAliveHandler):
+    """Answers /cm?cmnd=... like a Tasmota plug (Status, Power, Backlog0).
+    switched holds (time, power) of every Power ON/OFF received"""
+    power = "OFF"
+    switched = []
+
+    def run_command(self, cmnd):
+        word, _, arg = cmnd.strip().partition(" ")
+        if word.lower() == "status":
+            return {"Status": {"DeviceName": "Bench Plug", "FriendlyName": ["Bench Plug"],
+                               "Topic": "bench_plug", "Power": 1 if self.power == "ON" else 0},
+                    "StatusNET": {"Hostname": "bench-plug"}}
+        if word.lower().startswith("power"):
+            if arg.upper() in ("ON", "OFF"):
+                type(self).power = arg.upper()
+                type(self).switched.append((time.time(), self.power))
+            return {"POWER": self.power}
+        return {word or "Command": "Done"}
+
+    def do_GET(self):
+        type(self).requests += 1
+        if self.delay_ms:
+            time.sleep(self.delay_ms / 1000)
+        query = urllib.parse.parse_qs(urllib.parse.urlparse(self.path).query)
+        cmnd = query.get("cmnd", [""])[0].strip()
+        word, _, rest = cmnd.partition(" ")
+        if word.lower() in ("backlog", "backlog0"):
+            body = {}  # Merged results, like Backlog0 over HTTP
+            for part in rest.split(";"):
+                body.update(self.run_command(part))
+        else:
+            body = self.run_command(cmnd)
+        data = json.dumps(body).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+def local_ip_for(device):
+    """Address of the interface that reaches the device"""
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    try:
+        s.connect((device, 80))
+        return s.getsockname()[0]
+    finally:
+        s.close()
+
+def make_tls_context(workdir):
+    """Self-signed certificate for the stand-in (the device runs insecure)"""
+    if not shutil.which("openssl"):
+        sys.exit("openssl not found - needed to create the stand-in certificate")
+    cert = os.path.join(workdir, "cert.pem")
+    key = os.path.join(workdir, "key.pem")
+    subprocess.run(["openssl", "req", "-x509", "-newkey", "rsa:2048", "-nodes",
+                    "-keyout", key, "-out", cert, "-days", "1", "-subj", "/CN=bench"],
+                   check=True, capture_output=True)
+    ctx = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    ctx.load_cert_chain(cert, key)
+    return ctx
+
+def start_server(port, tls_ctx=None, handler=KeepAliveHandler, bind="0.0.0.0"):
+    server = ThreadingHTTPServer((bind, port), handler)
+    server.daemon_threads = True
+    if tls_ctx:
+        server.socket = tls_ctx.wrap_socket(server.socket, server_side=True)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    return server
+
+def device_request(device, method, path, body=None):
+    data = json.dumps(body).encode() if body is not None else None
+    req = urllib.request.Request(f"http://{device}{path}", data=data, method=method,
+                                 headers={"Content-Type": "application/json"} if data else {})
+    try:
+        with urllib.request.urlopen(req, timeout=10) as resp:
+            return resp.status, json.loads(resp.read() or b"{}")
+    except urllib.error.HTTPError as e:
+        return e.code, json.loads(e.read() or b"{}")
+
+def run_benchmark(args, kind, host, port):
+    status, _ = device_request(args.device, "POST",
+                               f"/api/bench?kind={kind}&host={host}&port={port}&n={args.count}")
+    if status == 404:
+        sys.exit("No /api/bench on the device - flash the bench build (pio run -e esp32s3_bench -t upload)")
+    if status != 202:
+        sys.exit(f"Device refused the benchmark (HTTP {status}) - already running?")
+
+    deadline = time.time() + args.timeout
+    while time.time() < deadline:
+        time.sleep(1)
+        _, result = device_request(args.device, "GET", "/api/bench")
+        if not result.get("running") and result.get("kind") == kind:
+            return result
+    sys.exit("Timed out waiting for the benchmark result")
+
+def print_result(result, series, handler=KeepAliveHandler):
+    print(f"\n{'series':10s} {'ok':>4s} {'fail':>5s} {'avg ms':>8s} {'min ms':>7s} {'max ms':>7s}")
+    for name in series:
+        s = result.get(name, {})
+        print(f"{name:10s} {s.get('ok', 0):4d} {s.get('failed', 0):5d} "
+              f"{s.get('avg_ms', 0):8.1f} {s.get('min_ms', 0):7d} {s.get('max_ms', 0):7d}")
+    for key in ("pool_reuse_ratio", "reuse_ratio", "speedup"):
+        if key in result:
+            print(f"{key}: {result[key]:.2f}")
+    if "reuses" in result:
+        print(f"warm: {result['reuses']} reused, {result['misses']} new connection(s)")
+    print(f"stand-in: {handler.connections} connections, {handler.requests} requests")
+
+def scan_bound_ms(window, connect_ms, responders):
+    """Longest a scan may take: every sweep slot waits out its connect timeout,
+    every probe slot its Status timeout (plus 25 % and 1 s for scheduling)"""
+    sweep = math.ceil(253 / window) * connect_ms
+    probe = math.ceil(responders / SCAN_WINDOW) * SCAN_TIMEOUT_MS
+    return int((sweep + probe) * 1.25) + 1000
+
+def run_scans(args, host):
+    """One Tasmota scan per window / connect timeout combination"""
+    addresses = args.members or [host]
+    black_holes = args.black_holes if args.black_holes is not None else len(addresses) // 3
+    if black_holes > len(addresses):
+        sys.exit(f"--black-holes {black_holes} is more than the {len(addresses)} address(es)")
+    live, hung = addresses[:len(addresses) - black_holes], addresses[len(addresses) - black_holes:]
+    for i, ip in enumerate(live):
+        handler = type(f"ScanPlug{i}", (FakeTasmotaHandler,), {"switched": []})
+        try:
+            start_server(80, handler=handler, bind=ip)
+        except OSError as e:
+            if args.members:
+                sys.exit(f"Cannot serve the fake plug on {ip}:80 ({e}) - run as root")
+            print(f"No fake plug ({e}) - measuring the sweep of an empty network")
+            live = []
+    for ip in hung:
+        try:
+            FakeHungPlug(ip)
+        except OSError as e:
+            sys.exit(f"Cannot serve the hung plug on {ip}:80 ({e}) - run as root")
+    print(f"{len(live)} fake plug(s), {len(hung)} hung plug(s) on port 80")
+
+    failures = 0
+    print(f"\n{'window':>6s} {'conn ms':>7s} {'sweep ms':>8s} {'probe ms':>8s} "
+          f"{'total ms':>8s} {'bound':>6s} {'accept':>6s} {'found':>5s} {'fakes':>5s} {'hung':>4s}")
+    for window in args.windows:
+        for connect_ms in args.connect_ms:
+            _, started = device_request(args.device, "GET",
+                                        f"/api/tasmota-scan?window={window}&connect_ms={connect_ms}")
+            if not started.get("success"):
+                sys.exit(f"Device refused the scan: {started.get('message')}")
+            deadline = time.time() + args.timeout
+            while True:
+                if time.time() > deadline:
+                    sys.exit("Timed out waiting for the scan result")
+                time.sleep(1)
+                _, result = device_request(args.device, "GET", "/api/tasmota-scan-results")
+                if not result.get("scanning") and "timing" in result:
+                    break
+            t = result["timing"]
+            found = {d.get("ip") for d in result.get("devices", [])}
+            window = t.get("sweep_window", window)
+            connect_ms = t.get("sweep_connect_ms", connect_ms)
+            responders = result.get("responders", 0)
+            bound = scan_bound_ms(window, connect_ms, responders)
+            fakes = sum(ip in found for ip in live)
+            listed = sum(ip in found for ip in hung)
+            # Every fake plug found, no hung one listed, no slot stuck past its timeout
+            ok = fakes == len(live) and listed == 0 and t["total_ms"] <= bound
+            failures += 0 if ok else 1
+            print(f"{window:6d} {connect_ms:7d} {t['sweep_ms']:8d} {t['probe_ms']:8d} "
+                  f"{t['total_ms']:8d} {bound:6d} {responders:6d} {result.get('count', 0):5d} "
+                  f"{fakes:2d}/{len(live):<2d} {listed:4d}  {'ok' if ok else 'FAILED'}")
+
+    if failures:
+        sys.exit(f"\n{failures} scan(s) failed")
+    print("\nOK - every fake plug found, hung plugs skipped within the time bound")
+
+def wait_for(predicate, timeout, what):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        value = predicate()
+        if value:
+            return value
+        time.sleep(0.2)
+    sys.exit(f"Timed out waiting for {what}")
+
+def run_feeding_job(args, command):
+    """POST /api/feeding/<command>, wait for the job - (start time, job)"""
+    started = time.time()
+    status, reply = device_request(args.device, "POST", f"/api/feeding/{command}")
+    if status != 202:
+        sys.exit(f"Device refused feeding {command} (HTTP {status})")
+    job = wait_for(lambda: (lambda r: r if r.get("state") == "done" else None)(
+        device_request(args.device, "GET", f"/api/feeding/job/{reply['job']}")[1]),
+        args.timeout, f"feeding {command}")
+    return started, job
+
+def run_mqtt(args):
+    """Feeding start/stop against fake plugs on the broker"""
+    broker, _, port = args.broker.partition(":")
+    port = int(port or 1883)
+    plugs = [FakeMqttPlug(broker, port, f"bench_plug_{i}") for i in range(args.plugs)]
+    print(f"{len(plugs)} fake plugs on {broker}:{port}")
+
+    _, saved = device_request(args.device, "GET", "/api/tasmota-settings")
+    settings = dict(saved, enabled=True, mqttHost=broker, mqttPort=port, mqttUser="",
+                    mqttPass="", groupName="",
+                    devices=[{"ip": f"192.0.2.{i + 1}", "name": p.topic, "topic": p.topic,
+                              "enabled": True, "turnOn": False} for i, p in enumerate(plugs)])
+    try:
+        device_request(args.device, "POST", "/api/tasmota-settings", settings)
+        wait_for(lambda: device_request(args.device, "GET", "/api/tasmota-settings")[1]
+                 .get("mqttConnected"), 30, "the controller to connect to the broker")
+
+        failures = 0
+        print(f"\n{'round':>5s} {'cmd':>5s} {'job ms':>7s} {'tasmota':>8s} "
+              f"{'first ms':>8s} {'last ms':>8s} {'pushed':>6s}")
+        for round_no in range(1, args.count + 1):
+            for command, power in (("start", "OFF"), ("stop", "ON")):
+                started, job = run_feeding_job(args, command)
+                arrivals = [p.first_command("Power", started) for p in plugs]
+                got = [a for a in arrivals if a is not None]
+                # Pushed states: every plug in the expected state on the status page
+                pushed = wait_for(lambda: (lambda d: d if all(
+                    x.get("powerState") == (power == "ON") for x in d) else None)(
+                    device_request(args.device, "GET", "/api/tasmota-status")[1].get("devices", [])),
+                    5, f"pushed {power} states") if len(got) == len(plugs) else []
+                ok = len(got) == len(plugs) and len(pushed) == len(plugs)
+                failures += 0 if ok else 1
+                tasmota = job["backends"]["tasmota"]
+                print(f"{round_no:5d} {command:>5s} {job.get('elapsed_ms', 0):7d} "
+                      f"{tasmota['state']:>8s} "
+                      f"{(min(got) - started) * 1000 if got else -1:8.0f} "
+                      f"{(max(got) - started) * 1000 if got else -1:8.0f} "
+                      f"{len(pushed):3d}/{len(plugs):<2d}")
+        print("\nOK - every plug switched over MQTT" if failures == 0
+              else f"\n{failures} round(s) with missing commands or states")
+    finally:
+        device_request(args.device, "POST", "/api/tasmota-settings", saved)
+        print("Tasmota settings restored")
+
+def switch_path(member, plug, since):
+    """How a group member was switched after since: group, http or -"""
+    if member.first_switch(since) is not None:
+        return "group"
+    if any(at >= since for at, _ in list(plug.switched)):
+        return "http"
+    return "-"
+
+def run_group(args, host):
+    """Feeding start/stop through the device group fast path and without it"""
+    members, plugs = [], []
+    for i, ip in enumerate(args.members or [host]):
+        plug = type(f"GroupPlug{i}", (FakeTasmotaHandler,), {"power": "ON", "switched": []})
+        start_server(80, handler=plug, bind=ip)
+        members.append(FakeGroupMember(args.group, ip, args.device))
+        plugs.append(plug)
+    print(f"{len(members)} fake member(s) of device group '{args.group}'")
+
+    _, saved = device_request(args.device, "GET", "/api/tasmota-settings")
+    devices = [{"ip": m.ip, "name": f"bench_member_{i}", "topic": "", "enabled": True,
+                "turnOn": False} for i, m in enumerate(members)]
+    phases = [("group", devices, ["group"] * len(members))]
+    if len(members) > 1:
+        # A learned member outside the device list - the group packet would switch it too
+        phases.append(("stray", devices[:-1], ["http"] * (len(members) - 1) + ["-"]))
+
+    failures = 0
+    try:
+        for phase, phase_devices, expected in phases:
+            device_request(args.device, "POST", "/api/tasmota-settings",
+                           dict(saved, enabled=True, groupName=args.group, devices=phase_devices))
+            wait_for(lambda: device_request(args.device, "GET", "/api/tasmota-settings")[1]
+                     .get("groupMembers", 0) >= len(members), 30, "the group members to be learned")
+
+            print(f"\n{phase}: expecting {', '.join(expected)}")
+            for round_no in range(1, args.count + 1):
+                for command in ("start", "stop"):
+                    started, job = run_feeding_job(args, command)
+                    paths = [switch_path(m, p, started) for m, p in zip(members, plugs)]
+                    ok = paths == expected
+                    failures += 0 if ok else 1
+                    print(f"{round_no:5d} {command:>5s} {job.get('elapsed_ms', 0):6d} ms  "
+                          f"{' '.join(f'{p:>5s}' for p in paths)}  {'ok' if ok else 'UNEXPECTED'}")
+        print("\nOK - group fast path used only when it covers every member" if failures == 0
+              else f"\n{failures} round(s) switched unexpectedly")
+    finally:
+        device_request(args.device, "POST", "/api/tasmota-settings", saved)
+        print("Tasmota settings restored")
+
+def device_power(args, ip):
+    """powerState of ip on /api/tasmota-status, None if not listed"""
+    devices = device_request(args.device, "GET", "/api/tasmota-status")[1].get("devices", [])
+    return next((d.get("powerState") for d in devices if d.get("ip") == ip), None)
+
+def run_events(args, host):
+    """Rule3 WebQuery events against /api/tasmota-event"""
+    plugs, handlers = [], []
+    for i, ip in enumerate(args.members or [host]):
+        handler = type(f"EventPlug{i}", (FakeTasmotaHandler,), {"power": "OFF", "switched": []})
+        try:
+            start_server(80, handler=handler, bind=ip)
+        except OSError as e:
+            sys.exit(f"Cannot serve the fake plug on {ip}:80 ({e}) - run as root")
+        plugs.append(FakeRulePlug(ip, args.device))
+        handlers.append(handler)
+    print(f"{len(plugs)} fake plug(s) firing Rule3 events")
+
+    _, saved = device_request(args.device, "GET", "/api/tasmota-settings")
+    devices = [{"ip": p.ip, "name": f"bench_event_{i}", "topic": "", "enabled": True,
+                "turnOn": False} for i, p in enumerate(plugs)]
+    failures = 0
+
+    def check(what, ok):
+        nonlocal failures
+        failures += 0 if ok else 1
+        print(f"  {what:44s} {'ok' if ok else 'FAILED'}")
+
+    try:
+        device_request(args.device, "POST", "/api/tasmota-settings",
+                       dict(saved, enabled=True, groupName="", devices=devices))
+        wait_for(lambda: all(device_power(args, p.ip) is False for p in plugs), 30,
+                 "the fake plugs to be polled OFF")
+
+        print(f"\n{'round':>5s} {'plug':>15s} {'power':>5s} {'http':>4s} {'state ms':>8s}")
+        for round_no in range(1, args.count + 1):
+            for plug, handler in zip(plugs, handlers):
+                for power in ("ON", "OFF"):
+                    handler.power = power  # Switched locally (button, PulseTime)
+                    sent = time.time()
+                    status, _ = plug.power_changed(power)
+                    seen = None
+                    while time.time() - sent < args.event_ms / 1000:
+                        if device_power(args, plug.ip) is (power == "ON"):
+                            seen = (time.time() - sent) * 1000
+                            break
+                        time.sleep(0.02)
+                    ok = status == 200 and seen is not None
+                    failures += 0 if ok else 1
+                    print(f"{round_no:5d} {plug.ip:>15s} {power:>5s} {status:4d} "
+                          f"{seen if seen is not None else -1:8.0f}  {'ok' if ok else 'FAILED'}")
+
+        plug = plugs[0]
+        print("\nRejected events:")
+        for query in ("power=2", "power=banana", "power=", "state=ON", ""):
+            status, _ = plug.webquery(query)
+            check(f"'{query}' -> HTTP {status}", status == 400)
+        time.sleep(args.event_ms / 1000)
+        check("state unchanged after malformed events", device_power(args, plug.ip) is False)
+
+        device_request(args.device, "POST", "/api/tasmota-settings",
+                       dict(saved, enabled=True, groupName="",
+                            devices=[dict(devices[0], ip="192.0.2.1")]))
+        status, _ = plug.power_changed("ON")
+        check(f"unknown sender {plug.ip} -> HTTP {status}", status == 403)
+
+        print("\nOK - events accepted, malformed and unknown ones rejected" if failures == 0
+              else f"\n{failures} check(s) failed")
+    finally:
+        device_request(args.device, "POST", "/api/tasmota-settings", saved)
+        print("Tasmota settings restored")
+
+def ip_list(text):
+    return [ip.strip() for ip in text.split(",") if ip.strip()]
+
+def int_list(text):
+    return [int(v) for v in text.split(",")]
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("kind", choices=["https", "tasmota", "scan", "mqtt", "group", "events"])
+    parser.add_argument("--device", required=True, help="IP address of the controller")
+    parser.add_argument("--port", type=int,
+                        help="stand-in server port (default 8443 https, 8080 tasmota)")
+    parser.add_argument("-n", "--count", type=int, default=20, help="requests per series")
+    parser.add_argument("--delay-ms", type=int, default=0, help="server think time per request")
+    parser.add_argument("--timeout", type=int, default=300, help="seconds to wait for the result")
+    parser.add_argument("--windows", type=int_list, default=[4, 10],
+                        help="scan: sweep windows to compare (comma separated)")
+    parser.add_argument("--connect-ms", type=int_list, default=[400, 1500],
+                        help="scan: sweep connect timeouts to compare (comma separated)")
+    parser.add_argument("--broker", help="mqtt: broker host[:port] reachable by the controller")
+    parser.add_argument("--plugs", type=int, default=4, help="mqtt: number of fake plugs")
+    parser.add_argument("--members", type=ip_list,
+                        help="group/events/scan: local addresses of the fake plugs (default: this host)")
+    parser.add_argument("--black-holes", type=int,
+                        help="scan: how many of --members hang (default: a third)")
+    parser.add_argument("--group", default="bench_dgr", help="group: device group name")
+    parser.add_argument("--event-ms", type=int, default=1000,
+                        help="events: time for an event to reach /api/tasmota-status")
+    args = parser.parse_args()
+
+    KeepAliveHandler.delay_ms = args.delay_ms
+    host = local_ip_for(args.device)
+
+    if args.kind == "scan":
+        run_scans(args, host)
+        return
+    if args.kind == "mqtt":
+        if not args.broker:
+            sys.exit("mqtt needs --broker")
+        run_mqtt(args)
+        return
+    if args.kind == "group":
+        run_group(args, host)
+        return
+    if args.kind == "events":
+        run_events(args, host)
+        return
+
+    if args.kind == "tasmota":
+        port = args.port or 8080
+        FakeTasmotaHandler.connections = FakeTasmotaHandler.requests = 0
+        start_server(port, handler=FakeTasmotaHandler)
+        print(f"Fake Tasmota plug on {host}:{port}, {args.count} requests per series")
+        result = run_benchmark(args, "tasmota", host, port)
+        print_result(result, ("cold", "warm"), FakeTasmotaHandler)
+        return
+
+    port = args.port or 8443
+    with tempfile.TemporaryDirectory() as workdir:
+        start_server(port, make_tls_context(workdir))
+        print(f"TLS stand-in on {host}:{port}, {args.count} requests per series")
+        result = run_benchmark(args, "https", host, port)
+        print_result(result, ("cold", "resumed", "pooled"))
+
+if __name__ == "__main__":
+    main()
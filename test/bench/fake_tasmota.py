@@ -0,0 +1,298 @@
+"""
+Scripted fake Tasmota plugs for the bench driver (bench.py)
+
+FakeMqttPlug talks to an MQTT broker (e.g. a local Mosquitto) the way a
+Tasmota plug with the default FullTopic does: it subscribes to
+cmnd/<topic>/+ and cmnd/tasmotas/+, answers on stat/<topic>/RESULT,
+stat/<topic>/POWER and stat/<topic>/STATUS and keeps a retained
+tele/<topic>/LWT. Every command is recorded with its arrival time.
+
+MiniMqtt is just enough MQTT 3.1.1 for that (QoS 0, no TLS), so the
+bench needs nothing outside the Python standard library.
+
+FakeGroupMember is one member of a Tasmota device group (UDP multicast
+239.255.250.250:4447) on a local address: it answers status requests
+with its power state, applies power updates and acknowledges them by
+unicast, like the firmware's tasmota_group.h expects. Several members on
+one PC need one address each (e.g. secondary addresses on the interface).
+
+FakeRulePlug sends the WebQuery of the completion rule the controller
+arms on each plug (Rule3 ON Power1#State DO WebQuery
+http://<controller>/api/tasmota-event?power=%value% GET ENDON) from its
+own local address - the controller identifies the plug by the sender.
+
+FakeHungPlug accepts TCP connections on port 80 of a local address and
+never answers: a plug whose web server hangs (black hole for the scan).
+"""
+import http.client
+import json
+import socket
+import struct
+import threading
+import time
+
+MQTT_GROUP_TOPIC = "tasmotas"  # Tasmota default group topic
+
+DGR_ADDR = "239.255.250.250"
+DGR_PORT = 4447
+DGR_HEADER = b"TASMOTA_DGR"
+DGR_FLAG_STATUS_REQUEST = 2
+DGR_FLAG_FULL_STATUS = 4
+DGR_FLAG_ACK = 8
+DGR_ITEM_POWER = 128
+
+class MiniMqtt:
+    """Minimal MQTT 3.1.1 client: connect, subscribe, QoS 0 publish"""
+    KEEPALIVE = 60
+
+    def __init__(self, host, port, client_id, will=None):
+        self.lock = threading.Lock()
+        self.sock = socket.create_connection((host, port), timeout=10)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+        flags = 0x02  # Clean session
+        payload = self._str(client_id)
+        if will:
+            topic, message = will
+            flags |= 0x04 | 0x20  # Will, retained
+            payload += self._str(topic) + self._str(message)
+        self._send(0x10, self._str("MQTT") + bytes([4, flags]) +
+                   struct.pack("!H", self.KEEPALIVE) + payload)
+        packet, body = self._read()
+        if packet != 0x20 or len(body) < 2 or body[1] != 0:
+            raise ConnectionError(f"MQTT connect refused ({body[1] if len(body) > 1 else '?'})")
+        self.sock.settimeout(None)
+        threading.Thread(target=self._keepalive, daemon=True).start()
+
+    @staticmethod
+    def _str(text):
+        data = text.encode()
+        return struct.pack("!H", len(data)) + data
+
+    def _send(self, header, body):
+        length = len(body)
+        encoded = bytearray()
+        while True:
+            byte, length = length % 128, length // 128
+            encoded.append(byte | (0x80 if length else 0))
+            if not length:
+                break
+        with self.lock:
+            self.sock.sendall(bytes([header]) + bytes(encoded) + body)
+
+    def _recv_exact(self, n):
+        data = b""
+        while len(data) < n:
+            chunk = self.sock.recv(n - len(data))
+            if not chunk:
+                raise ConnectionError("MQTT connection closed")
+            data += chunk
+        return data
+
+    def _read(self):
+        header = self._recv_exact(1)[0]
+        length, shift = 0, 0
+        while True:
+            byte = self._recv_exact(1)[0]
+            length |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        return header & 0xF0, self._recv_exact(length)
+
+    def _keepalive(self):
+        while True:
+            time.sleep(self.KEEPALIVE / 2)
+            try:
+                self._send(0xC0, b"")  # PINGREQ
+            except OSError:
+                return
+
+    def subscribe(self, topics):
+        body = struct.pack("!H", 1) + b"".join(self._str(t) + b"\x00" for t in topics)
+        self._send(0x82, body)
+
+    def publish(self, topic, payload, retain=False):
+        self._send(0x30 | (0x01 if retain else 0), self._str(topic) + payload.encode())
+
+    def messages(self):
+        """(topic, payload) of every PUBLISH until the connection closes"""
+        while True:
+            packet, body = self._read()
+            if packet != 0x30:
+                continue  # SUBACK, PINGRESP
+            n = struct.unpack("!H", body[:2])[0]
+            yield body[2:2 + n].decode(), body[2 + n:].decode()
+
+class FakeMqttPlug:
+    """One Tasmota plug on the broker; commands holds (time, command, payload)"""
+
+    def __init__(self, broker, port, topic, power="ON"):
+        self.topic = topic
+        self.power = power
+        self.commands = []
+        self.client = MiniMqtt(broker, port, f"bench-{topic}",
+                               will=(f"tele/{topic}/LWT", "Offline"))
+        self.client.subscribe([f"cmnd/{topic}/+", f"cmnd/{MQTT_GROUP_TOPIC}/+"])
+        self.client.publish(f"tele/{topic}/LWT", "Online", retain=True)
+        threading.Thread(target=self._run, daemon=True).start()
+
+    def first_command(self, prefix, since):
+        """Arrival time of the first command starting with prefix after since"""
+        for at, command, payload in list(self.commands):
+            if at >= since and f"{command} {payload}".lower().startswith(prefix.lower()):
+                return at
+        return None
+
+    def _execute(self, command, arg):
+        """Apply one command, publish its RESULT (and POWER)"""
+        name = command.lower()
+        stat = f"stat/{self.topic}"
+        if name in ("power", "power1"):
+            value = arg.strip().upper()
+            if value in ("ON", "1"):
+                self.power = "ON"
+            elif value in ("OFF", "0"):
+                self.power = "OFF"
+            elif value in ("TOGGLE", "2"):
+                self.power = "OFF" if self.power == "ON" else "ON"
+            self.client.publish(f"{stat}/RESULT", json.dumps({"POWER": self.power}))
+            self.client.publish(f"{stat}/POWER", self.power)
+        elif name == "status":
+            status = {"Status": {"DeviceName": self.topic, "FriendlyName": [self.topic],
+                                 "Topic": self.topic, "Power": 1 if self.power == "ON" else 0}}
+            self.client.publish(f"{stat}/STATUS", json.dumps(status))
+        else:
+            self.client.publish(f"{stat}/RESULT", json.dumps({command: arg or "Done"}))
+
+    def _run(self):
+        for topic, payload in self.client.messages():
+            command = topic.rsplit("/", 1)[-1]
+            self.commands.append((time.time(), command, payload))
+            if command.lower() == "backlog":
+                for part in payload.split(";"):
+                    name, _, arg = part.strip().partition(" ")
+                    if name:
+                        self._execute(name, arg)
+            else:
+                self._execute(command, payload)
+
+class FakeGroupMember:
+    """One device group member on address ip; switched holds (time, power)"""
+
+    def __init__(self, group, ip, controller, power="ON"):
+        self.group = group
+        self.ip = ip
+        self.controller = controller
+        self.power = power
+        self.switched = []
+        self.sequence = 1
+        self.last_sequence = None
+
+        self.rx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.rx.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.rx.bind(("", DGR_PORT))
+        self.rx.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP,
+                           socket.inet_aton(DGR_ADDR) + socket.inet_aton(ip))
+
+        self.tx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.tx.bind((ip, 0))
+        self.tx.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_IF, socket.inet_aton(ip))
+        threading.Thread(target=self._run, daemon=True).start()
+
+    def first_switch(self, since):
+        """Time of the first group power update after since"""
+        for at, _ in list(self.switched):
+            if at >= since:
+                return at
+        return None
+
+    def _packet(self, sequence, flags, power=None):
+        data = DGR_HEADER + self.group.encode() + b"\0" + struct.pack("<HH", sequence, flags)
+        if power is not None:
+            relays = (1 if power == "ON" else 0) | (1 << 24)
+            data += bytes([DGR_ITEM_POWER]) + struct.pack("<I", relays)
+        return data + b"\0"
+
+    def _parse(self, data):
+        """(sequence, flags, power or None) of a packet for this group, else None"""
+        name = DGR_HEADER + self.group.encode() + b"\0"
+        if not data.startswith(name) or len(data) < len(name) + 4:
+            return None
+        sequence, flags = struct.unpack_from("<HH", data, len(name))
+        pos, power = len(name) + 4, None
+        while pos < len(data):
+            item = data[pos]
+            pos += 1
+            if item == 0 or item > 191:
+                break
+            size = 1 if item <= 63 else 2 if item <= 127 else 4
+            if item == DGR_ITEM_POWER and pos + size <= len(data):
+                power = "ON" if data[pos] & 1 else "OFF"
+            pos += size
+        return sequence, flags, power
+
+    def _run(self):
+        while True:
+            data, (sender, _) = self.rx.recvfrom(512)
+            if sender != self.controller:
+                continue  # Other members
+            packet = self._parse(data)
+            if not packet:
+                continue
+            sequence, flags, power = packet
+            if flags & DGR_FLAG_STATUS_REQUEST:
+                self.sequence += 1
+                self.tx.sendto(self._packet(self.sequence, DGR_FLAG_FULL_STATUS, self.power),
+                               (DGR_ADDR, DGR_PORT))
+                continue
+            if power is None:
+                continue
+            # The controller repeats each message - apply once, acknowledge every copy
+            if sequence != self.last_sequence:
+                self.last_sequence = sequence
+                self.power = power
+                self.switched.append((time.time(), power))
+            self.tx.sendto(self._packet(sequence, DGR_FLAG_ACK), (self.controller, DGR_PORT))
+
+class FakeRulePlug:
+    """Rule3 WebQuery events of one plug on local address ip"""
+
+    def __init__(self, ip, controller, port=80):
+        self.ip = ip
+        self.controller = controller
+        self.port = port
+
+    def webquery(self, query):
+        """GET /api/tasmota-event?<query> from the plug address - (status, body)"""
+        conn = http.client.HTTPConnection(self.controller, self.port, timeout=5,
+                                          source_address=(self.ip, 0))
+        try:
+            conn.request("GET", f"/api/tasmota-event?{query}")
+            resp = conn.getresponse()
+            data = resp.read()
+            try:
+                body = json.loads(data or b"{}")
+            except ValueError:
+                body = {}
+            return resp.status, body
+        finally:
+            conn.close()
+
+    def power_changed(self, power):
+        """Power1#State fired - %value% is 1 or 0"""
+        return self.webquery(f"power={1 if power == 'ON' else 0}")
+
+class FakeHungPlug:
+    """Accepts connections on ip:port and never answers; connections are held open"""
+
+    def __init__(self, ip, port=80):
+        self.ip = ip
+        self.connections = []
+        self.server = socket.create_server((ip, port), backlog=32)
+        threading.Thread(target=self._run, daemon=True).start()
+
+    def _run(self):
+        while True:
+            conn, _ = self.server.accept()
+            self.connections.append(conn)  # Never read, never closed
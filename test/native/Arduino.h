@@ -0,0 +1,49 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal host stand-in for the Arduino core (native tests only)
+ *
+ * Provides just what the firmware headers under test use: millis(),
+ * delay(), BIT() and a printf-style Serial that writes to stdout.
+ */
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+#ifndef BIT
+#define BIT(n) (1UL << (n))
+#endif
+
+inline unsigned long millis() {
+  static const auto start = std::chrono::steady_clock::now();
+  return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+inline void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+struct NativeSerial {
+  int printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n;
+  }
+  void print(const char* s) { fputs(s, stdout); }
+  void print(long v) { ::printf("%ld", v); }
+  void println(const char* s = "") { puts(s); }
+  void println(long v) { ::printf("%ld\n", v); }
+};
+
+inline NativeSerial Serial;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,206 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stand-in for the FreeRTOS primitives used by the firmware
+ *
+ * Tasks are detached std::threads, vTaskDelete(NULL) unwinds the calling
+ * thread, critical sections are a recursive mutex and ticks are
+ * milliseconds. task.h, semphr.h, event_groups.h and queue.h include
+ * this file, so firmware headers build unchanged (native tests only).
+ */
+
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t EventBits_t;
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              pdTRUE
+#define pdFAIL              pdFALSE
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS  1
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+
+// ============================================================
+// Critical Sections
+// ============================================================
+struct portMUX_TYPE {
+  std::recursive_mutex m;
+};
+
+#define portMUX_INITIALIZER_UNLOCKED  {}
+#define portENTER_CRITICAL(mux)       ((mux)->m.lock())
+#define portEXIT_CRITICAL(mux)        ((mux)->m.unlock())
+
+// ============================================================
+// Tasks
+// ============================================================
+typedef void (*TaskFunction_t)(void*);
+struct NativeTask {};
+typedef NativeTask* TaskHandle_t;
+struct NativeTaskDeleted {};  // Thrown by vTaskDelete(NULL)
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack,
+                                          void* arg, UBaseType_t priority, TaskHandle_t* handle,
+                                          BaseType_t core) {
+  static NativeTask task;
+  std::thread([fn, arg] {
+    try {
+      fn(arg);
+    } catch (const NativeTaskDeleted&) {
+    }
+  }).detach();
+  if (handle) *handle = &task;
+  return pdPASS;
+}
+
+inline void vTaskDelete(TaskHandle_t task) {
+  if (task == NULL) throw NativeTaskDeleted();
+}
+
+inline void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+// ============================================================
+// Mutexes
+// ============================================================
+struct NativeSemaphore {
+  std::timed_mutex m;
+};
+typedef NativeSemaphore* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return new NativeSemaphore();
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+  if (ticks == portMAX_DELAY) {
+    sem->m.lock();
+    return pdTRUE;
+  }
+  return sem->m.try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  sem->m.unlock();
+  return pdTRUE;
+}
+
+// ============================================================
+// Event Groups
+// ============================================================
+struct NativeEventGroup {
+  std::mutex m;
+  std::condition_variable cv;
+  EventBits_t bits = 0;
+};
+typedef NativeEventGroup* EventGroupHandle_t;
+
+inline EventGroupHandle_t xEventGroupCreate() {
+  return new NativeEventGroup();
+}
+
+inline void vEventGroupDelete(EventGroupHandle_t group) {
+  delete group;
+}
+
+inline EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+  std::lock_guard<std::mutex> lock(group->m);
+  group->bits |= bits;
+  group->cv.notify_all();
+  return group->bits;
+}
+
+inline EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bitsToWait,
+                                       BaseType_t clearOnExit, BaseType_t waitForAll,
+                                       TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(group->m);
+  auto ready = [&] {
+    EventBits_t set = group->bits & bitsToWait;
+    return waitForAll ? set == bitsToWait : set != 0;
+  };
+  if (ticks == portMAX_DELAY) {
+    group->cv.wait(lock, ready);
+  } else {
+    group->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+  }
+  EventBits_t value = group->bits;
+  if (clearOnExit && ready()) group->bits &= ~bitsToWait;
+  return value;
+}
+
+// ============================================================
+// Queues
+// ============================================================
+struct NativeQueue {
+  std::mutex m;
+  std::condition_variable cv;
+  std::deque<std::vector<uint8_t>> items;
+  UBaseType_t length;
+  size_t itemSize;
+};
+typedef NativeQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, size_t itemSize) {
+  NativeQueue* q = new NativeQueue();
+  q->length = length;
+  q->itemSize = itemSize;
+  return q;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(q->m);
+  auto space = [&] { return q->items.size() < q->length; };
+  if (ticks == portMAX_DELAY) {
+    q->cv.wait(lock, space);
+  } else if (!q->cv.wait_for(lock, std::chrono::milliseconds(ticks), space)) {
+    return pdFALSE;
+  }
+  const uint8_t* p = (const uint8_t*)item;
+  q->items.emplace_back(p, p + q->itemSize);
+  q->cv.notify_all();
+  return pdTRUE;
+}
+
+inline BaseType_t xQueueOverwrite(QueueHandle_t q, const void* item) {
+  std::lock_guard<std::mutex> lock(q->m);
+  q->items.clear();
+  const uint8_t* p = (const uint8_t*)item;
+  q->items.emplace_back(p, p + q->itemSize);
+  q->cv.notify_all();
+  return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(q->m);
+  auto any = [&] { return !q->items.empty(); };
+  if (ticks == portMAX_DELAY) {
+    q->cv.wait(lock, any);
+  } else if (!q->cv.wait_for(lock, std::chrono::milliseconds(ticks), any)) {
+    return pdFALSE;
+  }
+  memcpy(item, q->items.front().data(), q->itemSize);
+  q->items.pop_front();
+  q->cv.notify_all();
+  return pdTRUE;
+}
+
+inline UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q) {
+  std::lock_guard<std::mutex> lock(q->m);
+  return q->length - q->items.size();
+}
+
+#endif // NATIVE_FREERTOS_H
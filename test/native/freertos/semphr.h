@@ -0,0 +1,2 @@
+// Native tests: everything lives in the FreeRTOS.h stand-in
+#include "FreeRTOS.h"
@@ -0,0 +1,126 @@
+/**
+ * @file test_main.cpp
+ * @brief Host test: feedingFanOut() finishes in max(latency), not the sum
+ *
+ * Fake backends sleep for a fixed time and return a fixed result. Run
+ * with: pio test -e native -f test_feeding_fanout
+ */
+
+#include <atomic>
+#include <unity.h>
+#include "feeding_fanout.h"
+
+#define WALL_TOLERANCE_MS  150   // Thread start + scheduling slack
+
+// ============================================================
+// Hooks normally provided by feeding_task.h
+// ============================================================
+static std::atomic<uint8_t> reported[FEED_BACKEND_COUNT];
+
+uint32_t feedingActiveJobId() {
+  return 1;
+}
+
+void feedingJobReportFor(uint32_t jobId, FeedingBackend backend, FeedingStepState state,
+                         unsigned long elapsedMs) {
+  reported[backend] = state;
+}
+
+// ============================================================
+// Fake Backends
+// ============================================================
+template <unsigned long LatencyMs, bool Success>
+static bool fakeBackend() {
+  delay(LatencyMs);
+  return Success;
+}
+
+static const unsigned long relaxedDeadlines[FEED_BACKEND_COUNT] = { 5000, 5000, 5000 };
+
+static unsigned long runFanOut(const FeedingBackendFn fns[FEED_BACKEND_COUNT],
+                               const unsigned long deadlines[FEED_BACKEND_COUNT],
+                               FeedingBackendResult results[FEED_BACKEND_COUNT]) {
+  unsigned long start = millis();
+  feedingFanOut(fns, deadlines, results);
+  return millis() - start;
+}
+
+// ============================================================
+// Tests
+// ============================================================
+void setUp() {
+  for (int i = 0; i < FEED_BACKEND_COUNT; i++) reported[i] = FEED_STEP_PENDING;
+}
+
+void tearDown() {}
+
+void test_wall_clock_is_max_not_sum() {
+  const FeedingBackendFn fns[FEED_BACKEND_COUNT] = {
+    fakeBackend<300, true>, fakeBackend<600, true>, fakeBackend<900, true>
+  };
+  FeedingBackendResult results[FEED_BACKEND_COUNT];
+  unsigned long wall = runFanOut(fns, relaxedDeadlines, results);
+
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(900, wall);
+  TEST_ASSERT_LESS_THAN_UINT32(900 + WALL_TOLERANCE_MS, wall);  // Sum would be 1800
+  for (int i = 0; i < FEED_BACKEND_COUNT; i++) {
+    TEST_ASSERT_EQUAL_INT(FEED_STEP_OK, results[i].state);
+    TEST_ASSERT_EQUAL_INT(FEED_STEP_OK, reported[i].load());
+  }
+  TEST_ASSERT_UINT32_WITHIN(WALL_TOLERANCE_MS, 300, results[FEED_BACKEND_REDSEA].elapsedMs);
+  TEST_ASSERT_UINT32_WITHIN(WALL_TOLERANCE_MS, 600, results[FEED_BACKEND_TUNZE].elapsedMs);
+  TEST_ASSERT_UINT32_WITHIN(WALL_TOLERANCE_MS, 900, results[FEED_BACKEND_TASMOTA].elapsedMs);
+}
+
+void test_disabled_backend_is_skipped() {
+  const FeedingBackendFn fns[FEED_BACKEND_COUNT] = {
+    NULL, fakeBackend<200, true>, fakeBackend<100, true>
+  };
+  FeedingBackendResult results[FEED_BACKEND_COUNT];
+  unsigned long wall = runFanOut(fns, relaxedDeadlines, results);
+
+  TEST_ASSERT_LESS_THAN_UINT32(200 + WALL_TOLERANCE_MS, wall);
+  TEST_ASSERT_EQUAL_INT(FEED_STEP_SKIPPED, results[FEED_BACKEND_REDSEA].state);
+  TEST_ASSERT_EQUAL_INT(FEED_STEP_OK, results[FEED_BACKEND_TUNZE].state);
+  TEST_ASSERT_EQUAL_INT(FEED_STEP_OK, results[FEED_BACKEND_TASMOTA].state);
+}
+
+void test_failed_backend_is_reported() {
+  const FeedingBackendFn fns[FEED_BACKEND_COUNT] = {
+    fakeBackend<100, false>, fakeBackend<400, true>, NULL
+  };
+  FeedingBackendResult results[FEED_BACKEND_COUNT];
+  unsigned long wall = runFanOut(fns, relaxedDeadlines, results);
+
+  TEST_ASSERT_LESS_THAN_UINT32(400 + WALL_TOLERANCE_MS, wall);
+  TEST_ASSERT_EQUAL_INT(FEED_STEP_FAILED, results[FEED_BACKEND_REDSEA].state);
+  TEST_ASSERT_EQUAL_INT(FEED_STEP_OK, results[FEED_BACKEND_TUNZE].state);
+}
+
+// A backend that hangs is given up on at its own deadline and its late
+// result does not overwrite the recorded timeout
+void test_deadline_caps_wall_clock() {
+  const FeedingBackendFn fns[FEED_BACKEND_COUNT] = {
+    fakeBackend<1500, true>, fakeBackend<200, true>, NULL
+  };
+  const unsigned long deadlines[FEED_BACKEND_COUNT] = { 500, 1000, 1000 };
+  FeedingBackendResult results[FEED_BACKEND_COUNT];
+  unsigned long wall = runFanOut(fns, deadlines, results);
+
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(500, wall);
+  TEST_ASSERT_LESS_THAN_UINT32(500 + WALL_TOLERANCE_MS, wall);
+  TEST_ASSERT_EQUAL_INT(FEED_STEP_TIMEOUT, results[FEED_BACKEND_REDSEA].state);
+  TEST_ASSERT_EQUAL_INT(FEED_STEP_OK, results[FEED_BACKEND_TUNZE].state);
+
+  delay(1500);  // Let the hung backend finish
+  TEST_ASSERT_EQUAL_INT(FEED_STEP_TIMEOUT, reported[FEED_BACKEND_REDSEA].load());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_wall_clock_is_max_not_sum);
+  RUN_TEST(test_disabled_backend_is_skipped);
+  RUN_TEST(test_failed_backend_is_reported);
+  RUN_TEST(test_deadline_caps_wall_clock);
+  return UNITY_END();
+}
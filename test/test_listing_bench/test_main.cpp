@@ -0,0 +1,310 @@
+/**
+ * @file test_main.cpp
+ * @brief Host benchmark: peak heap and parse time of the cloud listings
+ *
+ * Parses the /aquarium and getDevices responses in fixtures/ (real
+ * response layout, personal data replaced) and large generated payloads
+ * of the same shape, with the nested fields the UI never shows, two ways:
+ *
+ *   buffered  whole body in a string, then a full parse (the old code)
+ *   streamed  parse from a stream with the cloud_listing.h filter
+ *
+ * Heap is counted by an ArduinoJson allocator that tracks the peak; the
+ * buffered path also holds the body. Run from the project directory
+ * (fixture paths are relative to it):
+ *   pio test -e native -f test_listing_bench
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unity.h>
+#include "cloud_listing.h"
+
+#define LISTING_AQUARIUMS       40    // Aquariums in the generated listing
+#define LISTING_GATEWAYS        4     // Tunze gateways
+#define LISTING_ENDPOINTS       48    // Tunze endpoints
+#define LISTING_ROUNDS          20    // Parses per timing series
+#define LISTING_MIN_HEAP_GAIN   4     // Streamed peak must be this many times smaller
+#define LISTING_FIXTURES        "test/test_listing_bench/fixtures/"
+
+// ============================================================
+// Peak-tracking Allocator
+// ============================================================
+class PeakAllocator : public ArduinoJson::Allocator {
+ public:
+  void* allocate(size_t size) override {
+    char* p = (char*)malloc(size + HEADER);
+    if (!p) return nullptr;
+    *(size_t*)p = size;
+    track(size);
+    return p + HEADER;
+  }
+
+  void deallocate(void* ptr) override {
+    if (!ptr) return;
+    char* p = (char*)ptr - HEADER;
+    current_ -= *(size_t*)p;
+    free(p);
+  }
+
+  void* reallocate(void* ptr, size_t size) override {
+    if (!ptr) return allocate(size);
+    char* p = (char*)ptr - HEADER;
+    size_t old = *(size_t*)p;
+    char* q = (char*)realloc(p, size + HEADER);
+    if (!q) return nullptr;
+    *(size_t*)q = size;
+    current_ -= old;
+    track(size);
+    return q + HEADER;
+  }
+
+  size_t peak() const {
+    return peak_;
+  }
+
+ private:
+  static const size_t HEADER = alignof(max_align_t);
+
+  void track(size_t size) {
+    current_ += size;
+    if (current_ > peak_) peak_ = current_;
+  }
+
+  size_t current_ = 0;
+  size_t peak_ = 0;
+};
+
+// ============================================================
+// Payloads
+// ============================================================
+static std::string readFixture(const char* name) {
+  std::string path = std::string(LISTING_FIXTURES) + name;
+  std::ifstream file(path);
+  if (!file) TEST_FAIL_MESSAGE(("missing fixture " + path).c_str());
+  std::stringstream body;
+  body << file.rdbuf();
+  return body.str();
+}
+
+static void appendf(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+static void appendf(std::string& out, const char* format, ...) {
+  char buf[1024];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  out += buf;
+}
+
+static std::string aquariumListing() {
+  std::string json = "[";
+  for (int i = 0; i < LISTING_AQUARIUMS; i++) {
+    if (i > 0) json += ",";
+    appendf(json, "{\"id\":%d,\"uid\":\"%08x-4c1e-4b7a-9d2f-%012d\",\"name\":\"Reef %d\","
+            "\"description\":\"Mixed reef with SPS and LPS corals, refugium and ATS in the sump\","
+            "\"measuring_unit\":\"metric\",\"water_volume\":%d,\"net_water_volume\":%d,"
+            "\"online\":%s,\"timezone_offset\":3600,\"system_series\":\"REEFER G2+\","
+            "\"serial_number\":\"RS%010d\",\"system_model\":\"REEFER-S 850\",\"system_type\":\"reefer\",",
+            10000 + i, 0x1a2b0000 + i, i, i, 500 + i, 420 + i, i % 3 ? "true" : "false", 70000 + i);
+    appendf(json, "\"created_at\":\"2023-0%d-1%dT08:15:30.000Z\",\"updated_at\":\"2024-11-2%dT19:42:11.000Z\","
+            "\"image_url\":\"https://cdn.redsea.example/aquarium/%d/cover-1024x768.jpg\","
+            "\"location\":{\"lat\":52.52%d,\"lng\":13.40%d,\"city\":\"Berlin\",\"country\":\"DE\"},",
+            1 + i % 9, i % 10, i % 10, i, i, i);
+    json += "\"settings\":{";
+    for (int k = 0; k < 16; k++) {
+      appendf(json, "%s\"setting_%d\":{\"value\":%d,\"unit\":\"ppm\",\"min\":0,\"max\":1000}",
+              k ? "," : "", k, k * 37 + i);
+    }
+    json += "},\"devices\":[";
+    for (int d = 0; d < 8; d++) {
+      appendf(json, "%s{\"hwid\":\"%02x%02x%02xA1B2C3\",\"type\":\"reef-dose%d\",\"name\":\"Device %d\","
+              "\"firmware\":\"3.%d.%d\",\"last_seen\":\"2024-11-2%dT19:4%d:00.000Z\","
+              "\"status\":{\"connected\":true,\"rssi\":-%d,\"uptime\":%d}}",
+              d ? "," : "", i, d, d * 3, d % 4, d, d, i % 10, i % 10, d, 40 + d, 86400 * d + i);
+    }
+    json += "]}";
+  }
+  json += "]";
+  return json;
+}
+
+static std::string tunzeListing() {
+  std::string json = "{\"gateways\":[";
+  for (int g = 0; g < LISTING_GATEWAYS; g++) {
+    appendf(json, "%s{\"imei\":\"35%013d\",\"name\":\"Hub %d\",\"type\":\"7090\",\"sn\":\"TZ%08d\","
+            "\"firmware\":{\"version\":\"1.%d.0\",\"build\":\"2024-06-%02d\",\"channel\":\"stable\"},"
+            "\"network\":{\"ip\":\"192.168.1.%d\",\"mac\":\"24:0A:C4:00:00:%02X\",\"rssi\":-%d},"
+            "\"owner\":{\"id\":%d,\"email\":\"reefer%d@example.com\",\"locale\":\"de_DE\"}}",
+            g ? "," : "", g, g, g, g + 1, 10 + g, 10 + g, g, 50 + g, 9000 + g, g);
+  }
+  json += "],\"endpoints\":[";
+  for (int e = 0; e < LISTING_ENDPOINTS; e++) {
+    appendf(json, "%s{\"imei\":\"35%013d\",\"name\":\"%s\",\"type\":\"6095\",\"slot\":%d,",
+            e ? "," : "", e % LISTING_GATEWAYS, e % 5 ? "Turbelle" : "", e);
+    json += "\"state\":{";
+    for (int k = 0; k < 12; k++) {
+      appendf(json, "%s\"ch%d\":{\"speed\":%d,\"mode\":\"pulse\",\"interval\":%d}",
+              k ? "," : "", k, 30 + k + e, 500 + k * 10);
+    }
+    appendf(json, "},\"schedule\":[{\"from\":\"08:00\",\"to\":\"20:00\",\"speed\":%d},"
+            "{\"from\":\"20:00\",\"to\":\"08:00\",\"speed\":%d}]}", 60 + e % 40, 30 + e % 20);
+  }
+  json += "]}";
+  return json;
+}
+
+// ============================================================
+// Parse Paths
+// ============================================================
+struct ParseStats {
+  size_t peakHeap;      // Bytes, body buffer included for the buffered path
+  double avgUs;         // Per parse
+};
+
+// Old code: http.getString() then deserializeJson() on the whole document
+static ParseStats parseBuffered(const std::string& payload) {
+  PeakAllocator alloc;
+  ParseStats stats = {};
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < LISTING_ROUNDS; i++) {
+    std::string body(payload);
+    JsonDocument doc(&alloc);
+    DeserializationError error = deserializeJson(doc, body);
+    TEST_ASSERT_FALSE(error);
+    size_t peak = body.capacity() + alloc.peak();
+    if (peak > stats.peakHeap) stats.peakHeap = peak;
+  }
+  stats.avgUs = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - start).count() / LISTING_ROUNDS;
+  return stats;
+}
+
+// Firmware: deserializeJson() from the stream with the listing filter
+static ParseStats parseStreamed(const std::string& payload, void (*buildFilter)(JsonDocument&),
+                                JsonDocument& last) {
+  PeakAllocator alloc;
+  ParseStats stats = {};
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < LISTING_ROUNDS; i++) {
+    std::istringstream stream(payload);  // Stands in for the TLS socket
+    JsonDocument filter(&alloc);
+    buildFilter(filter);
+    JsonDocument doc(&alloc);
+    DeserializationError error = deserializeJson(doc, stream, DeserializationOption::Filter(filter));
+    TEST_ASSERT_FALSE(error);
+    if (alloc.peak() > stats.peakHeap) stats.peakHeap = alloc.peak();
+    if (i == LISTING_ROUNDS - 1) last.set(doc);
+  }
+  stats.avgUs = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - start).count() / LISTING_ROUNDS;
+  return stats;
+}
+
+static void report(const char* name, size_t bytes, const ParseStats& buffered, const ParseStats& streamed) {
+  printf("\n%s: %zu byte payload, %d rounds\n", name, bytes, LISTING_ROUNDS);
+  printf("  %-9s %10s %10s\n", "path", "peak B", "avg us");
+  printf("  %-9s %10zu %10.0f\n", "buffered", buffered.peakHeap, buffered.avgUs);
+  printf("  %-9s %10zu %10.0f\n", "streamed", streamed.peakHeap, streamed.avgUs);
+  printf("  heap %.1fx smaller, parse %.2fx faster\n",
+         (double)buffered.peakHeap / streamed.peakHeap, buffered.avgUs / streamed.avgUs);
+}
+
+// ============================================================
+// Tests
+// ============================================================
+void setUp() {}
+
+void tearDown() {}
+
+void test_aquarium_fixture() {
+  std::string payload = readFixture("redsea_aquarium.json");
+  JsonDocument kept;
+  ParseStats buffered = parseBuffered(payload);
+  ParseStats streamed = parseStreamed(payload, redseaAquariumFilter, kept);
+  report("aquarium fixture", payload.size(), buffered, streamed);
+
+  TEST_ASSERT_EQUAL_INT(3, kept.as<JsonArray>().size());
+  TEST_ASSERT_EQUAL_STRING("5f0c2a9e-6b1d-4e83-a4c7-0d9e1b2f3a41", kept[0]["uid"].as<const char*>());
+  TEST_ASSERT_EQUAL_INT(420, kept[0]["net_water_volume"].as<int>());
+  TEST_ASSERT_EQUAL_STRING("RS0000000001", kept[0]["serial_number"].as<const char*>());
+  TEST_ASSERT_EQUAL_STRING("", kept[1]["name"].as<const char*>());  // UI falls back to "Aquarium <id>"
+  TEST_ASSERT_EQUAL_INT(20981, kept[1]["id"].as<int>());
+  TEST_ASSERT_FALSE(kept[1]["online"].as<bool>());
+  TEST_ASSERT_TRUE(kept[1]["system_series"].isNull());
+  TEST_ASSERT_EQUAL_INT(-18000, kept[2]["timezone_offset"].as<int>());
+  TEST_ASSERT_TRUE(kept[0]["owner"].isNull());
+  TEST_ASSERT_TRUE(kept[0]["devices"].isNull());
+  TEST_ASSERT_TRUE(kept[2]["properties"].isNull());
+  TEST_ASSERT_LESS_THAN_UINT32(buffered.peakHeap, streamed.peakHeap);
+}
+
+void test_tunze_fixture() {
+  std::string payload = readFixture("tunze_get_devices.json");
+  JsonDocument kept;
+  ParseStats buffered = parseBuffered(payload);
+  ParseStats streamed = parseStreamed(payload, tunzeDeviceFilter, kept);
+  report("tunze fixture", payload.size(), buffered, streamed);
+
+  TEST_ASSERT_EQUAL_INT(1, kept["gateways"].size());
+  TEST_ASSERT_EQUAL_INT(4, kept["endpoints"].size());
+  TEST_ASSERT_EQUAL_STRING("350000000000001", kept["gateways"][0]["imei"].as<const char*>());
+  TEST_ASSERT_EQUAL_STRING("1.4.0", kept["gateways"][0]["firmware"]["version"].as<const char*>());
+  TEST_ASSERT_TRUE(kept["gateways"][0]["owner"].isNull());
+  TEST_ASSERT_EQUAL_STRING("3152", kept["endpoints"][3]["type"].as<const char*>());
+  TEST_ASSERT_EQUAL_INT(3, kept["endpoints"][3]["slot"].as<int>());
+  TEST_ASSERT_TRUE(kept["endpoints"][0]["schedule"].isNull());
+  TEST_ASSERT_TRUE(kept["success"].isNull());
+  TEST_ASSERT_LESS_THAN_UINT32(buffered.peakHeap, streamed.peakHeap);
+}
+
+void test_aquarium_listing() {
+  std::string payload = aquariumListing();
+  JsonDocument kept;
+  ParseStats buffered = parseBuffered(payload);
+  ParseStats streamed = parseStreamed(payload, redseaAquariumFilter, kept);
+  report("aquariums", payload.size(), buffered, streamed);
+
+  TEST_ASSERT_EQUAL_INT(LISTING_AQUARIUMS, kept.as<JsonArray>().size());
+  TEST_ASSERT_EQUAL_STRING("1a2b0007-4c1e-4b7a-9d2f-000000000007", kept[7]["uid"].as<const char*>());
+  TEST_ASSERT_EQUAL_STRING("Reef 7", kept[7]["name"].as<const char*>());
+  TEST_ASSERT_EQUAL_INT(507, kept[7]["water_volume"].as<int>());
+  TEST_ASSERT_EQUAL_STRING("REEFER-S 850", kept[7]["system_model"].as<const char*>());
+  TEST_ASSERT_TRUE(kept[7]["devices"].isNull());
+  TEST_ASSERT_TRUE(kept[7]["settings"].isNull());
+  TEST_ASSERT_LESS_THAN_UINT32(buffered.peakHeap / LISTING_MIN_HEAP_GAIN, streamed.peakHeap);
+}
+
+void test_tunze_listing() {
+  std::string payload = tunzeListing();
+  JsonDocument kept;
+  ParseStats buffered = parseBuffered(payload);
+  ParseStats streamed = parseStreamed(payload, tunzeDeviceFilter, kept);
+  report("tunze", payload.size(), buffered, streamed);
+
+  TEST_ASSERT_EQUAL_INT(LISTING_GATEWAYS, kept["gateways"].size());
+  TEST_ASSERT_EQUAL_INT(LISTING_ENDPOINTS, kept["endpoints"].size());
+  TEST_ASSERT_EQUAL_STRING("1.3.0", kept["gateways"][2]["firmware"]["version"].as<const char*>());
+  TEST_ASSERT_TRUE(kept["gateways"][2]["firmware"]["build"].isNull());
+  TEST_ASSERT_TRUE(kept["gateways"][2]["network"].isNull());
+  TEST_ASSERT_EQUAL_INT(9, kept["endpoints"][9]["slot"].as<int>());
+  TEST_ASSERT_EQUAL_STRING("", kept["endpoints"][10]["name"].as<const char*>());
+  TEST_ASSERT_TRUE(kept["endpoints"][9]["state"].isNull());
+  TEST_ASSERT_LESS_THAN_UINT32(buffered.peakHeap / LISTING_MIN_HEAP_GAIN, streamed.peakHeap);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_aquarium_fixture);
+  RUN_TEST(test_tunze_fixture);
+  RUN_TEST(test_aquarium_listing);
+  RUN_TEST(test_tunze_listing);
+  return UNITY_END();
+}
@@ -0,0 +1,278 @@
+/**
+ * @file test_main.cpp
+ * @brief Host test: circuit breaker against a fake fleet with black holes
+ *
+ * A fleet of fake plugs on a virtual clock, driven through the same
+ * tasmotaBreakerCommand() loop that tasmotaSendCommand() uses. Black-
+ * holed plugs never answer: each attempt costs the connect and read
+ * timeout. Feeding commands use tasmotaFeedingSendMode() like the
+ * dispatch. Run with: pio test -e native -f test_tasmota_breaker
+ */
+
+#include <unity.h>
+#include "tasmota_breaker.h"
+
+#define FLEET_SIZE        8
+#define BLACK_HOLE_MS     1300    // Default connect + read timeout in tasmota_api.h
+#define ANSWER_MS         40      // Healthy plug round trip
+#define BACKOFF_MS        100     // Between retries (jitter left out)
+#define POLL_INTERVAL_MS  5000
+#define COMMAND_RETRIES   3       // tasmotaSendCommand() default
+
+// ============================================================
+// Fake Fleet
+// ============================================================
+struct FakePlug {
+  bool blackHole;
+  TasmotaBreaker breaker;
+  uint32_t requests;        // Attempts that reached the network
+  uint32_t probes;
+};
+
+static FakePlug fleet[FLEET_SIZE];
+static uint32_t now;
+static int lockDepth;
+
+static bool isBlackHole(int i) { return i == 2 || i == 5; }
+
+static TasmotaBreaker* plugLock(void* ctx) {
+  lockDepth++;
+  return &((FakePlug*)ctx)->breaker;
+}
+
+static void plugUnlock(void* ctx) {
+  lockDepth--;
+}
+
+static uint32_t plugNow() {
+  return now;
+}
+
+static bool plugSend(void* ctx, int attempt) {
+  FakePlug* plug = (FakePlug*)ctx;
+  TEST_ASSERT_EQUAL_INT(0, lockDepth);  // No network I/O under the breaker lock
+  plug->requests++;
+  now += plug->blackHole ? BLACK_HOLE_MS : ANSWER_MS;
+  return !plug->blackHole;
+}
+
+static void plugWait(void* ctx, int attempt) {
+  now += BACKOFF_MS;
+}
+
+static TasmotaCommandOutcome plugCommand(FakePlug& plug, TasmotaSendMode mode) {
+  TasmotaCommandIo io = { &plug, plugLock, plugUnlock, plugNow, plugSend, plugWait };
+  if (mode == TASMOTA_SEND_PROBE) plug.probes++;
+  TasmotaCommandOutcome out = tasmotaBreakerCommand(io, mode, COMMAND_RETRIES);
+  if (mode == TASMOTA_SEND_PROBE && !out.sent) plug.probes--;
+  return out;
+}
+
+// Feeding start or stop for every plug - time spent per plug
+static void fleetFeeding(bool starting, uint32_t spentMs[FLEET_SIZE], bool ok[FLEET_SIZE]) {
+  for (int i = 0; i < FLEET_SIZE; i++) {
+    uint32_t start = now;
+    ok[i] = plugCommand(fleet[i], tasmotaFeedingSendMode(starting)).ok;
+    spentMs[i] = now - start;
+  }
+}
+
+// One poller round: open circuits are only probed when due
+static void fleetPoll() {
+  for (int i = 0; i < FLEET_SIZE; i++) {
+    FakePlug& plug = fleet[i];
+    if (plug.breaker.state == TASMOTA_BREAKER_CLOSED) {
+      plugCommand(plug, TASMOTA_SEND_NORMAL);
+    } else if (tasmotaBreakerDue(plug.breaker, now)) {
+      plugCommand(plug, TASMOTA_SEND_PROBE);
+    }
+  }
+}
+
+static void runPollerFor(uint32_t durationMs) {
+  uint32_t end = now + durationMs;
+  while (now < end) {
+    fleetPoll();
+    now += POLL_INTERVAL_MS;
+  }
+}
+
+// Black-holed plugs fail feeding starts until their circuits open
+static void openBlackHoles() {
+  uint32_t spent[FLEET_SIZE];
+  bool ok[FLEET_SIZE];
+  for (int n = 0; n < TASMOTA_BREAKER_THRESHOLD; n++) fleetFeeding(true, spent, ok);
+}
+
+// ============================================================
+// Tests
+// ============================================================
+void setUp() {
+  now = 1000;
+  lockDepth = 0;
+  for (int i = 0; i < FLEET_SIZE; i++) {
+    fleet[i] = FakePlug();
+    fleet[i].blackHole = isBlackHole(i);
+  }
+}
+
+void tearDown() {}
+
+void test_feeding_modes() {
+  TEST_ASSERT_EQUAL_INT(TASMOTA_SEND_NORMAL, tasmotaFeedingSendMode(true));
+  TEST_ASSERT_EQUAL_INT(TASMOTA_SEND_ALWAYS, tasmotaFeedingSendMode(false));
+}
+
+void test_one_failed_command_is_one_failure() {
+  FakePlug& plug = fleet[0];
+  plug.blackHole = true;  // Short WiFi glitch during the start
+  TasmotaCommandOutcome out = plugCommand(plug, tasmotaFeedingSendMode(true));
+
+  TEST_ASSERT_FALSE(out.ok);
+  TEST_ASSERT_EQUAL_INT(COMMAND_RETRIES, out.attempts);
+  TEST_ASSERT_EQUAL_UINT8(1, plug.breaker.consecutiveFailures);
+  TEST_ASSERT_EQUAL_INT(TASMOTA_BREAKER_CLOSED, plug.breaker.state);
+
+  plug.blackHole = false;
+  out = plugCommand(plug, tasmotaFeedingSendMode(false));
+  TEST_ASSERT_TRUE(out.ok);
+  TEST_ASSERT_EQUAL_UINT8(0, plug.breaker.consecutiveFailures);
+}
+
+void test_black_holes_open_after_threshold_commands_then_fail_fast() {
+  uint32_t spent[FLEET_SIZE];
+  bool ok[FLEET_SIZE];
+
+  for (int n = 0; n < TASMOTA_BREAKER_THRESHOLD; n++) {
+    fleetFeeding(true, spent, ok);
+    for (int i = 0; i < FLEET_SIZE; i++) {
+      TEST_ASSERT_EQUAL(!isBlackHole(i), ok[i]);
+      if (isBlackHole(i)) {
+        TEST_ASSERT_EQUAL_UINT32(COMMAND_RETRIES * BLACK_HOLE_MS + (COMMAND_RETRIES - 1) * BACKOFF_MS,
+                                 spent[i]);
+      }
+    }
+  }
+  for (int i = 0; i < FLEET_SIZE; i++) {
+    if (isBlackHole(i)) {
+      TEST_ASSERT_EQUAL_INT(TASMOTA_BREAKER_OPEN, fleet[i].breaker.state);
+      TEST_ASSERT_EQUAL_UINT32(TASMOTA_BREAKER_THRESHOLD * COMMAND_RETRIES, fleet[i].requests);
+    } else {
+      TEST_ASSERT_EQUAL_INT(TASMOTA_BREAKER_CLOSED, fleet[i].breaker.state);
+    }
+  }
+
+  // Open circuits cost a feeding start nothing: no request, no time
+  fleetFeeding(true, spent, ok);
+  for (int i = 0; i < FLEET_SIZE; i++) {
+    if (isBlackHole(i)) {
+      TEST_ASSERT_FALSE(ok[i]);
+      TEST_ASSERT_EQUAL_UINT32(0, spent[i]);
+      TEST_ASSERT_EQUAL_UINT32(TASMOTA_BREAKER_THRESHOLD * COMMAND_RETRIES, fleet[i].requests);
+    } else {
+      TEST_ASSERT_TRUE(ok[i]);
+      TEST_ASSERT_EQUAL_UINT32(ANSWER_MS, spent[i]);
+    }
+  }
+}
+
+void test_stop_is_sent_with_the_circuit_open() {
+  uint32_t spent[FLEET_SIZE];
+  bool ok[FLEET_SIZE];
+  openBlackHoles();
+
+  fleet[2].blackHole = false;  // Back online, plug 5 stays dead
+  uint32_t requestsBefore = fleet[5].requests;
+  fleetFeeding(false, spent, ok);
+
+  TEST_ASSERT_TRUE(ok[2]);
+  TEST_ASSERT_EQUAL_INT(TASMOTA_BREAKER_CLOSED, fleet[2].breaker.state);
+
+  // The dead plug was still tried with all retries, then opened again
+  TEST_ASSERT_FALSE(ok[5]);
+  TEST_ASSERT_EQUAL_UINT32(requestsBefore + COMMAND_RETRIES, fleet[5].requests);
+  TEST_ASSERT_EQUAL_INT(TASMOTA_BREAKER_OPEN, fleet[5].breaker.state);
+  TEST_ASSERT_EQUAL_UINT32(TASMOTA_BREAKER_COOLDOWN * 2, fleet[5].breaker.cooldownMs);
+}
+
+void test_probes_back_off_to_the_maximum_cooldown() {
+  openBlackHoles();
+
+  runPollerFor(3600000UL);  // One hour
+
+  // 30 + 60 + 120 + 240 s, then every 300 s: about 14 probes an hour
+  for (int i = 0; i < FLEET_SIZE; i++) {
+    if (isBlackHole(i)) {
+      TEST_ASSERT_UINT32_WITHIN(2, 14, fleet[i].probes);
+      TEST_ASSERT_EQUAL_UINT32(TASMOTA_BREAKER_THRESHOLD * COMMAND_RETRIES + fleet[i].probes,
+                               fleet[i].requests);
+      TEST_ASSERT_EQUAL_UINT32(TASMOTA_BREAKER_MAX_COOLDOWN, fleet[i].breaker.cooldownMs);
+      TEST_ASSERT_NOT_EQUAL(TASMOTA_BREAKER_CLOSED, fleet[i].breaker.state);
+    } else {
+      TEST_ASSERT_EQUAL_UINT32(0, fleet[i].probes);
+      TEST_ASSERT_EQUAL_INT(TASMOTA_BREAKER_CLOSED, fleet[i].breaker.state);
+    }
+  }
+}
+
+void test_recovered_plug_closes_on_the_next_probe() {
+  uint32_t spent[FLEET_SIZE];
+  bool ok[FLEET_SIZE];
+  openBlackHoles();
+
+  fleet[2].blackHole = false;
+  runPollerFor(TASMOTA_BREAKER_COOLDOWN + POLL_INTERVAL_MS);
+
+  TEST_ASSERT_EQUAL_UINT32(1, fleet[2].probes);
+  TEST_ASSERT_EQUAL_INT(TASMOTA_BREAKER_CLOSED, fleet[2].breaker.state);
+  TEST_ASSERT_EQUAL_INT(TASMOTA_BREAKER_OPEN, fleet[5].breaker.state);
+
+  fleetFeeding(true, spent, ok);
+  TEST_ASSERT_TRUE(ok[2]);
+  TEST_ASSERT_FALSE(ok[5]);
+  TEST_ASSERT_EQUAL_UINT32(0, spent[5]);
+}
+
+void test_half_open_lets_one_probe_through() {
+  FakePlug& plug = fleet[2];
+  openBlackHoles();
+
+  TEST_ASSERT_FALSE(tasmotaBreakerTryPass(plug.breaker, true, now));  // Cooldown running
+  now += TASMOTA_BREAKER_COOLDOWN;
+  TEST_ASSERT_TRUE(tasmotaBreakerTryPass(plug.breaker, true, now));
+  TEST_ASSERT_EQUAL_INT(TASMOTA_BREAKER_HALF_OPEN, plug.breaker.state);
+
+  // Probe in flight: commands and a second probe are refused
+  TEST_ASSERT_FALSE(plugCommand(plug, TASMOTA_SEND_NORMAL).sent);
+  TEST_ASSERT_FALSE(tasmotaBreakerTryPass(plug.breaker, true, now + 1000));
+  TEST_ASSERT_FALSE(tasmotaBreakerDue(plug.breaker, now + 1000));
+
+  // The probe never reported back - another one after the cooldown
+  now += TASMOTA_BREAKER_COOLDOWN;
+  TEST_ASSERT_TRUE(tasmotaBreakerDue(plug.breaker, now));
+  TEST_ASSERT_TRUE(tasmotaBreakerTryPass(plug.breaker, true, now));
+}
+
+void test_intermittent_failures_keep_the_circuit_closed() {
+  FakePlug& plug = fleet[0];
+  for (int round = 0; round < 20; round++) {
+    plug.blackHole = true;
+    for (int i = 0; i < TASMOTA_BREAKER_THRESHOLD - 1; i++) plugCommand(plug, TASMOTA_SEND_NORMAL);
+    plug.blackHole = false;
+    TEST_ASSERT_TRUE(plugCommand(plug, TASMOTA_SEND_NORMAL).ok);
+    TEST_ASSERT_EQUAL_INT(TASMOTA_BREAKER_CLOSED, plug.breaker.state);
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_feeding_modes);
+  RUN_TEST(test_one_failed_command_is_one_failure);
+  RUN_TEST(test_black_holes_open_after_threshold_commands_then_fail_fast);
+  RUN_TEST(test_stop_is_sent_with_the_circuit_open);
+  RUN_TEST(test_probes_back_off_to_the_maximum_cooldown);
+  RUN_TEST(test_recovered_plug_closes_on_the_next_probe);
+  RUN_TEST(test_half_open_lets_one_probe_through);
+  RUN_TEST(test_intermittent_failures_keep_the_circuit_closed);
+  return UNITY_END();
+}
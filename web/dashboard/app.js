@@ -0,0 +1,527 @@
+let isUpdating=false;
+let aquariums=[];
+function toggleMenu(){
+  document.getElementById('sidebar').classList.toggle('active');
+  document.getElementById('overlay').classList.toggle('active');
+}
+function showSection(sectionId){
+  document.querySelectorAll('.section').forEach(s=>s.classList.remove('active'));
+  document.querySelectorAll('.sidebar-item').forEach(i=>i.classList.remove('active'));
+  document.getElementById(sectionId).classList.add('active');
+  event.target.classList.add('active');
+  toggleMenu();
+  if(sectionId==='section-control')updateStatus();
+  if(sectionId==='section-device'){loadScreensaverSettings();loadTimeSettings();}
+}
+var tasmotaStatusTimer=null;
+function updateStatus(){
+  const controller=new AbortController();
+  const timeoutId=setTimeout(()=>controller.abort(),5000);
+  fetch('/api/status',{signal:controller.signal}).then(r=>r.json()).then(data=>{
+    clearTimeout(timeoutId);
+    const card=document.getElementById('statusCard');
+    const icon=document.getElementById('statusIcon');
+    const text=document.getElementById('statusText');
+    const detail=document.getElementById('statusDetail');
+    const startBtn=document.getElementById('startBtn');
+    const stopBtn=document.getElementById('stopBtn');
+    if(data.feeding_active){
+      card.className='status-card status-active';
+      icon.textContent='🟢';
+      text.textContent='Fütterungsmodus AKTIV';
+      detail.textContent='Pumpen sind pausiert';
+      startBtn.style.display='none';
+      stopBtn.style.display='block';
+      startTasmotaStatusPolling();
+    }else{
+      card.className='status-card inactive';
+      icon.textContent='🔴';
+      text.textContent='Fütterungsmodus INAKTIV';
+      detail.textContent='Normaler Betrieb';
+      startBtn.style.display='block';
+      stopBtn.style.display='none';
+      stopTasmotaStatusPolling();
+      hideTasmotaStatus();
+    }
+    if(document.getElementById('deviceIPCtrl'))document.getElementById('deviceIPCtrl').textContent=data.ip;
+    if(document.getElementById('wifiSignalCtrl'))document.getElementById('wifiSignalCtrl').textContent=data.wifi_rssi+' dBm';
+    if(document.getElementById('deviceIP'))document.getElementById('deviceIP').textContent=data.ip;
+    if(document.getElementById('wifiSignal'))document.getElementById('wifiSignal').textContent=data.wifi_rssi+' dBm';
+  }).catch(e=>{
+    clearTimeout(timeoutId);
+    if(e.name!=='AbortError')console.error('Status update failed:',e);
+  });
+}
+function startTasmotaStatusPolling(){
+  if(tasmotaStatusTimer)return;
+  updateTasmotaStatus();
+  tasmotaStatusTimer=setInterval(updateTasmotaStatus,8000);
+}
+function stopTasmotaStatusPolling(){
+  if(tasmotaStatusTimer){clearInterval(tasmotaStatusTimer);tasmotaStatusTimer=null;}
+}
+function hideTasmotaStatus(){
+  var el=document.getElementById('tasmotaStatusBox');
+  if(el)el.style.display='none';
+}
+function updateTasmotaStatus(){
+  fetch('/api/tasmota-status').then(r=>r.json()).then(data=>{
+    var el=document.getElementById('tasmotaStatusBox');
+    if(!el)return;
+    if(!data.enabled||data.devices.length===0){el.style.display='none';return;}
+    el.style.display='block';
+    var h='<div style="font-weight:bold;margin-bottom:10px;color:#fff">🔌 Tasmota Geräte ('+data.completedDevices+'/'+data.totalDevices+' fertig)</div>';
+    data.devices.forEach(function(d){
+      var stateIcon=d.powerState?'🟢':'🔴';
+      var stateText=d.powerState?'AN':'AUS';
+      var statusCol=d.completed?'#4CAF50':'#ff9800';
+      var statusText=d.completed?'✓ Fertig':'⏳ Warte...';
+      h+='<div style="display:flex;justify-content:space-between;align-items:center;padding:8px;background:#1a1a1a;border-radius:4px;margin:4px 0">';
+      h+='<span style="color:#fff">'+d.name+'</span>';
+      h+='<span style="display:flex;gap:10px;align-items:center">';
+      h+='<span style="color:'+(d.powerState?'#4CAF50':'#f44336')+'">'+stateIcon+' '+stateText+'</span>';
+      h+='<span style="color:'+statusCol+';font-size:12px">'+statusText+'</span>';
+      h+='</span></div>';
+    });
+    if(data.allComplete){
+      h+='<div style="margin-top:10px;padding:10px;background:#1b5e20;border-radius:4px;text-align:center;color:#fff">✓ Alle Geräte zurückgesetzt!</div>';
+      setTimeout(function(){updateStatus();stopTasmotaStatusPolling();hideTasmotaStatus();},1500);
+    }
+    el.innerHTML=h;
+  }).catch(function(e){console.error(e);});
+}
+function toggleFeeding(action){
+  if(isUpdating)return;
+  isUpdating=true;
+  const statusCard=document.getElementById('statusCard');
+  statusCard.style.opacity='0.6';
+  fetch('/api/feeding/'+action,{method:'POST'})
+  .then(r=>r.json())
+  .then(data=>{
+    if(data.success&&data.job){
+      pollFeedingJob(data.job);
+    }else{
+      alert('Fehler: '+data.message);
+      statusCard.style.opacity='1';
+      isUpdating=false;
+    }
+  }).catch(e=>{
+    alert('Netzwerkfehler: '+e);
+    statusCard.style.opacity='1';
+    isUpdating=false;
+  });
+}
+function pollFeedingJob(id){
+  fetch('/api/feeding/job/'+id).then(r=>r.json()).then(job=>{
+    if(job.success&&job.state!=='done'){
+      setTimeout(function(){pollFeedingJob(id);},500);
+      return;
+    }
+    document.getElementById('statusCard').style.opacity='1';
+    isUpdating=false;
+    updateStatus();
+  }).catch(e=>{
+    document.getElementById('statusCard').style.opacity='1';
+    isUpdating=false;
+  });
+}
+function loadSettings(){
+  fetch('/api/settings').then(r=>r.json()).then(data=>{
+    document.getElementById('redseaUser').value=data.redsea_username;
+    document.getElementById('redseaPass').value=data.redsea_password;
+    document.getElementById('redseaAquaId').value=data.redsea_aquarium_id;
+    if(data.redsea_aquarium_id&&data.redsea_aquarium_name){
+      document.getElementById('redseaAquaName').textContent=data.redsea_aquarium_name;
+    }else{
+      document.getElementById('redseaAquaName').textContent=data.redsea_aquarium_id?'Gespeichert':'Nicht gesetzt';
+    }
+    document.getElementById('enableredsea').checked=data.enable_redsea;
+    document.getElementById('tunzeUser').value=data.tunze_username;
+    document.getElementById('tunzePass').value=data.tunze_password;
+    document.getElementById('tunzeDevId').value=data.tunze_device_id;
+    const tunzeNameField=document.getElementById('tunzeDeviceName');
+    if(data.tunze_device_id&&data.tunze_device_name){
+      tunzeNameField.textContent=data.tunze_device_name;
+      tunzeNameField.setAttribute('data-device-name',data.tunze_device_name);
+    }else{
+      tunzeNameField.textContent=data.tunze_device_id?'Gespeichert':'Nicht gesetzt';
+      tunzeNameField.removeAttribute('data-device-name');
+    }
+    document.getElementById('enableTunze').checked=data.enable_tunze;
+  }).catch(e=>console.error('Error:',e));
+}
+function loadAquariums(event){
+  const btn=event.target;
+  const select=document.getElementById('redseaAquaSelect');
+  const user=document.getElementById('redseaUser').value;
+  const pass=document.getElementById('redseaPass').value;
+  if(!user||!pass){alert('Bitte zuerst Benutzername und Passwort eingeben und speichern!');return;}
+  btn.disabled=true;
+  btn.textContent='⏳ Laden...';
+  const tempData={redsea_username:user,redsea_password:pass,redsea_aquarium_id:document.getElementById('redseaAquaId').value,tunze_username:document.getElementById('tunzeUser').value,tunze_password:document.getElementById('tunzePass').value,tunze_device_id:document.getElementById('tunzeDevId').value,enable_redsea:document.getElementById('enableredsea').checked,enable_tunze:document.getElementById('enableTunze').checked};
+  fetch('/api/settings',{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify(tempData)}).then(()=>{
+    fetch('/api/aquariums').then(r=>r.json()).then(data=>{
+      if(data.success&&data.aquariums){
+        aquariums=data.aquariums;
+        select.innerHTML='<option value="">-- Aquarium auswählen --</option>';
+        aquariums.forEach(a=>{
+          const opt=document.createElement('option');
+          opt.value=a.id;
+          opt.textContent=a.name;
+          select.appendChild(opt);
+        });
+        const currentId=document.getElementById('redseaAquaId').value;
+        if(currentId)select.value=currentId;
+        populateDeviceInfo(data.aquariums);
+        btn.textContent='✓ Geladen ('+aquariums.length+')';
+        setTimeout(()=>{btn.textContent='🔄 Laden';btn.disabled=false;},2000);
+      }else{
+        alert('Fehler: '+(data.message||'Keine Aquarien gefunden'));
+        btn.textContent='✗ Fehler';
+        setTimeout(()=>{btn.textContent='🔄 Laden';btn.disabled=false;},2000);
+      }
+    }).catch(e=>{
+      alert('Netzwerkfehler: '+e);
+      btn.textContent='✗ Fehler';
+      setTimeout(()=>{btn.textContent='🔄 Laden';btn.disabled=false;},2000);
+    });
+  }).catch(e=>{alert('Fehler beim Speichern: '+e);btn.textContent='🔄 Laden';btn.disabled=false;});
+}
+function selectAquarium(){
+  const select=document.getElementById('redseaAquaSelect');
+  const idField=document.getElementById('redseaAquaId');
+  const nameField=document.getElementById('redseaAquaName');
+  if(select.value){
+    idField.value=select.value;
+    nameField.textContent=select.options[select.selectedIndex].text;
+  }else{
+    idField.value='';
+    nameField.textContent='Nicht gesetzt';
+  }
+}
+function loadTunzeDevices(event){
+  const btn=event.target;
+  const select=document.getElementById('tunzeDeviceSelect');
+  const user=document.getElementById('tunzeUser').value;
+  const pass=document.getElementById('tunzePass').value;
+  if(!user||!pass){alert('Bitte zuerst Benutzername und Passwort eingeben und speichern!');return;}
+  btn.disabled=true;
+  btn.textContent='⏳ Laden...';
+  const tempData={redsea_username:document.getElementById('redseaUser').value,redsea_password:document.getElementById('redseaPass').value,redsea_aquarium_id:document.getElementById('redseaAquaId').value,tunze_username:user,tunze_password:pass,tunze_device_id:document.getElementById('tunzeDevId').value,enable_redsea:document.getElementById('enableredsea').checked,enable_tunze:document.getElementById('enableTunze').checked};
+  fetch('/api/settings',{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify(tempData)}).then(()=>{
+    fetch('/api/tunze-devices').then(r=>r.json()).then(data=>{
+      if(data.success&&data.devices){
+        const devices=data.devices;
+        select.innerHTML='<option value="">-- Device auswählen --</option>';
+        devices.forEach(d=>{
+          const opt=document.createElement('option');
+          opt.value=d.imei;
+          opt.textContent=d.name+' ('+d.model+')';
+          select.appendChild(opt);
+        });
+        const currentId=document.getElementById('tunzeDevId').value;
+        if(currentId)select.value=currentId;
+        populateTunzeDeviceInfo(devices);
+        btn.textContent='✓ Geladen ('+devices.length+')';
+        setTimeout(()=>{btn.textContent='🔄 Laden';btn.disabled=false;},2000);
+      }else{
+        alert('Fehler: '+(data.message||'Keine Devices gefunden'));
+        btn.textContent='✗ Fehler';
+        setTimeout(()=>{btn.textContent='🔄 Laden';btn.disabled=false;},2000);
+      }
+    }).catch(e=>{
+      alert('Netzwerkfehler: '+e);
+      btn.textContent='✗ Fehler';
+      setTimeout(()=>{btn.textContent='🔄 Laden';btn.disabled=false;},2000);
+    });
+  }).catch(e=>{alert('Fehler beim Speichern: '+e);btn.textContent='🔄 Laden';btn.disabled=false;});
+}
+function selectTunzeDevice(){
+  const select=document.getElementById('tunzeDeviceSelect');
+  const idField=document.getElementById('tunzeDevId');
+  const nameField=document.getElementById('tunzeDeviceName');
+  if(select.value){
+    idField.value=select.value;
+    const selectedText=select.options[select.selectedIndex].text;
+    nameField.textContent=selectedText;
+    nameField.setAttribute('data-device-name',selectedText);
+  }else{
+    idField.value='';
+    nameField.textContent='Nicht gesetzt';
+    nameField.removeAttribute('data-device-name');
+  }
+}
+function populateTunzeDeviceInfo(devices){
+  const container=document.getElementById('tunzeDeviceInfo');
+  if(!devices||devices.length===0){container.innerHTML='<p style="color:#999;text-align:center">Keine Geräte gefunden</p>';return;}
+  let content='';
+  devices.forEach((d,idx)=>{
+    content+='<div class="device-card">';
+    content+='<div class="device-header" onclick="toggleDeviceDetails(\'tunze-'+idx+'\')">';
+    content+='<span class="device-name">'+d.name+'</span>';
+    content+='<span class="device-toggle" id="toggle-tunze-'+idx+'">▼</span>';
+    content+='</div>';
+    content+='<div class="device-details" id="details-tunze-'+idx+'" style="display:none">';
+    content+='<div class="device-info-row"><span class="device-info-label">IMEI:</span><span class="device-info-value">'+d.imei+'</span></div>';
+    content+='<div class="device-info-row"><span class="device-info-label">Typ:</span><span class="device-info-value">'+d.type+'</span></div>';
+    content+='<div class="device-info-row"><span class="device-info-label">Modell:</span><span class="device-info-value">'+d.model+'</span></div>';
+    if(d.serial)content+='<div class="device-info-row"><span class="device-info-label">Seriennr.:</span><span class="device-info-value">'+d.serial+'</span></div>';
+    if(d.firmware)content+='<div class="device-info-row"><span class="device-info-label">Firmware:</span><span class="device-info-value">'+d.firmware+'</span></div>';
+    if(d.slot)content+='<div class="device-info-row"><span class="device-info-label">Slot:</span><span class="device-info-value">'+d.slot+'</span></div>';
+    content+='</div>';
+    content+='</div>';
+  });
+  container.innerHTML=content;
+}
+function populateDeviceInfo(aquariums){
+  const container=document.getElementById('redseaDeviceInfo');
+  if(!aquariums||aquariums.length===0){container.innerHTML='<p style="color:#999;text-align:center">Keine Geräte gefunden</p>';return;}
+  let content='';
+  aquariums.forEach((a,idx)=>{
+    content+='<div class="device-card">';
+    content+='<div class="device-header" onclick="toggleDeviceDetails('+idx+')">';
+    content+='<span class="device-name">'+a.name+'</span>';
+    content+='<span class="device-toggle" id="toggle-'+idx+'">▼</span>';
+    content+='</div>';
+    content+='<div class="device-details" id="details-'+idx+'" style="display:none">';
+    content+='<div class="device-info-row"><span class="device-info-label">Aquarium ID:</span><span class="device-info-value">'+a.id+'</span></div>';
+    if(a.measuring_unit)content+='<div class="device-info-row"><span class="device-info-label">Volumen-Einheit:</span><span class="device-info-value">'+a.measuring_unit+'</span></div>';
+    if(a.water_volume)content+='<div class="device-info-row"><span class="device-info-label">Brutto-Volumen:</span><span class="device-info-value">'+a.water_volume+' '+(a.measuring_unit||'')+'</span></div>';
+    if(a.net_water_volume)content+='<div class="device-info-row"><span class="device-info-label">Netto-Volumen:</span><span class="device-info-value">'+a.net_water_volume+' '+(a.measuring_unit||'')+'</span></div>';
+    if(a.online!==undefined)content+='<div class="device-info-row"><span class="device-info-label">Online:</span><span class="device-info-value">'+(a.online?'✓ Ja':'✗ Nein')+'</span></div>';
+    if(a.timezone_offset!==undefined)content+='<div class="device-info-row"><span class="device-info-label">Zeitzone:</span><span class="device-info-value">UTC'+(a.timezone_offset>=0?'+':'')+Math.round(a.timezone_offset/60)+'h</span></div>';
+    if(a.owner){
+      content+='<div class="device-owner">👤 Besitzer</div>';
+      if(a.owner.name)content+='<div class="device-info-row"><span class="device-info-label">Name:</span><span class="device-info-value">'+a.owner.name+'</span></div>';
+      if(a.owner.email)content+='<div class="device-info-row"><span class="device-info-label">E-Mail:</span><span class="device-info-value">'+a.owner.email+'</span></div>';
+      if(a.owner.country)content+='<div class="device-info-row"><span class="device-info-label">Land:</span><span class="device-info-value">'+a.owner.country+'</span></div>';
+    }
+    if(a.devices&&a.devices.length>0){
+      content+='<div class="device-owner" style="margin-top:10px">🔧 Geräte</div>';
+      a.devices.forEach(d=>{
+        content+='<div style="padding:8px;border-left:3px solid #3498db;margin:5px 0;background:#1e1e1e">';
+        if(d.name)content+='<div class="device-info-row"><span class="device-info-label">Name:</span><span class="device-info-value">'+d.name+'</span></div>';
+        if(d.type)content+='<div class="device-info-row"><span class="device-info-label">Typ:</span><span class="device-info-value">'+d.type+'</span></div>';
+        if(d.serial)content+='<div class="device-info-row"><span class="device-info-label">Seriennr.:</span><span class="device-info-value">'+d.serial+'</span></div>';
+        if(d.firmware)content+='<div class="device-info-row"><span class="device-info-label">Firmware:</span><span class="device-info-value">'+d.firmware+'</span></div>';
+        content+='</div>';
+      });
+    }
+    content+='</div>';
+    content+='</div>';
+  });
+  container.innerHTML=content;
+}
+function toggleDeviceDetails(idx){
+  const details=document.getElementById('details-'+idx);
+  const toggle=document.getElementById('toggle-'+idx);
+  if(details.style.display==='none'){
+    details.style.display='block';
+    toggle.textContent='▲';
+  }else{
+    details.style.display='none';
+    toggle.textContent='▼';
+  }
+}
+function saveSettings(){
+  const data={
+    redsea_username:document.getElementById('redseaUser').value,
+    redsea_password:document.getElementById('redseaPass').value,
+    redsea_aquarium_id:document.getElementById('redseaAquaId').value,
+    redsea_aquarium_name:document.getElementById('redseaAquaName').textContent==='Nicht gesetzt'?'':document.getElementById('redseaAquaName').textContent,
+    enable_redsea:document.getElementById('enableredsea').checked,
+    tunze_username:document.getElementById('tunzeUser').value,
+    tunze_password:document.getElementById('tunzePass').value,
+    tunze_device_id:document.getElementById('tunzeDevId').value,
+    tunze_device_name:(document.getElementById('tunzeDeviceName').getAttribute('data-device-name')||''),
+    enable_tunze:document.getElementById('enableTunze').checked
+  };
+  const saveBtn=event.target;
+  const originalText=saveBtn.textContent;
+  saveBtn.disabled=true;
+  saveBtn.textContent='💾 Speichere...';
+  fetch('/api/settings',{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify(data)})
+  .then(r=>r.json()).then(result=>{
+    if(result.success){
+      alert('✓ Einstellungen erfolgreich gespeichert!');
+      saveBtn.textContent='✓ Gespeichert';
+      setTimeout(()=>{saveBtn.textContent=originalText;saveBtn.disabled=false;},2000);
+    }else{
+      alert('✗ Fehler beim Speichern');
+      saveBtn.textContent=originalText;
+      saveBtn.disabled=false;
+    }
+  }).catch(e=>{
+    alert('✗ Netzwerkfehler: '+e);
+    saveBtn.textContent=originalText;
+    saveBtn.disabled=false;
+  });
+}
+function togglePassword(id){
+  const input=document.getElementById(id);
+  input.type=input.type==='password'?'text':'password';
+}
+function confirmFactoryReset(){
+  if(!confirm('⚠️ WARNUNG: Alle Einstellungen und WiFi-Daten werden gelöscht!\n\nMöchten Sie wirklich fortfahren?'))return;
+  if(!confirm('🚨 LETZTE WARNUNG!\n\nDas Gerät wird auf Werkseinstellungen zurückgesetzt und neu gestartet.\n\nWirklich fortfahren?'))return;
+  const resetBtn=document.getElementById('resetBtn');
+  resetBtn.disabled=true;
+  resetBtn.textContent='🔄 Wird zurückgesetzt...';
+  fetch('/api/factory-reset',{method:'POST'})
+  .then(r=>r.json()).then(result=>{
+    if(result.success){
+      alert('✓ Werksreset erfolgreich! Das Gerät startet neu.');
+    }else{
+      alert('✗ Fehler beim Werksreset');
+      resetBtn.disabled=false;
+      resetBtn.textContent='⚠️ Werksreset';
+    }
+  }).catch(e=>{
+    alert('✗ Fehler: '+e);
+    resetBtn.disabled=false;
+    resetBtn.textContent='⚠️ Werksreset';
+  });
+}
+function loadScreensaverSettings(){
+  fetch('/api/screensaver-settings').then(r=>r.json()).then(data=>{
+    document.getElementById('screensaverTimeout').value=data.timeout;
+  }).catch(e=>console.error('Error loading screensaver settings:',e));
+}
+function saveScreensaverSettings(){
+  const timeout=parseInt(document.getElementById('screensaverTimeout').value)||0;
+  const msg=document.getElementById('screensaverMessage');
+  fetch('/api/screensaver-settings',{
+    method:'POST',
+    headers:{'Content-Type':'application/json'},
+    body:JSON.stringify({timeout:timeout})
+  }).then(r=>r.json()).then(result=>{
+    msg.className='message success';
+    msg.textContent='✓ Screensaver-Einstellungen gespeichert!';
+    msg.style.display='block';
+    setTimeout(()=>msg.style.display='none',3000);
+  }).catch(e=>{
+    msg.className='message error';
+    msg.textContent='✗ Fehler beim Speichern';
+    msg.style.display='block';
+  });
+}
+// Time settings JavaScript functions
+function loadTimeSettings(){
+  fetch('/api/time-settings').then(r=>r.json()).then(data=>{
+    document.getElementById('timezoneSelect').value=data.timezone_index;
+    document.getElementById('currentTime').textContent=data.time_synced?data.current_time:'Wird synchronisiert...';
+  }).catch(e=>console.error('Time settings load error:',e));
+}
+function saveTimeSettings(){
+  const tzIndex=parseInt(document.getElementById('timezoneSelect').value);
+  const msg=document.getElementById('timeMessage');
+  fetch('/api/time-settings',{
+    method:'POST',
+    headers:{'Content-Type':'application/json'},
+    body:JSON.stringify({timezone_index:tzIndex})
+  }).then(r=>r.json()).then(result=>{
+    msg.className='message success';
+    msg.textContent='✓ Zeiteinstellungen gespeichert! Zeit wird synchronisiert...';
+    msg.style.display='block';
+    setTimeout(()=>{msg.style.display='none';loadTimeSettings();},3000);
+  }).catch(e=>{
+    msg.className='message error';
+    msg.textContent='✗ Fehler beim Speichern';
+    msg.style.display='block';
+  });
+}
+// Tasmota JavaScript functions
+var tasmotaDevices=[];
+function loadTasmotaSettings(){
+  fetch('/api/tasmota-settings').then(function(r){return r.json();}).then(function(data){
+    document.getElementById('enableTasmota').checked=data.enabled;
+    document.getElementById('tasmotaPulseTime').value=Math.round(data.pulseTime/60);
+    document.getElementById('tasmotaMqttHost').value=data.mqttHost||'';
+    document.getElementById('tasmotaMqttPort').value=data.mqttPort||1883;
+    document.getElementById('tasmotaMqttUser').value=data.mqttUser||'';
+    document.getElementById('tasmotaMqttPass').value=data.mqttPass||'';
+    document.getElementById('tasmotaMqttState').textContent=data.mqttHost?(data.mqttConnected?'✓ Verbunden':'✗ Nicht verbunden'):'';
+    document.getElementById('tasmotaGroupName').value=data.groupName||'';
+    document.getElementById('tasmotaHedging').checked=!!data.hedging;
+    document.getElementById('tasmotaScanWindow').value=data.scanWindow||10;
+    document.getElementById('tasmotaScanConnectMs').value=data.scanConnectMs||400;
+    document.getElementById('tasmotaGroupState').textContent=data.groupName?data.groupMembers+' Mitglieder':'';
+    tasmotaDevices=data.devices||[];
+    renderTasmotaDevices();
+  }).catch(function(e){console.error('Tasmota load error:',e);});
+}
+function renderTasmotaDevices(){
+  var c=document.getElementById('tasmotaDeviceList');
+  if(!tasmotaDevices||tasmotaDevices.length===0){
+    c.innerHTML='<p style="color:#999;text-align:center;padding:20px">Keine Geraete. Klicke Scannen.</p>';
+    return;}
+  var h='';
+  for(var i=0;i<tasmotaDevices.length;i++){
+    var d=tasmotaDevices[i];
+    var col=d.reachable?(d.powerState?'#4CAF50':'#f44336'):'#999';
+    var st=d.reachable?(d.powerState?'AN':'AUS'):'Offline';
+    var actionText=d.turnOn?'Einschalten':'Ausschalten';
+    var actionCol=d.turnOn?'#4CAF50':'#f44336';
+    h+='<div style="padding:12px;border-bottom:1px solid #333;background:#1a1a1a;margin:2px 0;border-radius:4px">';
+    h+='<div style="display:flex;justify-content:space-between;align-items:center">';
+    h+='<label style="display:flex;align-items:center;gap:8px"><input type="checkbox" data-idx="'+i+'" '+(d.enabled?'checked':'')+' onchange="tasmotaDeviceToggle(this)"> <b style="color:#fff">'+d.name+'</b></label>';
+    h+='<span style="color:'+col+';font-size:12px">'+st+'</span></div>';
+    h+='<div style="font-size:11px;color:#888;margin:4px 0 8px 26px">'+d.ip+'</div>';
+    h+='<div style="margin-left:26px;display:flex;align-items:center;gap:8px">';
+    h+='<span style="color:#aaa;font-size:12px">Bei Futtermodus:</span>';
+    h+='<select data-idx="'+i+'" onchange="tasmotaActionChange(this)" style="padding:4px 8px;border-radius:4px;border:1px solid #444;background:#2a2a2a;color:#fff;font-size:12px">';
+    h+='<option value="off" '+(d.turnOn?'':'selected')+'>🔴 Ausschalten</option>';
+    h+='<option value="on" '+(d.turnOn?'selected':'')+'>🟢 Einschalten</option>';
+    h+='</select></div></div>';}
+  c.innerHTML=h;}
+function tasmotaActionChange(el){var i=parseInt(el.dataset.idx);if(tasmotaDevices[i])tasmotaDevices[i].turnOn=(el.value==='on');}
+var scanPollTimer=null;
+function scanTasmota(){
+  var btn=document.getElementById('scanTasmotaBtn');
+  var status=document.getElementById('scanStatus');
+  btn.disabled=true;btn.textContent='Starte...';
+  status.style.display='block';status.innerHTML='Starte Netzwerkscan...';
+  fetch('/api/tasmota-scan').then(function(r){return r.json();}).then(function(data){
+    if(data.success){pollScanResults();}
+    else{btn.textContent='Fehler';status.style.display='none';setTimeout(function(){btn.textContent='Netzwerk scannen';btn.disabled=false;},2000);}
+  }).catch(function(e){btn.textContent='Fehler';status.style.display='none';setTimeout(function(){btn.textContent='Netzwerk scannen';btn.disabled=false;},2000);});
+}
+function pollScanResults(){
+  fetch('/api/tasmota-scan-results').then(function(r){return r.json();}).then(function(data){
+    var btn=document.getElementById('scanTasmotaBtn');
+    var status=document.getElementById('scanStatus');
+    if(data.scanning){
+      var pct=Math.round((data.progress/254)*100);
+      btn.textContent='Scanne '+pct+'%';
+      status.innerHTML='<div style="margin-bottom:8px;color:#fff">Scanne IP '+data.progress+'/254</div><div style="background:#333;border-radius:4px;height:8px;overflow:hidden"><div style="background:#4CAF50;height:100%;width:'+pct+'%"></div></div><div style="margin-top:5px;color:#4CAF50">Gefunden: '+data.found+' Geraete</div>';
+      setTimeout(pollScanResults,800);}
+    else{status.style.display='none';
+      if(data.devices&&data.devices.length>0){tasmotaDevices=data.devices;renderTasmotaDevices();btn.textContent='Gefunden: '+data.count;}
+      else{btn.textContent='Nichts gefunden';}
+      setTimeout(function(){btn.textContent='Netzwerk scannen';btn.disabled=false;},2500);}
+  }).catch(function(e){console.error(e);setTimeout(pollScanResults,2000);});
+}
+function tasmotaDeviceToggle(el){var i=parseInt(el.dataset.idx);if(tasmotaDevices[i])tasmotaDevices[i].enabled=el.checked;}
+function tasmotaToggleChanged(){}
+function testTasmota(ip){alert('Test: '+ip);}
+function saveTasmotaSettings(){
+  var d={enabled:document.getElementById('enableTasmota').checked,
+    pulseTime:parseInt(document.getElementById('tasmotaPulseTime').value||'15')*60,
+    mqttHost:document.getElementById('tasmotaMqttHost').value.trim(),
+    mqttPort:parseInt(document.getElementById('tasmotaMqttPort').value||'1883'),
+    mqttUser:document.getElementById('tasmotaMqttUser').value,
+    mqttPass:document.getElementById('tasmotaMqttPass').value,
+    groupName:document.getElementById('tasmotaGroupName').value.trim(),
+    hedging:document.getElementById('tasmotaHedging').checked,
+    scanWindow:parseInt(document.getElementById('tasmotaScanWindow').value||'10'),
+    scanConnectMs:parseInt(document.getElementById('tasmotaScanConnectMs').value||'400'),
+    devices:tasmotaDevices};
+  fetch('/api/tasmota-settings',{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify(d)})
+  .then(function(r){return r.json();}).then(function(res){
+    if(res.success){alert('Gespeichert!');}else{alert('Fehler');}
+  }).catch(function(e){alert('Fehler: '+e);});
+}
+updateStatus();
+loadSettings();
+loadTasmotaSettings();
+setInterval(updateStatus,5000);
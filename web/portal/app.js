@@ -0,0 +1,24 @@
+function scanNetworks(){
+  document.getElementById('loading').style.display='block';
+  document.getElementById('networks').style.display='none';
+  pollScan();
+}
+function pollScan(){
+  fetch('/scan').then(r=>r.json()).then(data=>{
+    if(data.status=='started'||data.status=='scanning'){
+      setTimeout(pollScan,2000);
+    }else if(data.networks){
+      document.getElementById('loading').style.display='none';
+      let html='';
+      data.networks.forEach(n=>{
+        html+='<div class="network" onclick="selectNetwork(\''+n.ssid+'\')">';
+        html+='📶 '+n.ssid+' ('+n.rssi+' dBm)'+(n.secure?' 🔒':'');
+        html+='</div>';
+      });
+      document.getElementById('networks').innerHTML=html;
+      document.getElementById('networks').style.display='block';
+    }
+  }).catch(e=>{document.getElementById('loading').innerHTML='Error: '+e;});
+}
+function selectNetwork(ssid){document.getElementById('ssid').value=ssid;}
+function rememberSsid(){try{sessionStorage.setItem('ssid',document.getElementById('ssid').value);}catch(e){}}
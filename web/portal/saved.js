@@ -0,0 +1,17 @@
+// The page is static - the SSID comes from the form (app.js rememberSsid)
+try{document.getElementById('ssid').textContent=sessionStorage.getItem('ssid')||'';}catch(e){}
+let attempts=0;
+function checkConnection(){
+  attempts++;
+  fetch('/api/status').then(r=>r.json()).then(data=>{
+    if(data.connected && data.ip){
+      document.getElementById('status').innerHTML='✓ Verbunden!<br>Weiterleitung zu '+data.ip+'...';
+      setTimeout(function(){window.location.href='http://'+data.ip+'/';},2000);
+    }else if(attempts<20){
+      setTimeout(checkConnection,1000);
+    }else{
+      document.getElementById('status').innerHTML='⚠ Verbindung fehlgeschlagen<br>Bitte manuell zu 192.168.x.x verbinden';
+    }
+  }).catch(e=>{if(attempts<20)setTimeout(checkConnection,1000);});
+}
+setTimeout(checkConnection,5000);
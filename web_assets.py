@@ -0,0 +1,117 @@
+"""
+Build script for PlatformIO to embed the web UI as precompressed assets
+Each page in web/<dir>/ (an HTML file with its local stylesheets and
+scripts, e.g. index.html + style.css + app.js) is inlined, minified,
+gzipped and written to src/web_assets.h as PROGMEM byte arrays.
+
+Minification is a conservative line join: every line is stripped, blank
+lines and full-line comments are dropped, and the rest is concatenated
+without separators. Sources must therefore end JS statements with ';'
+and never split a string or tag attribute across lines.
+"""
+import gzip
+import os
+import re
+
+try:
+    Import("env")
+    project_dir = env.subst("$PROJECT_DIR")
+except NameError:
+    # Standalone: python web_assets.py
+    project_dir = os.path.dirname(os.path.abspath(__file__))
+
+WEB_DIR = os.path.join(project_dir, "web")
+OUTPUT = os.path.join(project_dir, "src", "web_assets.h")
+# (directory, HTML file, array name)
+PAGES = [
+    ("dashboard", "index.html", "WEB_DASHBOARD_HTML_GZ"),
+    ("portal", "index.html", "WEB_PORTAL_HTML_GZ"),
+    ("portal", "saved.html", "WEB_PORTAL_SAVED_HTML_GZ"),
+]
+
+COMMENT_LINE = re.compile(r"^(//.*|/\*.*\*/|<!--.*-->)$")
+LINK_CSS = re.compile(r'^<link rel="stylesheet" href="([^"]+)">$')
+SCRIPT_SRC = re.compile(r'^<script src="([^"]+)"></script>$')
+
+def read_file(path):
+    """Read a UTF-8 source file"""
+    with open(path, "r", encoding="utf-8") as f:
+        return f.read()
+
+def minify(text):
+    """Strip lines, drop blanks and full-line comments, join"""
+    lines = []
+    for line in text.splitlines():
+        line = line.strip()
+        if not line or COMMENT_LINE.match(line):
+            continue
+        lines.append(line)
+    return "".join(lines)
+
+def build_page(page, html_file):
+    """Inline local stylesheets and scripts into the HTML file and minify"""
+    page_dir = os.path.join(WEB_DIR, page)
+    parts = []
+    for line in read_file(os.path.join(page_dir, html_file)).splitlines():
+        stripped = line.strip()
+        css = LINK_CSS.match(stripped)
+        js = SCRIPT_SRC.match(stripped)
+        if css:
+            parts.append("<style>" + minify(read_file(os.path.join(page_dir, css.group(1)))) + "</style>")
+        elif js:
+            parts.append("<script>" + minify(read_file(os.path.join(page_dir, js.group(1)))) + "</script>")
+        else:
+            parts.append(line)
+    return minify("\n".join(parts)).encode("utf-8")
+
+def to_c_array(name, data):
+    """Format bytes as a PROGMEM array plus length define"""
+    lines = [f"const uint8_t {name}[] PROGMEM = {{"]
+    for i in range(0, len(data), 16):
+        chunk = ", ".join(f"0x{b:02x}" for b in data[i:i + 16])
+        lines.append(f"  {chunk},")
+    lines.append("};")
+    lines.append(f"#define {name}_LEN {len(data)}")
+    return "\n".join(lines)
+
+def generate():
+    """Build all pages and write the header if it changed"""
+    out = [
+        "/**",
+        " * @file web_assets.h",
+        " * @brief Gzipped web UI pages - GENERATED by web_assets.py, do not edit",
+        " *",
+        " * Sources live in web/<dir>/. Serve with Content-Encoding: gzip.",
+        " */",
+        "",
+        "#ifndef WEB_ASSETS_H",
+        "#define WEB_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+    ]
+
+    print(f"")
+    print(f"=== Web Assets ===")
+    for page, html_file, name in PAGES:
+        html = build_page(page, html_file)
+        # mtime=0 keeps the output stable so unchanged sources do not rebuild
+        gz = gzip.compress(html, compresslevel=9, mtime=0)
+        source = page if html_file == "index.html" else f"{page}/{html_file}"
+        print(f"{source:17s} {len(html):6d} -> {len(gz):5d} bytes")
+        out.append(f"// web/{source}: {len(html)} bytes minified, {len(gz)} bytes gzipped")
+        out.append(to_c_array(name, gz))
+        out.append("")
+    print(f"==================")
+    print(f"")
+
+    out.append("#endif // WEB_ASSETS_H")
+    out.append("")
+    content = "\n".join(out)
+
+    if os.path.exists(OUTPUT) and read_file(OUTPUT) == content:
+        return
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write(content)
+
+generate()